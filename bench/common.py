@@ -0,0 +1,75 @@
+"""Helpers shared by the benchmark scripts.
+
+The scripts need the wallLoad extension on the python path, e.g. after python setup.py build_ext --inplace.
+Meshes and equilibria are synthetic and written to temporary files, so no input data is needed.
+"""
+import math
+import os
+import tempfile
+import time
+
+
+def write_torus(filename, Np, Nt, R0=1.5, a=1.2):
+    """Write a torus of 2*Np*Nt triangles with major radius R0 and minor radius a as gmsh 2.2 ASCII file."""
+    with open(filename, 'w') as output:
+        output.write('$MeshFormat\n2.2 0 8\n$EndMeshFormat\n')
+        output.write('$Nodes\n%d\n' % (Np*Nt))
+        for i in range(Np):
+            phi = 2.0*math.pi*i/Np
+            for j in range(Nt):
+                theta = 2.0*math.pi*j/Nt
+                R = R0 + a*math.cos(theta)
+                output.write('%d %.17g %.17g %.17g\n' % (i*Nt + j + 1, R*math.cos(phi), R*math.sin(phi), a*math.sin(theta)))
+        output.write('$EndNodes\n$Elements\n%d\n' % (2*Np*Nt))
+        node = lambda i, j: (i % Np)*Nt + (j % Nt) + 1
+        for i in range(Np):
+            for j in range(Nt):
+                k = 2*(i*Nt + j) + 1
+                output.write('%d 2 2 0 1 %d %d %d\n' % (k, node(i, j), node(i + 1, j), node(i + 1, j + 1)))
+                output.write('%d 2 2 0 1 %d %d %d\n' % (k + 1, node(i, j), node(i + 1, j + 1), node(i, j + 1)))
+        output.write('$EndElements\n')
+
+
+def write_eqdsk(filename, NR, Nz, psi, Rmin=1.0, Rmax=2.0, zmin=-1.0, zmax=1.0):
+    """Write an eqdsk file whose poloidal flux matrix samples psi(R, z) on NR x Nz points.
+
+    The equilibrium class flips the sign of the flux in the file, so the file holds -psi and get_psi() returns psi.
+    """
+    def block(values):
+        lines = []
+        for i in range(0, len(values), 5):
+            lines.append(''.join('%16.9E' % v for v in values[i:i + 5]))
+        return '\n'.join(lines) + '\n'
+    R0 = 0.5*(Rmin + Rmax)
+    z0 = 0.5*(zmin + zmax)
+    header = [Rmax - Rmin, zmax - zmin, R0, Rmin, z0, R0, z0, 0.0, 1.0, 1.0,
+              1e6, 0.0, 0.0, R0, 0.0, z0, 0.0, 1.0, 0.0, 0.0]
+    text = '%-48s%4d%4d%4d\n' % ('  synthetic benchmark equilibrium', 3, NR, Nz)
+    text += block(header)
+    for k in range(4):
+        text += block([0.0]*NR)
+    values = []
+    for j in range(Nz):
+        z = zmin + (zmax - zmin)*j/(Nz - 1)
+        for i in range(NR):
+            values.append(-psi(Rmin + (Rmax - Rmin)*i/(NR - 1), z))
+    text += block(values) + block([1.0]*NR)
+    with open(filename, 'w') as output:
+        output.write(text)
+
+
+def temporary(suffix):
+    """Get the name of a new temporary file, which the caller removes."""
+    handle, filename = tempfile.mkstemp(suffix=suffix)
+    os.close(handle)
+    return filename
+
+
+def best_time(function, repeat=3):
+    """Get the shortest of repeat wall clock times of function() in seconds."""
+    best = float('inf')
+    for k in range(repeat):
+        start = time.perf_counter()
+        function()
+        best = min(best, time.perf_counter() - start)
+    return best
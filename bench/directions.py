@@ -0,0 +1,56 @@
+"""Isotropy test and throughput of the batched direction generator.
+
+Usage: python bench/directions.py [N]
+
+N directions (default 10^6) of directionGenerator.generateArray are checked for isotropy:
+the moments <x>, <y>, <z> and <z^2> against 0 and 1/3 within five standard errors,
+and a chi^2 test of the counts in 20 x 20 equal area bins of cos(theta) and phi.
+Every direction has to be a unit vector and a batch starting at another sample index has to reproduce the same directions.
+The script exits with status 1 if a check fails, and prints the throughput of the instruction set in use.
+"""
+import sys
+import math
+import numpy
+import wallLoad
+from common import best_time
+
+N = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+generator = wallLoad.core.directionGenerator()
+generator.seed = 42
+directions = generator.generateArray(0, N)
+checks = []
+
+norm = numpy.abs(numpy.linalg.norm(directions, axis=1) - 1.0).max()
+checks.append(('unit length', norm < 1e-12, 'max |n - 1| = %.1e' % norm))
+
+offset = generator.generateArray(3, 1000)
+checks.append(('batch offset', numpy.array_equal(offset, directions[3:1003]), 'directions 3 to 1002 regenerated'))
+
+# The variance of a component is 1/3, the one of z^2 is 1/5 - 1/9 = 4/45.
+for k, name in enumerate('xyz'):
+    mean = directions[:, k].mean()
+    limit = 5.0*math.sqrt(1.0/3.0/N)
+    checks.append(('<%s>' % name, abs(mean) < limit, '%.5f, limit %.5f' % (mean, limit)))
+second = (directions[:, 2]**2).mean()
+limit = 5.0*math.sqrt(4.0/45.0/N)
+checks.append(('<z^2>', abs(second - 1.0/3.0) < limit, '%.5f, limit 1/3 +- %.5f' % (second, limit)))
+
+bins = 20
+counts, _, _ = numpy.histogram2d(directions[:, 2], numpy.arctan2(directions[:, 1], directions[:, 0]),
+    bins=[bins, bins], range=[[-1.0, 1.0], [-math.pi, math.pi]])
+expected = N/float(bins*bins)
+chi2 = ((counts - expected)**2/expected).sum()
+dof = bins*bins - 1
+# chi^2 is about normal with mean dof and variance 2 dof, five standard deviations are far beyond chance.
+limit = dof + 5.0*math.sqrt(2.0*dof)
+checks.append(('chi^2 of %dx%d bins' % (bins, bins), chi2 < limit, 'chi^2/dof = %.3f, limit %.3f' % (chi2/dof, limit/dof)))
+
+passed = True
+for name, ok, detail in checks:
+    print('%-22s %-6s %s' % (name, 'ok' if ok else 'FAILED', detail))
+    passed = passed and ok
+
+M = 10000000
+rate = M/best_time(lambda: generator.generateArray(0, M))
+print('throughput %.3g directions/s with %s' % (rate, generator.instructionSet))
+sys.exit(0 if passed else 1)
@@ -0,0 +1,66 @@
+"""Accuracy and throughput of the tabulated emission sampler against rejection sampling.
+
+Usage: python bench/emission.py [N]
+
+An edge peaked profile, which radiates between rho = 0.9 and 1.05 only, is sampled inside of a circular contour
+with N toroidal points (default 10^6) of radiationDistribution.randomToroidalArray, once by rejection sampling
+and once from the grid of setGrid. The counts in 20 bins of R and of z are compared with a two sample chi^2 test.
+The bins cover the bounds of the distribution and hold 8 x 8 cells each, the grid takes the emission as constant
+in z within a cell, so bins which split cells would see that approximation for large N.
+The script exits with status 1 if a chi^2/dof exceeds its limit, and prints the throughput of both samplers.
+"""
+import os
+import sys
+import math
+import numpy
+import wallLoad
+from common import write_eqdsk, temporary, best_time
+
+N = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+# Circular flux surfaces about (1.5, 0), the flux is 0 on the axis and 1 at the minor radius 0.4.
+filename = temporary('.eqdsk')
+try:
+    write_eqdsk(filename, 129, 129, lambda R, z: ((R - 1.5)**2 + z**2)/0.16)
+    eq = wallLoad.core.equilibrium(filename)
+finally:
+    os.remove(filename)
+profile = wallLoad.core.radiationProfile([0.0, 0.9, 1.0, 1.05], [0.0, 0.0, 5.0, 0.0])
+theta = numpy.linspace(0.0, 2.0*math.pi, 181)[:-1]
+contour = wallLoad.core.polygon(1.5 + 0.41*numpy.cos(theta), 0.41*numpy.sin(theta))
+distribution = wallLoad.core.radiationDistribution(eq, profile, contour)
+distribution.Rmin = 1.08
+distribution.Rmax = 1.92
+distribution.zmin = -0.42
+distribution.zmax = 0.42
+distribution.seed = 42
+
+bins = 20
+samples = {}
+times = {}
+for grid in (False, True):
+    if grid:
+        distribution.setGrid(8*bins, 8*bins)
+    samples[grid] = distribution.randomToroidalArray(N)
+    M = max(N//10, 1000)
+    times[grid] = best_time(lambda: distribution.randomToroidalArray(M))/M
+
+checks = []
+for name, coordinate, bounds in (('R', lambda p: numpy.hypot(p[:, 0], p[:, 1]), (distribution.Rmin, distribution.Rmax)),
+        ('z', lambda p: p[:, 2], (distribution.zmin, distribution.zmax))):
+    rejection, _ = numpy.histogram(coordinate(samples[False]), bins=bins, range=bounds)
+    tabulated, _ = numpy.histogram(coordinate(samples[True]), bins=bins, range=bounds)
+    used = rejection + tabulated > 0
+    # Both samples have N points, so (a - b)^2/(a + b) is chi^2 distributed with one degree of freedom less than the used bins.
+    chi2 = ((rejection[used] - tabulated[used])**2/(rejection[used] + tabulated[used]).astype(float)).sum()
+    dof = used.sum() - 1
+    limit = dof + 5.0*math.sqrt(2.0*dof)
+    checks.append(('chi^2 of %d %s bins' % (bins, name), chi2 < limit, 'chi^2/dof = %.3f, limit %.3f' % (chi2/dof, limit/dof)))
+
+passed = True
+for name, ok, detail in checks:
+    print('%-22s %-6s %s' % (name, 'ok' if ok else 'FAILED', detail))
+    passed = passed and ok
+
+for grid in (False, True):
+    print('%-10s %10.3g points/s' % ('grid' if grid else 'rejection', 1.0/times[grid]))
+sys.exit(0 if passed else 1)
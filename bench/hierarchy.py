@@ -0,0 +1,52 @@
+"""Scaling of mesh.evaluateHitsArray with the bounding volume hierarchy against testing every triangle.
+
+Usage: python bench/hierarchy.py [--large]
+
+Rays start at random points inside tori of growing size and go into isotropic directions.
+The brute force mesh holds the same triangles appended one by one, which leaves it without hierarchy,
+and is only timed on as many rays as fit into a few seconds.
+The element indices of both have to be identical, otherwise the script exits with status 1.
+--large adds a torus of 10^6 triangles, which takes about a minute to write and load.
+"""
+import os
+import sys
+import time
+import numpy
+import wallLoad
+from common import write_torus, temporary, best_time
+
+sizes = [(8, 16), (32, 64), (180, 360)]
+if '--large' in sys.argv:
+    sizes.append((500, 1000))
+rays = 100000
+bruteTests = 2e8
+
+generator = numpy.random.default_rng(1)
+phi = generator.uniform(0.0, 2.0*numpy.pi, rays)
+R = 1.5 + generator.uniform(-0.6, 0.6, rays)
+origins = numpy.column_stack((R*numpy.cos(phi), R*numpy.sin(phi), generator.uniform(-0.6, 0.6, rays)))
+directions = generator.normal(size=(rays, 3))
+
+print('%10s %12s %16s %16s %10s' % ('triangles', 'load [s]', 'hierarchy [us]', 'brute [us]', 'identical'))
+identical = True
+for Np, Nt in sizes:
+    filename = temporary('.msh')
+    try:
+        write_torus(filename, Np, Nt)
+        start = time.perf_counter()
+        grid = wallLoad.core.mesh(filename)
+        load = time.perf_counter() - start
+    finally:
+        os.remove(filename)
+    N = len(grid)
+    hierarchy = best_time(lambda: grid.evaluateHitsArray(origins, directions))/rays
+    brute = wallLoad.core.mesh([])
+    for i in range(N):
+        brute.append(grid[i])
+    M = int(min(rays, max(100, bruteTests/N)))
+    bruteTime = best_time(lambda: brute.evaluateHitsArray(origins[:M], directions[:M]), 1)/M
+    same = numpy.array_equal(grid.evaluateHitsArray(origins[:M], directions[:M])[0], brute.evaluateHitsArray(origins[:M], directions[:M])[0])
+    identical = identical and same
+    print('%10d %12.2f %16.2f %16.2f %10s' % (N, load, 1e6*hierarchy, 1e6*bruteTime, same))
+
+sys.exit(0 if identical else 1)
@@ -0,0 +1,53 @@
+"""Accuracy and cost of the bicubic spline interpolation of psi against the bilinear one.
+
+Usage: python bench/spline.py [N]
+
+psi(R, z) = sin(3 R) cos(2 z) + R z^2 is sampled on a 65 x 129 grid and both interpolations are compared
+with the exact flux and gradient at N random points (default 10^5).
+The times per point include the conversion of the python lists, which is the same for both modes.
+The script exits with status 1 if the spline is not more accurate than the bilinear interpolation.
+"""
+import os
+import sys
+import math
+import numpy
+import wallLoad
+from common import write_eqdsk, temporary, best_time
+
+
+def psi(R, z):
+    return numpy.sin(3.0*R)*numpy.cos(2.0*z) + R*z**2
+
+
+def gradient(R, z):
+    return 3.0*numpy.cos(3.0*R)*numpy.cos(2.0*z) + z**2, -2.0*numpy.sin(3.0*R)*numpy.sin(2.0*z) + 2.0*R*z
+
+
+N = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+filename = temporary('.eqdsk')
+try:
+    write_eqdsk(filename, 65, 129, lambda R, z: math.sin(3.0*R)*math.cos(2.0*z) + R*z**2)
+    eq = wallLoad.core.equilibrium(filename)
+finally:
+    os.remove(filename)
+
+generator = numpy.random.default_rng(1)
+R = generator.uniform(1.0, 2.0, N)
+z = generator.uniform(-1.0, 1.0, N)
+Rlist = R.tolist()
+zlist = z.tolist()
+exact = psi(R, z)
+exactR, exactz = gradient(R, z)
+
+print('%-9s %14s %14s %14s %14s' % ('mode', 'max |psi|', 'max |grad psi|', 'psi [ns]', 'gradient [ns]'))
+errors = {}
+for mode in (False, True):
+    eq.spline = mode
+    values = numpy.array(eq.psi(Rlist, zlist))
+    dR, dz = (numpy.array(v) for v in eq.psiGradient(Rlist, zlist))
+    errors[mode] = (numpy.abs(values - exact).max(), numpy.hypot(dR - exactR, dz - exactz).max())
+    value = best_time(lambda: eq.psi(Rlist, zlist))/N
+    slope = best_time(lambda: eq.psiGradient(Rlist, zlist))/N
+    print('%-9s %14.2e %14.2e %14.1f %14.1f' % ('spline' if mode else 'bilinear', errors[mode][0], errors[mode][1], 1e9*value, 1e9*slope))
+
+sys.exit(0 if errors[True][0] < errors[False][0] and errors[True][1] < errors[False][1] else 1)
@@ -0,0 +1,95 @@
+/* Micro-benchmark of the geometric value types vektor, vertex and hitResult.
+ *
+ * Usage: ./valueTypes [N]
+ *
+ * It prints the size and the type traits of the value types, the time of vertex::intersect per test on N rays
+ * (default 10^7) against a fixed triangle, once random and once aimed at the triangle, and the time per element
+ * of growing a std::vector<hitResult> to 20000 elements with push_back like mesh::evaluateHits does.
+ * The header only core does not need the extension, build it from the repository root with
+ *
+ *     g++ -std=c++17 -O2 -Iinclude $(python3-config --includes) bench/valueTypes.cpp -o valueTypes
+ *
+ * Older trees, whose value types include boost/python.hpp, also need $(python3-config --ldflags --embed) -lboost_python311.
+ * Changing the include path to such a tree compares both.
+ */
+#include <wallLoad/core/vertex.hpp>
+#include <wallLoad/core/hitResult.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <type_traits>
+
+using namespace wallLoad::core;
+
+template<typename T>
+void print_traits(const char * name) {
+    printf("%-10s %3u bytes  trivially copyable %-3s  standard layout %-3s  polymorphic %s\n", name, (unsigned)sizeof(T),
+        std::is_trivially_copyable<T>::value ? "yes" : "no", std::is_standard_layout<T>::value ? "yes" : "no",
+        std::is_polymorphic<T>::value ? "yes" : "no");
+}
+
+template<typename F>
+double best_time(F function, const int repeat = 5) {
+    double best = 1e300;
+    for(int k = 0; k < repeat; ++k) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if(elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+int main(int argc, char ** argv) {
+    const uint32_t N = argc > 1 ? atol(argv[1]) : 10000000;
+    print_traits<vektor>("vektor");
+    print_traits<vertex>("vertex");
+    print_traits<hitResult>("hitResult");
+
+    // Random rays take the rejection branches in a random order, rays aimed at the triangle always hit.
+    std::mt19937_64 generator(1);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::vector<vektor> origins, directions, aimed;
+    origins.reserve(N);
+    directions.reserve(N);
+    aimed.reserve(N);
+    for(uint32_t i = 0; i < N; ++i) {
+        origins.push_back(vektor(uniform(generator), uniform(generator), -1.0));
+        directions.push_back(vektor(uniform(generator), uniform(generator), 1.0));
+        aimed.push_back(vektor(-origins.back().x + 0.2*uniform(generator), -origins.back().y + 0.2*uniform(generator) - 0.3, 1.0));
+    }
+    const vertex triangle(vektor(-1.0, -1.0, 0.0), vektor(1.0, -1.0, 0.0), vektor(0.0, 1.0, 0.0));
+    const char * names[] = {"random", "aimed"};
+    const std::vector<vektor> * rays[] = {&directions, &aimed};
+    for(uint32_t k = 0; k < 2; ++k) {
+        const std::vector<vektor> & ray = *rays[k];
+        uint32_t hits = 0;
+        double time = best_time([&]() {
+            hits = 0;
+            for(uint32_t i = 0; i < N; ++i) {
+                hitResult hit = triangle.intersect(origins[i], ray[i]);
+                if(hit) ++hits;
+            }
+        });
+        printf("vertex::intersect  %8.2f ns/test  %-6s rays, %u of %u hit\n", 1e9*time/N, names[k], hits, N);
+    }
+
+    const uint32_t M = 20000;
+    const uint32_t rounds = 500;
+    volatile int32_t sink = 0;
+    double time = best_time([&]() {
+        for(uint32_t k = 0; k < rounds; ++k) {
+            std::vector<hitResult> results;
+            for(uint32_t i = 0; i < M; ++i) {
+                results.push_back(hitResult(true, origins[i % N]));
+                results.back().element = i;
+            }
+            sink = results.back().element;
+        }
+    });
+    printf("push_back growth   %8.2f ns/element to %u elements\n", 1e9*time/(M*rounds), M);
+    return 0;
+}
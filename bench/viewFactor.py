@@ -0,0 +1,79 @@
+"""Deterministic view-factor load against the Monte Carlo load.
+
+Usage: python bench/viewFactor.py [N]
+
+The load of a peaked profile on circular flux surfaces onto a black torus is calculated by viewFactorLoad and
+by radiationLoad with N samples (default 2*10^6). The pulls (q_vf - q_mc)/sigma_mc of every element, with the
+standard error of getHeatFluxErrorArray, have to have a standard deviation in [0.9, 1.1] and a mean within five
+standard errors of zero, i.e. the view factors agree with the tallies within their statistics.
+A sector of the same torus with toroidal instances has to give the flux and absorbed fraction of the full torus,
+up to the integration errors of the other sectors of the full torus, which are far below the tolerance.
+The script exits with status 1 if a check fails, and prints the time of both methods.
+"""
+import os
+import sys
+import math
+import time
+import numpy
+import wallLoad
+from common import write_torus, write_eqdsk, temporary
+
+N = int(sys.argv[1]) if len(sys.argv) > 1 else 2000000
+Np, Nt, sectors = 36, 24, 6
+filename = temporary('.eqdsk')
+try:
+    write_eqdsk(filename, 129, 129, lambda R, z: ((R - 1.5)**2 + z**2)/0.64)
+    eq = wallLoad.core.equilibrium(filename)
+finally:
+    os.remove(filename)
+profile = wallLoad.core.radiationProfile([0.0, 0.5, 1.0, 1.2], [1.0, 2.0, 1.0, 0.0])
+distribution = wallLoad.core.radiationDistribution(eq, profile)
+filename = temporary('.msh')
+try:
+    write_torus(filename, Np, Nt)
+    torus = wallLoad.core.mesh(filename)
+finally:
+    os.remove(filename)
+# write_torus writes the elements sector by sector, so the first ones form the sector from phi = 0 to 2 pi/sectors.
+sector = wallLoad.core.mesh([])
+for i in range(2*Nt*Np//sectors):
+    sector.append(torus[i])
+sector.buildHierarchy()
+sector.setToroidalInstances(sectors)
+
+start = time.perf_counter()
+view = wallLoad.core.viewFactorLoad(torus, distribution)
+view.calculate()
+viewTime = time.perf_counter() - start
+q = view.getHeatFluxArray(1.0e6)
+
+start = time.perf_counter()
+load = wallLoad.core.radiationLoad(torus, distribution)
+load.threads = os.cpu_count() or 1
+load.addSamples(N)
+loadTime = time.perf_counter() - start
+reference, error = load.getHeatFluxErrorArray(1.0e6)
+checks = []
+
+pulls = (q - reference)/(reference*error)
+checks.append(('pull std', 0.9 <= pulls.std() <= 1.1, '%.3f, limit [0.9, 1.1]' % pulls.std()))
+limit = 5.0/math.sqrt(len(pulls))
+checks.append(('pull mean', abs(pulls.mean()) < limit, '%.3f, limit %.3f' % (pulls.mean(), limit)))
+checks.append(('absorbed fraction', abs(view.absorbedFraction - load.absorbedFraction) < 0.01,
+    'view factor %.4f, Monte Carlo %.4f' % (view.absorbedFraction, load.absorbedFraction)))
+
+instanced = wallLoad.core.viewFactorLoad(sector, distribution)
+instanced.calculate()
+limit = 0.1*view.tolerance
+difference = numpy.abs(instanced.getHeatFluxArray(1.0e6)/q[:len(sector)] - 1.0).max()
+checks.append(('instanced flux', difference < limit, 'max relative difference %.1e, limit %.0e' % (difference, limit)))
+difference = abs(instanced.absorbedFraction/view.absorbedFraction - 1.0)
+checks.append(('instanced absorbed', difference < limit, 'relative difference %.1e, limit %.0e' % (difference, limit)))
+
+passed = True
+for name, ok, detail in checks:
+    print('%-22s %-6s %s' % (name, 'ok' if ok else 'FAILED', detail))
+    passed = passed and ok
+
+print('view factor %.2f s, Monte Carlo %.2f s for %d samples on %d elements' % (viewTime, loadTime, N, len(torus)))
+sys.exit(0 if passed else 1)
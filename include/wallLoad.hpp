@@ -2,6 +2,7 @@
 #define include_wallLoad_hpp
 
 #include <wallLoad/core.hpp>
+#include <wallLoad/python.hpp>
 
 
 #endif 
@@ -1,17 +1,35 @@
 #ifndef include_wallLoad_core_hpp
 #define include_wallLoad_core_hpp
 
+#include <wallLoad/core/mappedFile.hpp>
+#include <wallLoad/core/textParser.hpp>
+#include <wallLoad/core/sharedArray.hpp>
+#include <wallLoad/core/instanceMutex.hpp>
+#include <wallLoad/core/philox.hpp>
+#include <wallLoad/core/aliasTable.hpp>
+#include <wallLoad/core/sobolSequence.hpp>
 #include <wallLoad/core/vektor.hpp>
 #include <wallLoad/core/polygon.hpp>
 #include <wallLoad/core/vertex.hpp>
 #include <wallLoad/core/hitResult.hpp>
+#include <wallLoad/core/triangleStore.hpp>
+#include <wallLoad/core/boundingVolumeHierarchy.hpp>
+#include <wallLoad/core/mshFile.hpp>
+#include <wallLoad/core/meshCache.hpp>
 #include <wallLoad/core/mesh.hpp>
 #include <wallLoad/core/directionGenerator.hpp>
 #include <wallLoad/core/probabilityDistribution.hpp>
 #include <wallLoad/core/radiationProfile.hpp>
+#include <wallLoad/core/bicubicSpline.hpp>
 #include <wallLoad/core/equilibrium.hpp>
 #include <wallLoad/core/radiationDistribution.hpp>
+#include <wallLoad/core/samplingRounds.hpp>
+#include <wallLoad/core/reflectionPath.hpp>
 #include <wallLoad/core/radiationLoad.hpp>
+#include <wallLoad/core/samplingJob.hpp>
+#include <wallLoad/core/responseMatrix.hpp>
+#include <wallLoad/core/axisymmetricLoad.hpp>
+#include <wallLoad/core/viewFactorLoad.hpp>
 #include <wallLoad/core/diffuseScatter.hpp>
 
 #endif 
@@ -0,0 +1,125 @@
+#ifndef include_wallLoad_core_aliasTable_hpp
+#define include_wallLoad_core_aliasTable_hpp
+
+#include <vector>
+#include <stdint.h>
+#include <boost/random.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Alias table for sampling from a discrete distribution.
+         *
+         * This class implements the alias method of Walker (1977) in the construction of Vose (1991).
+         * After the table has been built from a list of non-negative weights,
+         * an index \f$i\f$ is drawn with probability \f$w_i/\sum w_j\f$ in constant time from two uniform random numbers.
+         */
+        class aliasTable {
+            public:
+                /*! \brief Default constructor
+                 *
+                 * This constructor initializes an empty table.
+                 */
+                aliasTable() : m_probability(), m_alias(), m_total(0.0) {}
+
+                /*! \brief Constructor
+                 *
+                 * This constructor builds the table for the given weights.
+                 */
+                aliasTable(const std::vector<double> & weights) : m_probability(), m_alias(), m_total(0.0) {
+                    build(weights);
+                }
+
+                /*! \brief Build the table
+                 *
+                 * This function builds the table for the given weights.
+                 * If all weights are zero the table stays empty.
+                 */
+                void build(const std::vector<double> & weights) {
+                    uint32_t N = weights.size();
+                    m_probability.assign(N, 0.0);
+                    m_alias.assign(N, 0);
+                    m_total = 0.0;
+                    for(uint32_t i = 0; i < N; ++i) {
+                        m_total += weights[i];
+                    }
+                    if(N == 0 || m_total <= 0.0) {
+                        clear();
+                        return;
+                    }
+                    std::vector<uint32_t> small, large;
+                    for(uint32_t i = 0; i < N; ++i) {
+                        m_probability[i] = weights[i]*N/m_total;
+                        if(m_probability[i] < 1.0) {
+                            small.push_back(i);
+                        }
+                        else {
+                            large.push_back(i);
+                        }
+                    }
+                    while(!small.empty() && !large.empty()) {
+                        uint32_t less = small.back();
+                        uint32_t more = large.back();
+                        small.pop_back();
+                        m_alias[less] = more;
+                        m_probability[more] = (m_probability[more] + m_probability[less]) - 1.0;
+                        if(m_probability[more] < 1.0) {
+                            large.pop_back();
+                            small.push_back(more);
+                        }
+                    }
+                    for(auto iter = large.begin(); iter != large.end(); ++iter) {
+                        m_probability[*iter] = 1.0;
+                        m_alias[*iter] = *iter;
+                    }
+                    for(auto iter = small.begin(); iter != small.end(); ++iter) {
+                        m_probability[*iter] = 1.0;
+                        m_alias[*iter] = *iter;
+                    }
+                }
+
+                /*! \brief Remove all entries from the table. */
+                void clear() {
+                    m_probability.clear();
+                    m_alias.clear();
+                    m_total = 0.0;
+                }
+
+                /*! \brief Check if the table is empty. */
+                bool empty() const {
+                    return m_probability.empty();
+                }
+
+                /*! \brief Number of entries in the table. */
+                uint32_t size() const {
+                    return m_probability.size();
+                }
+
+                /*! \brief Sum of the weights the table was built from. */
+                double get_total() const {
+                    return m_total;
+                }
+
+                /*! \brief Draw an index
+                 *
+                 * This function returns a random index drawn with the given random number generator.
+                 * The first random number selects the column, the second decides between the column and its alias.
+                 */
+                template<class Generator>
+                uint32_t sample(Generator & generator) const {
+                    boost::random::uniform_01<double> uniform;
+                    uint32_t i = uniform(generator)*m_probability.size();
+                    if(i >= m_probability.size()) {
+                        i = m_probability.size() - 1;
+                    }
+                    return uniform(generator) < m_probability[i] ? i : m_alias[i];
+                }
+
+            protected:
+                std::vector<double> m_probability; /*!< \brief Probability to keep the column instead of taking its alias. */
+                std::vector<uint32_t> m_alias; /*!< \brief Alias of each column. */
+                double m_total; /*!< \brief Sum of the weights. */
+        };
+    }
+}
+
+#endif
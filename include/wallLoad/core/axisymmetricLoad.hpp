@@ -0,0 +1,534 @@
+#ifndef include_wallLoad_core_axisymmetricLoad_hpp
+#define include_wallLoad_core_axisymmetricLoad_hpp
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <boost/math/constants/constants.hpp>
+#include <wallLoad/core/polygon.hpp>
+#include <wallLoad/core/radiationDistribution.hpp>
+#include <wallLoad/core/directionGenerator.hpp>
+#include <wallLoad/core/philox.hpp>
+#include <wallLoad/core/samplingRounds.hpp>
+#include <wallLoad/core/instanceMutex.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Radiation load onto an axisymmetric first wall given by its \f$(R,z)\f$ contour.
+         *
+         * This class does the same as radiationLoad for a wall which is the polygon revolved about the z axis,
+         * without a mesh: the rays are intersected analytically with the cones, cylinders and annuli swept by the segments
+         * of the polygon and the hits are recorded for every segment.
+         * The ith segment goes from the ith point of the polygon to the next one, the last one closes the polygon.
+         * The wall absorbs all radiation, there are no reflections.
+         * Sample i starts from the same point in the same direction as sample i of a radiationLoad with the same seed
+         * and radiation distribution, so both agree up to the faceting of the mesh.
+         * All functions lock the mutex of the instance, so it can be shared by several threads.
+         */
+        class axisymmetricLoad {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor initializes an empty load onto the given contour from the given radiation distribution.
+                 */
+                axisymmetricLoad(const polygon & contour, const radiationDistribution & distribution) :
+                    axisymmetricLoad(contour, distribution, readLock(distribution.get_mutex())) {
+                }
+
+                /*! \brief Copy constructor */
+                axisymmetricLoad(const axisymmetricLoad & rhs) :
+                    axisymmetricLoad(rhs, readLock(rhs.m_mutex)) {
+                }
+
+                /*! \brief Assignment operator */
+                axisymmetricLoad & operator=(const axisymmetricLoad & rhs) {
+                    if(this != &rhs) {
+                        axisymmetricLoad copy(rhs);
+                        writeLock lock(m_mutex);
+                        m_segments = copy.m_segments;
+                        m_nodes = copy.m_nodes;
+                        m_area = copy.m_area;
+                        m_radiationDistribution = copy.m_radiationDistribution;
+                        m_hits = copy.m_hits;
+                        m_threads = copy.m_threads;
+                        m_seed = copy.m_seed;
+                        m_sample = copy.m_sample;
+                        ++m_generation;
+                    }
+                    return *this;
+                }
+
+                /*! \brief Clear the recorded hits. */
+                void clear() {
+                    writeLock lock(m_mutex);
+                    std::fill(m_hits.begin(), m_hits.end(), 0);
+                    ++m_generation;
+                }
+
+                /*! \brief Add samples
+                 *
+                 * This function traces N samples in rounds of contiguous blocks, one per thread, like radiationLoad::add_samples(),
+                 * see samplingRounds.
+                 * Every thread counts the hits of its block, so the result does not depend on the number of threads.
+                 * A round is traced again if clear() or set_seed() was called meanwhile.
+                 */
+                void add_samples(const uint64_t N) {
+                    samplingRounds::add(*this, N, 0, 0,
+                        [this](const std::vector<sampleList> & lists, const uint64_t first, uint64_t & next, const uint64_t) {
+                            for(auto list = lists.begin(); list != lists.end(); ++list) {
+                                for(uint32_t i = 0; i < m_hits.size(); ++i) {
+                                    m_hits[i] += (*list)[i];
+                                }
+                            }
+                            return next - first;
+                        });
+                }
+
+                /*! \brief Set the seed
+                 *
+                 * This function sets the seed of the random number streams and restarts them at the first sample.
+                 * The recorded hits are not changed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    writeLock lock(m_mutex);
+                    m_seed = seed;
+                    m_sample = 0;
+                    ++m_generation;
+                }
+
+                /*! \brief Get the seed of the random number streams. */
+                uint64_t get_seed() const {
+                    readLock lock(m_mutex);
+                    return m_seed;
+                }
+
+                /*! \brief Get the number of samples traced since the seed was set. */
+                uint64_t get_samples() const {
+                    readLock lock(m_mutex);
+                    return m_sample;
+                }
+
+                /*! \brief Set the number of threads used by add_samples(). */
+                void set_threads(const uint32_t threads) {
+                    writeLock lock(m_mutex);
+                    m_threads = std::max(1u, threads);
+                }
+
+                /*! \brief Get the number of threads used by add_samples(). */
+                uint32_t get_threads() const {
+                    readLock lock(m_mutex);
+                    return m_threads;
+                }
+
+                /*! \brief Get the number of segments. */
+                uint32_t size() const {
+                    return m_area.size();
+                }
+
+                /*! \brief Get the recorded hits of every segment. */
+                std::vector<uint64_t> get_hits() const {
+                    readLock lock(m_mutex);
+                    return m_hits;
+                }
+
+                /*! \brief Get the total number of recorded hits. */
+                uint64_t get_total_hits() const {
+                    readLock lock(m_mutex);
+                    return total_hits();
+                }
+
+                /*! \brief Get the areas of the surfaces swept by the segments. */
+                std::vector<double> get_area() const {
+                    return m_area;
+                }
+
+                /*! \brief Calculate the heat flux density onto the segments
+                 *
+                 * Provided the total power, this function calculates the heat flux density onto the surfaces swept by the
+                 * segments from their hits \f$N_i\f$ of \f$N\f$ like radiationLoad::get_heat_flux(),
+                 * \f$ P_i = P_{tot} \frac{N_i}{N A_i} \f$. Segments of zero length get zero.
+                 */
+                std::vector<double> get_heat_flux(const double Ptot) const {
+                    std::vector<double> output(size());
+                    get_heat_flux(Ptot, output.data());
+                    return output;
+                }
+
+                /*! \brief Calculate the heat flux density onto the segments
+                 *
+                 * This function writes the heat flux density onto the size() segments to the given memory.
+                 * If error is given, the relative standard error of the same hits is written there, see get_relative_error().
+                 */
+                void get_heat_flux(const double Ptot, double * output, double * error = 0) const {
+                    readLock lock(m_mutex);
+                    double total = total_hits();
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        output[i] = m_area[i] > 0.0 ? m_hits[i]/total/m_area[i]*Ptot : 0.0;
+                        if(error) {
+                            error[i] = relative_error(i, total);
+                        }
+                    }
+                }
+
+                /*! \brief Calculate the relative standard error of the heat flux density onto the segments
+                 *
+                 * The hits are multinomially distributed among the segments, so the relative standard error is
+                 * \f$ \sqrt{\left(1 - N_i/N\right)/N_i} \f$, infinite for segments without hits.
+                 */
+                std::vector<double> get_relative_error() const {
+                    std::vector<double> output(size());
+                    get_relative_error(output.data());
+                    return output;
+                }
+
+                /*! \brief Calculate the relative standard error of the heat flux density onto the segments
+                 *
+                 * This function writes the relative standard error of the size() segments to the given memory.
+                 */
+                void get_relative_error(double * output) const {
+                    readLock lock(m_mutex);
+                    double total = total_hits();
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        output[i] = relative_error(i, total);
+                    }
+                }
+
+                /*! \brief Calculate the closest hit of the ray
+                 *
+                 * This function intersects the ray with the surfaces swept by the segments.
+                 * The segments are sorted into a bounding volume hierarchy of \f$(R,z)\f$ boxes.
+                 * In the poloidal plane the ray runs along a hyperbola, \f$R^2\f$ is quadratic and \f$z\f$ linear in the ray
+                 * parameter, so the range of \f$R\f$ within the \f$z\f$ range of a box is known exactly and boxes the ray
+                 * passes by, or only reaches behind the closest hit so far, are skipped.
+                 * \param origin Position from where the ray originates.
+                 * \param direction The direction in which the ray travels, a unit vector.
+                 * \param t Ray parameter of the hit, the hit point is origin + t*direction. Infinity if nothing is hit.
+                 * \return Index of the segment that got hit, -1 if nothing is hit.
+                 */
+                int32_t evaluate_closest(const vektor & origin, const vektor & direction, double & t) const {
+                    t = std::numeric_limits<double>::infinity();
+                    int32_t closest = -1;
+                    if(m_nodes.empty()) {
+                        return closest;
+                    }
+                    ray current;
+                    current.origin = origin;
+                    current.direction = direction;
+                    current.rho2 = origin.x*origin.x + origin.y*origin.y;
+                    current.rhoDot = origin.x*direction.x + origin.y*direction.y;
+                    current.cross = origin.x*direction.y - origin.y*direction.x;
+                    current.perpendicular2 = direction.x*direction.x + direction.y*direction.y;
+                    current.invDz = 1.0/direction.z;
+                    uint32_t stack[s_maxDepth];
+                    double stackDistance[s_maxDepth];
+                    uint32_t stackSize = 0;
+                    uint32_t node = 0;
+                    if(intersect_box(m_nodes[0], current, t) == std::numeric_limits<double>::infinity()) {
+                        return closest;
+                    }
+                    while(true) {
+                        const box & currentNode = m_nodes[node];
+                        if(currentNode.count > 0) {
+                            for(uint32_t i = currentNode.offset; i < currentNode.offset + currentNode.count; ++i) {
+                                if(intersect_segment(m_segments[i], current, t)) {
+                                    closest = m_segments[i].index;
+                                }
+                            }
+                        }
+                        else {
+                            uint32_t left = node + 1;
+                            uint32_t right = currentNode.offset;
+                            double tLeft = intersect_box(m_nodes[left], current, t);
+                            double tRight = intersect_box(m_nodes[right], current, t);
+                            bool hitLeft = tLeft != std::numeric_limits<double>::infinity();
+                            bool hitRight = tRight != std::numeric_limits<double>::infinity();
+                            if(hitLeft && hitRight) {
+                                if(tRight < tLeft) {
+                                    std::swap(left, right);
+                                    std::swap(tLeft, tRight);
+                                }
+                                stack[stackSize] = right;
+                                stackDistance[stackSize] = tRight;
+                                ++stackSize;
+                                node = left;
+                                continue;
+                            }
+                            if(hitLeft) {
+                                node = left;
+                                continue;
+                            }
+                            if(hitRight) {
+                                node = right;
+                                continue;
+                            }
+                        }
+                        do {
+                            if(stackSize == 0) {
+                                return closest;
+                            }
+                            --stackSize;
+                            node = stack[stackSize];
+                        } while(stackDistance[stackSize] > t);
+                    }
+                }
+
+            protected:
+                /*! \brief Constructor
+                 *
+                 * This constructor copies the given radiation distribution while the given lock keeps it unchanged.
+                 */
+                axisymmetricLoad(const polygon & contour, const radiationDistribution & distribution, const readLock &) :
+                    m_segments(), m_nodes(), m_area(contour.size()), m_radiationDistribution(distribution), m_directionGenerator(),
+                    m_hits(contour.size(), 0), m_threads(1), m_seed(philox::default_seed), m_sample(0), m_generation(0) {
+                    const std::vector<double> & R = contour.get_R();
+                    const std::vector<double> & z = contour.get_z();
+                    for(uint32_t i = 0; i < contour.size(); ++i) {
+                        uint32_t j = (i + 1) % contour.size();
+                        segment current;
+                        current.R1 = R[i];
+                        current.z1 = z[i];
+                        current.dR = R[j] - R[i];
+                        current.dz = z[j] - z[i];
+                        double length = hypot(current.dR, current.dz);
+                        m_area[i] = boost::math::constants::pi<double>()*(R[i] + R[j])*length;
+                        if(length == 0.0) {
+                            continue;
+                        }
+                        current.nR = current.dz/length;
+                        current.nz = -current.dR/length;
+                        current.invLength2 = 1.0/(length*length);
+                        current.index = i;
+                        m_segments.push_back(current);
+                    }
+                    if(!m_segments.empty()) {
+                        build_node(0, m_segments.size(), 0);
+                    }
+                }
+
+                /*! \brief Copy constructor
+                 *
+                 * This constructor copies the given instance while the given lock keeps it unchanged.
+                 */
+                axisymmetricLoad(const axisymmetricLoad & rhs, const readLock &) :
+                    m_segments(rhs.m_segments), m_nodes(rhs.m_nodes), m_area(rhs.m_area),
+                    m_radiationDistribution(rhs.m_radiationDistribution), m_directionGenerator(),
+                    m_hits(rhs.m_hits), m_threads(rhs.m_threads), m_seed(rhs.m_seed), m_sample(rhs.m_sample), m_generation(rhs.m_generation) {
+                }
+
+                /*! \brief Segment of the contour and the surface it sweeps. */
+                struct segment {
+                    double R1; /*!< \brief \f$R\f$ of the first point. */
+                    double z1; /*!< \brief \f$z\f$ of the first point. */
+                    double dR; /*!< \brief \f$R\f$ of the second point minus the one of the first. */
+                    double dz; /*!< \brief \f$z\f$ of the second point minus the one of the first. */
+                    double nR; /*!< \brief \f$R\f$ component of the unit normal. */
+                    double nz; /*!< \brief \f$z\f$ component of the unit normal. */
+                    double invLength2; /*!< \brief Inverse of the squared length. */
+                    uint32_t index; /*!< \brief Index of the segment in the polygon. */
+                };
+
+                /*! \brief Node of the bounding volume hierarchy of the segments. */
+                struct box {
+                    double Rmin; /*!< \brief Lowest \f$R\f$. */
+                    double Rmax; /*!< \brief Highest \f$R\f$. */
+                    double zmin; /*!< \brief Lowest \f$z\f$. */
+                    double zmax; /*!< \brief Highest \f$z\f$. */
+                    uint32_t offset; /*!< \brief First segment of a leaf or index of the right child of an inner node. */
+                    uint32_t count; /*!< \brief Number of segments of a leaf, zero for inner nodes. */
+                };
+
+                /*! \brief Ray with the quantities shared by the intersections with all boxes and segments. */
+                struct ray {
+                    vektor origin; /*!< \brief Origin. */
+                    vektor direction; /*!< \brief Unit direction. */
+                    double rho2; /*!< \brief Squared \f$R\f$ of the origin. */
+                    double rhoDot; /*!< \brief Dot product of the horizontal components of origin and direction. */
+                    double cross; /*!< \brief Cross product of the horizontal components of origin and direction. */
+                    double perpendicular2; /*!< \brief Squared length of the horizontal component of the direction. */
+                    double invDz; /*!< \brief Inverse of the z component of the direction. */
+
+                    /*! \brief Squared \f$R\f$ at the ray parameter t. */
+                    double R2(const double t) const {
+                        if(t == std::numeric_limits<double>::infinity()) {
+                            return perpendicular2 > 0.0 ? t : rho2;
+                        }
+                        return rho2 + t*(2.0*rhoDot + t*perpendicular2);
+                    }
+                };
+                typedef std::vector<uint64_t> sampleList; /*!< \brief Hits of every segment by a block of samples. */
+
+                /*! \brief Build the node for the segments in the index range [first, last[ and, recursively, its children.
+                 *
+                 * The segments are split at the median of their centres along the longer side of the box.
+                 */
+                void build_node(const uint32_t first, const uint32_t last, const uint32_t depth) {
+                    uint32_t index = m_nodes.size();
+                    box current = {std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), first, last - first};
+                    for(uint32_t i = first; i < last; ++i) {
+                        const segment & entry = m_segments[i];
+                        current.Rmin = std::min(current.Rmin, std::min(entry.R1, entry.R1 + entry.dR));
+                        current.Rmax = std::max(current.Rmax, std::max(entry.R1, entry.R1 + entry.dR));
+                        current.zmin = std::min(current.zmin, std::min(entry.z1, entry.z1 + entry.dz));
+                        current.zmax = std::max(current.zmax, std::max(entry.z1, entry.z1 + entry.dz));
+                    }
+                    m_nodes.push_back(current);
+                    if(last - first <= s_leafSize || depth + 1 >= s_maxDepth) {
+                        return;
+                    }
+                    bool alongR = current.Rmax - current.Rmin > current.zmax - current.zmin;
+                    uint32_t middle = (first + last)/2;
+                    std::nth_element(m_segments.begin() + first, m_segments.begin() + middle, m_segments.begin() + last,
+                        [alongR](const segment & a, const segment & b) {
+                            return alongR ? 2.0*a.R1 + a.dR < 2.0*b.R1 + b.dR : 2.0*a.z1 + a.dz < 2.0*b.z1 + b.dz;
+                        });
+                    m_nodes[index].count = 0;
+                    build_node(first, middle, depth + 1);
+                    m_nodes[index].offset = m_nodes.size();
+                    build_node(middle, last, depth + 1);
+                }
+
+                /*! \brief Ray parameter where the ray enters the box before tMax, infinity if it does not. */
+                static double intersect_box(const box & node, const ray & current, const double tMax) {
+                    double tNear = 0.0;
+                    double tFar = tMax;
+                    if(current.direction.z != 0.0) {
+                        double t0 = (node.zmin - s_tolerance - current.origin.z)*current.invDz;
+                        double t1 = (node.zmax + s_tolerance - current.origin.z)*current.invDz;
+                        tNear = std::max(tNear, std::min(t0, t1));
+                        tFar = std::min(tFar, std::max(t0, t1));
+                    }
+                    else if(current.origin.z < node.zmin - s_tolerance || current.origin.z > node.zmax + s_tolerance) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    if(tNear > tFar) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    double R2Near = current.R2(tNear);
+                    double R2Far = current.R2(tFar);
+                    double R2Min = std::min(R2Near, R2Far);
+                    if(current.perpendicular2 > 0.0) {
+                        double tClosest = -current.rhoDot/current.perpendicular2;
+                        if(tClosest > tNear && tClosest < tFar) {
+                            R2Min = std::min(R2Min, current.cross*current.cross/current.perpendicular2);
+                        }
+                    }
+                    double Rmin = std::max(0.0, node.Rmin - s_tolerance);
+                    double Rmax = node.Rmax + s_tolerance;
+                    if(R2Min > Rmax*Rmax || std::max(R2Near, R2Far) < Rmin*Rmin) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    return tNear;
+                }
+
+                /*! \brief Intersect the ray with the surface swept by the segment
+                 *
+                 * Points of the surface fulfil \f$n_R (R - R_1) + n_z (z - z_1) = 0\f$, squared this is quadratic in the
+                 * ray parameter. If there is a hit before t, t is replaced by it and true is returned.
+                 */
+                static bool intersect_segment(const segment & current, const ray & line, double & t) {
+                    double c = current.nR*current.R1 - current.nz*(line.origin.z - current.z1);
+                    double b = current.nz*line.direction.z;
+                    double nR2 = current.nR*current.nR;
+                    double halfB = nR2*line.rhoDot + c*b;
+                    double A = nR2*line.perpendicular2 - b*b;
+                    double C = nR2*line.rho2 - c*c;
+                    double vx = c*line.direction.x + b*line.origin.x;
+                    double vy = c*line.direction.y + b*line.origin.y;
+                    double discriminant = vx*vx + vy*vy - nR2*line.cross*line.cross;
+                    if(discriminant < 0.0) {
+                        return false;
+                    }
+                    double q = -(halfB + std::copysign(fabs(current.nR)*sqrt(discriminant), halfB));
+                    if(q == 0.0) {
+                        return false;
+                    }
+                    bool hit = false;
+                    double roots[2] = {q/A, C/q};
+                    for(uint32_t k = 0; k < 2; ++k) {
+                        double root = roots[k];
+                        if(!(root > 0.0 && root < t)) {
+                            continue;
+                        }
+                        // the squared equation also holds on the surface mirrored at the axis
+                        if((c - b*root)*current.nR < 0.0) {
+                            continue;
+                        }
+                        double z = line.origin.z + root*line.direction.z;
+                        double R = sqrt(line.R2(root));
+                        double s = ((R - current.R1)*current.dR + (z - current.z1)*current.dz)*current.invLength2;
+                        if(s < -s_tolerance || s > 1.0 + s_tolerance) {
+                            continue;
+                        }
+                        t = root;
+                        hit = true;
+                    }
+                    return hit;
+                }
+
+                /*! \brief Total number of recorded hits without locking the instance. */
+                double total_hits() const {
+                    double total = 0.0;
+                    for(auto iter = m_hits.begin(); iter != m_hits.end(); ++iter) {
+                        total += *iter;
+                    }
+                    return total;
+                }
+
+                /*! \brief Relative standard error of the ith segment without locking the instance. */
+                double relative_error(const uint32_t i, const double total) const {
+                    if(m_hits[i] == 0) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    return sqrt((1.0 - m_hits[i]/total)/m_hits[i]);
+                }
+
+                /*! \brief Trace the samples with the given indices.
+                 *
+                 * This function traces the samples first, ..., first + N - 1 and counts the hits of every segment in hits,
+                 * which it resets first.
+                 * It is run by each thread of add_samples() and only reads the instance.
+                 */
+                void sample(const uint64_t first, const uint64_t N, sampleList & hits) const {
+                    philox sourceGenerator;
+                    double x[samplingRounds::s_directionBatch], y[samplingRounds::s_directionBatch], z[samplingRounds::s_directionBatch];
+                    double t;
+                    hits.assign(m_hits.size(), 0);
+                    for(uint64_t i = first; i < first + N; ++i) {
+                        if((i - first) % samplingRounds::s_directionBatch == 0) {
+                            m_directionGenerator.generate(m_seed, i, std::min(samplingRounds::s_directionBatch, first + N - i), x, y, z);
+                        }
+                        sourceGenerator.seed(m_seed, sourceStream, i);
+                        vektor origin = m_radiationDistribution.get_random_toroidal_point(sourceGenerator);
+                        uint64_t j = (i - first) % samplingRounds::s_directionBatch;
+                        int32_t element = evaluate_closest(origin, vektor(x[j], y[j], z[j]), t);
+                        if(element >= 0) {
+                            ++hits[element];
+                        }
+                    }
+                }
+
+                std::vector<segment> m_segments; /*!< \brief Segments of the contour of non-zero length, in the order of the hierarchy. */
+                std::vector<box> m_nodes; /*!< \brief Nodes of the bounding volume hierarchy, the left child follows its parent. */
+                std::vector<double> m_area; /*!< \brief Areas of the surfaces swept by the segments of the contour. */
+                radiationDistribution m_radiationDistribution; /*!< \brief Radiation distribution. */
+                directionGenerator m_directionGenerator; /*!< \brief Generator for random direction vectors. */
+                std::vector<uint64_t> m_hits; /*!< \brief Recorded hits of every segment. */
+                uint32_t m_threads; /*!< \brief Number of threads used by add_samples(). */
+                uint64_t m_seed; /*!< \brief Seed of the random number streams. */
+                uint64_t m_sample; /*!< \brief Index of the next sample. */
+                uint64_t m_generation; /*!< \brief Counter of the changes of the sampling, a round of add_samples() is only added if it did not change. */
+                mutable instanceMutex m_mutex; /*!< \brief Mutex guarding the instance. */
+
+                static constexpr uint32_t s_leafSize = 4; /*!< \brief Largest number of segments in a leaf. */
+                static constexpr uint32_t s_maxDepth = 64; /*!< \brief Largest depth of the hierarchy. */
+                static constexpr double s_tolerance = 1e-12; /*!< \brief Tolerance of the boxes and of the ends of the segments. */
+
+                friend class samplingRounds;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef include_wallLoad_core_bicubicSpline_hpp
+#define include_wallLoad_core_bicubicSpline_hpp
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <stdexcept>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(WALLLOAD_NO_SIMD)
+#define WALLLOAD_SIMD
+#include <immintrin.h>
+#endif
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Bicubic spline on a uniform grid.
+         *
+         * This class interpolates values given on a uniform grid with a tensor product cubic spline with not-a-knot end conditions.
+         * The 16 polynomial coefficients of every cell are calculated once in build(),
+         * so an evaluation only needs to locate the cell and evaluate the polynomial and its gradient.
+         * Outside of the grid the value and the gradient are zero.
+         * Batches of points are evaluated four at a time with AVX2 if the processor supports it.
+         */
+        class bicubicSpline {
+            public:
+                /*! \brief Signature of the batch evaluation kernels. */
+                typedef void (*kernel)(const bicubicSpline & spline, const double * x, const double * y, const uint32_t N,
+                    double * f, double * fx, double * fy);
+
+                /*! \brief Default constructor
+                 *
+                 * This constructor initializes an empty spline and selects the evaluation kernel.
+                 */
+                bicubicSpline() : m_Nx(0), m_Ny(0), m_x0(0.0), m_y0(0.0), m_invdx(0.0), m_invdy(0.0),
+                    m_coefficients(), m_kernel(&evaluate_scalar), m_instructionSet("scalar") {
+                    select_kernel();
+                }
+
+                /*! \brief Calculate the coefficients
+                 *
+                 * This function calculates the spline coefficients for the values
+                 * \f$f_{ij} = f(x_0 + i \Delta x, y_0 + j \Delta y)\f$, which are stored at values[i + j*Nx].
+                 * At least four grid points are needed in each direction.
+                 */
+                void build(const double * values, const uint32_t Nx, const uint32_t Ny,
+                    const double x0, const double dx, const double y0, const double dy) {
+                    if(Nx < 4 || Ny < 4) {
+                        throw std::invalid_argument("A bicubic spline needs at least 4 grid points in each direction.");
+                    }
+                    m_Nx = Nx;
+                    m_Ny = Ny;
+                    m_x0 = x0;
+                    m_y0 = y0;
+                    m_invdx = 1.0/dx;
+                    m_invdy = 1.0/dy;
+                    std::vector<double> fx(Nx*Ny), fy(Nx*Ny), fxy(Nx*Ny);
+                    for(uint32_t j = 0; j < Ny; ++j) {
+                        derivative(values + j*Nx, Nx, 1, &fx[j*Nx]);
+                    }
+                    for(uint32_t i = 0; i < Nx; ++i) {
+                        derivative(values + i, Ny, Nx, &fy[i]);
+                        derivative(&fx[i], Ny, Nx, &fxy[i]);
+                    }
+                    static const double C[4][4] = {{1, 0, 0, 0}, {0, 0, 1, 0}, {-3, 3, -2, -1}, {2, -2, 1, 1}};
+                    m_coefficients.assign((Nx-1)*(Ny-1)*16, 0.0);
+                    for(uint32_t j = 0; j + 1 < Ny; ++j) {
+                        for(uint32_t i = 0; i + 1 < Nx; ++i) {
+                            uint32_t k00 = i + j*Nx, k10 = k00 + 1, k01 = k00 + Nx, k11 = k01 + 1;
+                            double F[4][4] = {
+                                {values[k00], values[k01], fy[k00], fy[k01]},
+                                {values[k10], values[k11], fy[k10], fy[k11]},
+                                {fx[k00], fx[k01], fxy[k00], fxy[k01]},
+                                {fx[k10], fx[k11], fxy[k10], fxy[k11]}};
+                            double CF[4][4];
+                            for(uint32_t a = 0; a < 4; ++a) {
+                                for(uint32_t b = 0; b < 4; ++b) {
+                                    CF[a][b] = 0.0;
+                                    for(uint32_t c = 0; c < 4; ++c) {
+                                        CF[a][b] += C[a][c]*F[c][b];
+                                    }
+                                }
+                            }
+                            double * A = &m_coefficients[(i + j*(Nx-1))*16];
+                            for(uint32_t a = 0; a < 4; ++a) {
+                                for(uint32_t b = 0; b < 4; ++b) {
+                                    double sum = 0.0;
+                                    for(uint32_t c = 0; c < 4; ++c) {
+                                        sum += CF[a][c]*C[b][c];
+                                    }
+                                    A[a*4 + b] = sum;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                /*! \brief Remove the coefficients. */
+                void clear() {
+                    m_coefficients.clear();
+                    m_Nx = 0;
+                    m_Ny = 0;
+                }
+
+                /*! \brief Check if the spline has been built. */
+                bool empty() const {
+                    return m_coefficients.empty();
+                }
+
+                /*! \brief Evaluate the spline at the point \f$(x,y)\f$. */
+                double evaluate(const double x, const double y) const {
+                    double f, fx, fy;
+                    evaluate(x, y, f, fx, fy);
+                    return f;
+                }
+
+                /*! \brief Evaluate the spline and its gradient at the point \f$(x,y)\f$. */
+                void evaluate(const double x, const double y, double & f, double & fx, double & fy) const {
+                    evaluate_scalar(*this, &x, &y, 1, &f, &fx, &fy);
+                }
+
+                /*! \brief Evaluate the spline at N points
+                 *
+                 * This function evaluates the spline at the points \f$(x_i,y_i)\f$ and writes the values to f.
+                 * If fx and fy are not null, the partial derivatives are written to them.
+                 */
+                void evaluate(const double * x, const double * y, const uint32_t N, double * f, double * fx = 0, double * fy = 0) const {
+                    m_kernel(*this, x, y, N, f, fx, fy);
+                }
+
+                /*! \brief Get the name of the instruction set used for batches. */
+                std::string get_instruction_set() const {
+                    return m_instructionSet;
+                }
+
+            protected:
+                /*! \brief Calculate the derivative of the cubic spline through n equidistant values
+                 *
+                 * This function calculates the first derivative, in units of the grid spacing, at the grid points of the cubic spline
+                 * through f[0], f[stride], ..., f[(n-1)*stride] with not-a-knot end conditions, and writes it with the same stride to d.
+                 * The second derivatives \f$M_i\f$ are found from the tridiagonal system \f$M_{i-1} + 4 M_i + M_{i+1} = 6 (f_{i+1} - 2 f_i + f_{i-1})\f$,
+                 * in which \f$M_0 = 2 M_1 - M_2\f$ and \f$M_{n-1} = 2 M_{n-2} - M_{n-3}\f$ have been eliminated.
+                 */
+                static void derivative(const double * f, const uint32_t n, const uint32_t stride, double * d) {
+                    std::vector<double> M(n), c(n);
+                    for(uint32_t i = 1; i + 1 < n; ++i) {
+                        M[i] = 6.0*(f[(i+1)*stride] - 2.0*f[i*stride] + f[(i-1)*stride]);
+                    }
+                    for(uint32_t i = 1; i + 1 < n; ++i) {
+                        bool end = (i == 1 || i == n-2);
+                        double lower = end ? 0.0 : 1.0;
+                        double diagonal = end ? 6.0 : 4.0;
+                        double upper = end ? 0.0 : 1.0;
+                        if(i > 1) {
+                            diagonal -= lower*c[i-1];
+                            M[i] -= lower*M[i-1];
+                        }
+                        c[i] = upper/diagonal;
+                        M[i] /= diagonal;
+                    }
+                    for(uint32_t i = n-3; i >= 1; --i) {
+                        M[i] -= c[i]*M[i+1];
+                    }
+                    M[0] = 2.0*M[1] - M[2];
+                    M[n-1] = 2.0*M[n-2] - M[n-3];
+                    for(uint32_t i = 0; i + 1 < n; ++i) {
+                        d[i*stride] = (f[(i+1)*stride] - f[i*stride]) - (2.0*M[i] + M[i+1])/6.0;
+                    }
+                    d[(n-1)*stride] = (f[(n-1)*stride] - f[(n-2)*stride]) + (M[n-2] + 2.0*M[n-1])/6.0;
+                }
+
+                /*! \brief Scalar evaluation kernel
+                 *
+                 * This kernel evaluates one point at a time.
+                 */
+                static void evaluate_scalar(const bicubicSpline & spline, const double * x, const double * y, const uint32_t N,
+                    double * f, double * fx, double * fy) {
+                    for(uint32_t k = 0; k < N; ++k) {
+                        double X = (x[k] - spline.m_x0)*spline.m_invdx;
+                        double Y = (y[k] - spline.m_y0)*spline.m_invdy;
+                        if(spline.m_coefficients.empty() || !(X >= 0.0) || !(Y >= 0.0) || (X > spline.m_Nx - 1) || (Y > spline.m_Ny - 1)) {
+                            f[k] = 0.0;
+                            if(fx) fx[k] = 0.0;
+                            if(fy) fy[k] = 0.0;
+                            continue;
+                        }
+                        int32_t i = X;
+                        int32_t j = Y;
+                        if(i > (int32_t)spline.m_Nx - 2) i = spline.m_Nx - 2;
+                        if(j > (int32_t)spline.m_Ny - 2) j = spline.m_Ny - 2;
+                        double t = X - i;
+                        double u = Y - j;
+                        const double * A = &spline.m_coefficients[(i + j*(spline.m_Nx-1))*16];
+                        double c[4], d[4];
+                        for(uint32_t a = 0; a < 4; ++a) {
+                            c[a] = ((A[a*4+3]*u + A[a*4+2])*u + A[a*4+1])*u + A[a*4];
+                            d[a] = (3.0*A[a*4+3]*u + 2.0*A[a*4+2])*u + A[a*4+1];
+                        }
+                        f[k] = ((c[3]*t + c[2])*t + c[1])*t + c[0];
+                        if(fx) fx[k] = ((3.0*c[3]*t + 2.0*c[2])*t + c[1])*spline.m_invdx;
+                        if(fy) fy[k] = (((d[3]*t + d[2])*t + d[1])*t + d[0])*spline.m_invdy;
+                    }
+                }
+
+#ifdef WALLLOAD_SIMD
+                /*! \brief AVX2 evaluation kernel
+                 *
+                 * This kernel evaluates four points at a time and gathers the coefficients of their cells.
+                 * The gathers are masked with all lanes set, so they have a defined source register.
+                 * Fused multiply-add is not used, so the results are identical to the scalar kernel.
+                 */
+                __attribute__((target("avx2"), optimize("fp-contract=off")))
+                static void evaluate_avx2(const bicubicSpline & spline, const double * x, const double * y, const uint32_t N,
+                    double * f, double * fx, double * fy) {
+                    if(spline.m_coefficients.empty()) {
+                        evaluate_scalar(spline, x, y, N, f, fx, fy);
+                        return;
+                    }
+                    const __m256d x0 = _mm256_set1_pd(spline.m_x0);
+                    const __m256d y0 = _mm256_set1_pd(spline.m_y0);
+                    const __m256d invdx = _mm256_set1_pd(spline.m_invdx);
+                    const __m256d invdy = _mm256_set1_pd(spline.m_invdy);
+                    const __m256d zero = _mm256_setzero_pd();
+                    const __m256d two = _mm256_set1_pd(2.0);
+                    const __m256d three = _mm256_set1_pd(3.0);
+                    const __m256d xMax = _mm256_set1_pd(spline.m_Nx - 1);
+                    const __m256d yMax = _mm256_set1_pd(spline.m_Ny - 1);
+                    const __m128i iMax = _mm_set1_epi32(spline.m_Nx - 2);
+                    const __m128i jMax = _mm_set1_epi32(spline.m_Ny - 2);
+                    const __m128i rowLength = _mm_set1_epi32(spline.m_Nx - 1);
+                    const __m256d gatherAll = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+                    const double * coefficients = spline.m_coefficients.data();
+                    uint32_t k = 0;
+                    for( ; k + 4 <= N; k += 4) {
+                        __m256d X = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + k), x0), invdx);
+                        __m256d Y = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(y + k), y0), invdy);
+                        __m256d inside = _mm256_and_pd(
+                            _mm256_and_pd(_mm256_cmp_pd(X, zero, _CMP_GE_OQ), _mm256_cmp_pd(Y, zero, _CMP_GE_OQ)),
+                            _mm256_and_pd(_mm256_cmp_pd(X, xMax, _CMP_LE_OQ), _mm256_cmp_pd(Y, yMax, _CMP_LE_OQ)));
+                        __m128i i = _mm_min_epi32(_mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(X, zero), xMax)), iMax);
+                        __m128i j = _mm_min_epi32(_mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(Y, zero), yMax)), jMax);
+                        __m256d t = _mm256_sub_pd(X, _mm256_cvtepi32_pd(i));
+                        __m256d u = _mm256_sub_pd(Y, _mm256_cvtepi32_pd(j));
+                        __m128i offset = _mm_slli_epi32(_mm_add_epi32(i, _mm_mullo_epi32(j, rowLength)), 4);
+                        __m256d c[4], d[4];
+                        for(uint32_t a = 0; a < 4; ++a) {
+                            __m256d A0 = _mm256_mask_i32gather_pd(zero, coefficients + a*4, offset, gatherAll, 8);
+                            __m256d A1 = _mm256_mask_i32gather_pd(zero, coefficients + a*4 + 1, offset, gatherAll, 8);
+                            __m256d A2 = _mm256_mask_i32gather_pd(zero, coefficients + a*4 + 2, offset, gatherAll, 8);
+                            __m256d A3 = _mm256_mask_i32gather_pd(zero, coefficients + a*4 + 3, offset, gatherAll, 8);
+                            c[a] = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(A3, u), A2), u), A1), u), A0);
+                            d[a] = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(three, A3), u), _mm256_mul_pd(two, A2)), u), A1);
+                        }
+                        __m256d value = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(c[3], t), c[2]), t), c[1]), t), c[0]);
+                        _mm256_storeu_pd(f + k, _mm256_and_pd(inside, value));
+                        if(fx) {
+                            __m256d gradient = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(three, c[3]), t), _mm256_mul_pd(two, c[2])), t), c[1]);
+                            _mm256_storeu_pd(fx + k, _mm256_and_pd(inside, _mm256_mul_pd(gradient, invdx)));
+                        }
+                        if(fy) {
+                            __m256d gradient = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(d[3], t), d[2]), t), d[1]), t), d[0]);
+                            _mm256_storeu_pd(fy + k, _mm256_and_pd(inside, _mm256_mul_pd(gradient, invdy)));
+                        }
+                    }
+                    evaluate_scalar(spline, x + k, y + k, N - k, f + k, fx ? fx + k : 0, fy ? fy + k : 0);
+                }
+#endif
+
+                /*! \brief Select the evaluation kernel
+                 *
+                 * This function selects the AVX2 kernel if the processor supports it.
+                 */
+                void select_kernel() {
+#ifdef WALLLOAD_SIMD
+                    if(__builtin_cpu_supports("avx2")) {
+                        m_kernel = &evaluate_avx2;
+                        m_instructionSet = "avx2";
+                        return;
+                    }
+#endif
+                    m_kernel = &evaluate_scalar;
+                    m_instructionSet = "scalar";
+                }
+
+                uint32_t m_Nx; /*!< \brief Number of grid points in x direction. */
+                uint32_t m_Ny; /*!< \brief Number of grid points in y direction. */
+                double m_x0; /*!< \brief Smallest x value of the grid. */
+                double m_y0; /*!< \brief Smallest y value of the grid. */
+                double m_invdx; /*!< \brief Reciprocal grid spacing in x direction. */
+                double m_invdy; /*!< \brief Reciprocal grid spacing in y direction. */
+                std::vector<double> m_coefficients; /*!< \brief 16 polynomial coefficients per cell, \f$a_{mn}\f$ of \f$t^m u^n\f$ at index 16*cell + 4*m + n. */
+                kernel m_kernel; /*!< \brief Selected batch evaluation kernel. */
+                std::string m_instructionSet; /*!< \brief Name of the selected instruction set. */
+        };
+    }
+}
+
+#endif
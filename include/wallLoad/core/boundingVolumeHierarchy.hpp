@@ -0,0 +1,414 @@
+#ifndef include_wallLoad_core_boundingVolumeHierarchy_hpp
+#define include_wallLoad_core_boundingVolumeHierarchy_hpp
+
+#include <vector>
+#include <stdint.h>
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <wallLoad/core/vektor.hpp>
+#include <wallLoad/core/vertex.hpp>
+#include <wallLoad/core/hitResult.hpp>
+#include <wallLoad/core/triangleStore.hpp>
+#include <wallLoad/core/sharedArray.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Bounding volume hierarchy over the vertices of a mesh.
+         *
+         * This class stores a binary tree of axis aligned bounding boxes over a list of vertices.
+         * The tree is built with the surface area heuristic (SAH) and is used to find the closest hit of a ray
+         * without testing every vertex.
+         * The nodes are stored depth first, the left child of a node directly follows its parent.
+         */
+        class boundingVolumeHierarchy {
+            public:
+                /*! \brief Node of the hierarchy. */
+                struct node {
+                    double lower[3]; /*!< \brief Lower corner of the bounding box. */
+                    double upper[3]; /*!< \brief Upper corner of the bounding box. */
+                    uint32_t offset; /*!< \brief First primitive of a leaf or index of the right child of an inner node. */
+                    uint32_t count; /*!< \brief Number of primitives of a leaf, zero for inner nodes. */
+                };
+
+                /*! \brief Default constructor
+                 *
+                 * This constructor initializes an empty hierarchy.
+                 */
+                boundingVolumeHierarchy() : m_nodes(), m_indices() {}
+
+                /*! \brief Constructor
+                 *
+                 * This constructor builds the hierarchy over the given triangles.
+                 */
+                boundingVolumeHierarchy(const std::vector<double> & nodes, const std::vector<uint32_t> & triangles) : m_nodes(), m_indices() {
+                    build(nodes, triangles);
+                }
+
+                /*! \brief Build the hierarchy
+                 *
+                 * This function builds the hierarchy over the given triangles, which are three indices per triangle
+                 * into the node coordinates (three per node).
+                 * A previously built hierarchy is discarded.
+                 */
+                void build(const std::vector<double> & coordinates, const std::vector<uint32_t> & triangles) {
+                    clear();
+                    if(triangles.empty()) {
+                        return;
+                    }
+                    uint32_t N = triangles.size()/3;
+                    std::vector<primitive> primitives(N);
+                    for(uint32_t i = 0; i < N; ++i) {
+                        const double * p1 = &coordinates[3*triangles[3*i]];
+                        const double * p2 = &coordinates[3*triangles[3*i + 1]];
+                        const double * p3 = &coordinates[3*triangles[3*i + 2]];
+                        primitive & prim = primitives[i];
+                        for(uint32_t k = 0; k < 3; ++k) {
+                            prim.lower[k] = std::min(std::min(p1[k], p2[k]), p3[k]);
+                            prim.upper[k] = std::max(std::max(p1[k], p2[k]), p3[k]);
+                            prim.center[k] = 0.5*(prim.lower[k] + prim.upper[k]);
+                        }
+                    }
+                    std::vector<node> nodes;
+                    std::vector<uint32_t> indices(N);
+                    for(uint32_t i = 0; i < N; ++i) {
+                        indices[i] = i;
+                    }
+                    nodes.reserve(2*N/s_maxLeafSize + 1);
+                    build_node(primitives, nodes, indices, 0, N, 0);
+                    pad_boxes(nodes);
+                    assign(sharedArray<node>(std::move(nodes)), sharedArray<uint32_t>(std::move(indices)));
+                }
+
+                /*! \brief Use an existing hierarchy
+                 *
+                 * This function uses the given nodes and vertex indices, e.g. from a mesh cache, without copying them.
+                 */
+                void assign(const sharedArray<node> & nodes, const sharedArray<uint32_t> & indices) {
+                    m_nodes = nodes;
+                    m_indices = indices;
+                }
+
+                /*! \brief Remove all nodes from the hierarchy. */
+                void clear() {
+                    m_nodes.clear();
+                    m_indices.clear();
+                }
+
+                /*! \brief Check if the hierarchy is empty. */
+                bool empty() const {
+                    return m_nodes.empty();
+                }
+
+                /*! \brief Get the nodes of the hierarchy. */
+                const sharedArray<node> & get_nodes() const {
+                    return m_nodes;
+                }
+
+                /*! \brief Get the vertex indices in leaf order. */
+                const sharedArray<uint32_t> & get_indices() const {
+                    return m_indices;
+                }
+
+                /*! \brief Get the maximum depth of the hierarchy, the root having the depth zero. */
+                static uint32_t get_max_depth() {
+                    return s_maxDepth - 1;
+                }
+
+                /*! \brief Calculate the hit point of the ray
+                 *
+                 * This function traverses the hierarchy and returns the hit closest to the origin of the ray.
+                 * Vertices and boxes further away than the closest hit found so far are rejected early.
+                 * If several vertices are hit at the same distance the vertex with the lowest index is returned,
+                 * so the result is identical to testing every vertex in order.
+                 * No memory is allocated on the heap.
+                 * \param triangles The vertices the hierarchy was built for, stored in the order of get_indices().
+                 * \param origin Position from where the ray originates.
+                 * \param direction The direction in which the ray travels.
+                 */
+                hitResult evaluateHit(const triangleStore & triangles, const vektor & origin, const vektor & direction) const {
+                    double t;
+                    int32_t closest = evaluate_closest(triangles, origin, direction, t);
+                    if(closest < 0) {
+                        return hitResult();
+                    }
+                    hitResult output(true, origin + t*direction);
+                    output.element = closest;
+                    return output;
+                }
+
+                /*! \brief Calculate the closest hit of the ray
+                 *
+                 * This function does the same as evaluateHit(), but returns the ray parameter instead of the hit point.
+                 * \param triangles The vertices the hierarchy was built for, stored in the order of get_indices().
+                 * \param origin Position from where the ray originates.
+                 * \param direction The direction in which the ray travels.
+                 * \param t Ray parameter of the hit, the hit point is origin + t*direction. Infinity if nothing is hit.
+                 * \return Index of the vertex that got hit, -1 if nothing is hit.
+                 */
+                int32_t evaluate_closest(const triangleStore & triangles, const vektor & origin, const vektor & direction, double & t) const {
+                    t = std::numeric_limits<double>::infinity();
+                    int32_t closest = -1;
+                    evaluate_closest(triangles, origin, direction, t, closest);
+                    return closest;
+                }
+
+                /*! \brief Improve the closest hit of the ray
+                 *
+                 * This function searches for a hit which is closer than the given one, or as close and with a lower vertex index,
+                 * and replaces tClosest and closest by it.
+                 * Subtrees behind tClosest are skipped, so a hit found before, e.g. in another copy of the mesh, prunes the search.
+                 */
+                void evaluate_closest(const triangleStore & triangles, const vektor & origin, const vektor & direction,
+                    double & tClosest, int32_t & closest) const {
+                    if(m_nodes.empty()) {
+                        return;
+                    }
+                    double invDirection[3] = {1.0/direction.x, 1.0/direction.y, 1.0/direction.z};
+                    double start[3] = {origin.x, origin.y, origin.z};
+                    if(intersect_box(m_nodes[0], start, invDirection) > tClosest) {
+                        return;
+                    }
+                    uint32_t stack[s_maxDepth];
+                    double stackDistance[s_maxDepth];
+                    uint32_t stackSize = 0;
+                    uint32_t current = 0;
+                    while(true) {
+                        const node & currentNode = m_nodes[current];
+                        if(currentNode.count > 0) {
+                            triangles.intersect(currentNode.offset, currentNode.offset + currentNode.count, origin, direction, tClosest, closest);
+                        }
+                        else {
+                            uint32_t left = current + 1;
+                            uint32_t right = currentNode.offset;
+                            double tLeft = intersect_box(m_nodes[left], start, invDirection);
+                            double tRight = intersect_box(m_nodes[right], start, invDirection);
+                            bool hitLeft = tLeft <= tClosest && tLeft != std::numeric_limits<double>::infinity();
+                            bool hitRight = tRight <= tClosest && tRight != std::numeric_limits<double>::infinity();
+                            if(hitLeft && hitRight) {
+                                if(tRight < tLeft) {
+                                    std::swap(left, right);
+                                    std::swap(tLeft, tRight);
+                                }
+                                stack[stackSize] = right;
+                                stackDistance[stackSize] = tRight;
+                                ++stackSize;
+                                current = left;
+                                continue;
+                            }
+                            if(hitLeft) {
+                                current = left;
+                                continue;
+                            }
+                            if(hitRight) {
+                                current = right;
+                                continue;
+                            }
+                        }
+                        do {
+                            if(stackSize == 0) {
+                                current = m_nodes.size();
+                                break;
+                            }
+                            --stackSize;
+                            current = stack[stackSize];
+                        } while(stackDistance[stackSize] > tClosest);
+                        if(current == m_nodes.size()) {
+                            break;
+                        }
+                    }
+                }
+
+            protected:
+                /*! \brief Bounding box and center of a single vertex used during the build. */
+                struct primitive {
+                    double lower[3]; /*!< \brief Lower corner of the bounding box. */
+                    double upper[3]; /*!< \brief Upper corner of the bounding box. */
+                    double center[3]; /*!< \brief Center of the bounding box. */
+                };
+
+                /*! \brief Bin of the surface area heuristic. */
+                struct bin {
+                    double lower[3]; /*!< \brief Lower corner of the bounding box. */
+                    double upper[3]; /*!< \brief Upper corner of the bounding box. */
+                    uint32_t count; /*!< \brief Number of primitives in the bin. */
+                };
+
+                /*! \brief Reset a box to the empty box. */
+                static void reset_box(double * lower, double * upper) {
+                    for(uint32_t k = 0; k < 3; ++k) {
+                        lower[k] = std::numeric_limits<double>::infinity();
+                        upper[k] = -std::numeric_limits<double>::infinity();
+                    }
+                }
+
+                /*! \brief Extend a box by another box. */
+                static void grow_box(double * lower, double * upper, const double * otherLower, const double * otherUpper) {
+                    for(uint32_t k = 0; k < 3; ++k) {
+                        lower[k] = std::min(lower[k], otherLower[k]);
+                        upper[k] = std::max(upper[k], otherUpper[k]);
+                    }
+                }
+
+                /*! \brief Calculate half the surface area of a box. */
+                static double get_half_area(const double * lower, const double * upper) {
+                    double dx = upper[0] - lower[0];
+                    double dy = upper[1] - lower[1];
+                    double dz = upper[2] - lower[2];
+                    if(dx < 0.0 || dy < 0.0 || dz < 0.0) {
+                        return 0.0;
+                    }
+                    return dx*dy + dy*dz + dz*dx;
+                }
+
+                /*! \brief Intersect a ray with the bounding box of a node.
+                 *
+                 * This function returns the parameter at which the ray enters the box.
+                 * If the box is missed infinity is returned.
+                 * Undefined slabs (origin on the slab plane and direction parallel) are ignored, which keeps the test conservative.
+                 */
+                static double intersect_box(const node & box, const double * start, const double * invDirection) {
+                    double tNear = 0.0;
+                    double tFar = std::numeric_limits<double>::infinity();
+                    for(uint32_t k = 0; k < 3; ++k) {
+                        double t0 = (box.lower[k] - start[k])*invDirection[k];
+                        double t1 = (box.upper[k] - start[k])*invDirection[k];
+                        if(t0 > t1) {
+                            std::swap(t0, t1);
+                        }
+                        if(t0 > tNear) {
+                            tNear = t0;
+                        }
+                        if(t1 < tFar) {
+                            tFar = t1;
+                        }
+                    }
+                    if(tNear > tFar) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    return tNear;
+                }
+
+                /*! \brief Build a node of the hierarchy.
+                 *
+                 * This function creates the node for the primitives in the index range [first, last[ and recursively splits it
+                 * at the position with the lowest surface area heuristic cost.
+                 */
+                void build_node(const std::vector<primitive> & primitives, std::vector<node> & nodes, std::vector<uint32_t> & indices,
+                    const uint32_t first, const uint32_t last, const uint32_t depth) {
+                    uint32_t current = nodes.size();
+                    nodes.push_back(node());
+                    node & box = nodes.back();
+                    double centerLower[3], centerUpper[3];
+                    reset_box(box.lower, box.upper);
+                    reset_box(centerLower, centerUpper);
+                    for(uint32_t i = first; i < last; ++i) {
+                        const primitive & prim = primitives[indices[i]];
+                        grow_box(box.lower, box.upper, prim.lower, prim.upper);
+                        grow_box(centerLower, centerUpper, prim.center, prim.center);
+                    }
+                    uint32_t N = last - first;
+                    box.offset = first;
+                    box.count = N;
+                    if(N <= 1 || depth + 1 >= s_maxDepth) {
+                        return;
+                    }
+
+                    double bestCost = std::numeric_limits<double>::infinity();
+                    uint32_t bestAxis = 0;
+                    uint32_t bestSplit = 0;
+                    bin bins[s_nBins];
+                    double rightArea[s_nBins];
+                    uint32_t rightCount[s_nBins];
+                    for(uint32_t axis = 0; axis < 3; ++axis) {
+                        double extent = centerUpper[axis] - centerLower[axis];
+                        if(extent <= 0.0) {
+                            continue;
+                        }
+                        double scale = s_nBins/extent;
+                        for(uint32_t b = 0; b < s_nBins; ++b) {
+                            reset_box(bins[b].lower, bins[b].upper);
+                            bins[b].count = 0;
+                        }
+                        for(uint32_t i = first; i < last; ++i) {
+                            const primitive & prim = primitives[indices[i]];
+                            uint32_t b = std::min(s_nBins - 1, (uint32_t)((prim.center[axis] - centerLower[axis])*scale));
+                            grow_box(bins[b].lower, bins[b].upper, prim.lower, prim.upper);
+                            ++bins[b].count;
+                        }
+                        double lower[3], upper[3];
+                        uint32_t count = 0;
+                        reset_box(lower, upper);
+                        for(uint32_t b = s_nBins - 1; b > 0; --b) {
+                            grow_box(lower, upper, bins[b].lower, bins[b].upper);
+                            count += bins[b].count;
+                            rightArea[b] = get_half_area(lower, upper);
+                            rightCount[b] = count;
+                        }
+                        count = 0;
+                        reset_box(lower, upper);
+                        for(uint32_t b = 0; b < s_nBins - 1; ++b) {
+                            grow_box(lower, upper, bins[b].lower, bins[b].upper);
+                            count += bins[b].count;
+                            if(count == 0 || rightCount[b+1] == 0) {
+                                continue;
+                            }
+                            double cost = get_half_area(lower, upper)*count + rightArea[b+1]*rightCount[b+1];
+                            if(cost < bestCost) {
+                                bestCost = cost;
+                                bestAxis = axis;
+                                bestSplit = b;
+                            }
+                        }
+                    }
+                    double leafCost = get_half_area(box.lower, box.upper)*(N - s_traversalCost);
+                    if(bestCost == std::numeric_limits<double>::infinity() || (N <= s_maxLeafSize && bestCost >= leafCost)) {
+                        return;
+                    }
+
+                    double scale = s_nBins/(centerUpper[bestAxis] - centerLower[bestAxis]);
+                    double offset = centerLower[bestAxis];
+                    uint32_t * middle = std::partition(&indices[first], &indices[0] + last,
+                        [&](const uint32_t index) {
+                            uint32_t b = std::min(s_nBins - 1, (uint32_t)((primitives[index].center[bestAxis] - offset)*scale));
+                            return b <= bestSplit;
+                        });
+                    uint32_t split = middle - &indices[0];
+                    nodes[current].count = 0;
+                    build_node(primitives, nodes, indices, first, split, depth + 1);
+                    nodes[current].offset = nodes.size();
+                    build_node(primitives, nodes, indices, split, last, depth + 1);
+                }
+
+                /*! \brief Enlarge all boxes slightly.
+                 *
+                 * The boxes are enlarged by a small fraction of the scene size,
+                 * so that rounding errors in the box test never discard a vertex which is hit.
+                 */
+                static void pad_boxes(std::vector<node> & nodes) {
+                    double size = 0.0;
+                    for(uint32_t k = 0; k < 3; ++k) {
+                        size = std::max(size, std::max(fabs(nodes[0].lower[k]), fabs(nodes[0].upper[k])));
+                    }
+                    double padding = size*s_tolerance + std::numeric_limits<double>::min();
+                    for(std::vector<node>::iterator iter = nodes.begin(); iter != nodes.end(); ++iter) {
+                        for(uint32_t k = 0; k < 3; ++k) {
+                            iter->lower[k] -= padding;
+                            iter->upper[k] += padding;
+                        }
+                    }
+                }
+
+                static const uint32_t s_nBins = 16; /*!< \brief Number of bins for the surface area heuristic. */
+                static const uint32_t s_maxLeafSize = 16; /*!< \brief Largest leaf which is kept if splitting does not pay off. */
+                static const uint32_t s_maxDepth = 64; /*!< \brief Maximum depth of the hierarchy. */
+                static constexpr double s_traversalCost = 4.0; /*!< \brief Cost of descending into a node relative to a vertex test in the vectorized kernels. */
+                static constexpr double s_tolerance = 1e-9; /*!< \brief Relative tolerance of the box tests. */
+
+                sharedArray<node> m_nodes; /*!< \brief Nodes of the hierarchy. */
+                sharedArray<uint32_t> m_indices; /*!< \brief Indices of the vertices in leaf order. */
+        };
+    }
+}
+
+#endif
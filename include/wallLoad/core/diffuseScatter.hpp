@@ -4,7 +4,7 @@
 #include <boost/python.hpp>
 #include <wallLoad/core/vektor.hpp>
 #include <boost/random.hpp>
-#include <time.h>
+#include <wallLoad/core/philox.hpp>
 #include <boost/math/constants/constants.hpp>
 #include <math.h>
 
@@ -18,12 +18,22 @@ namespace wallLoad {
             public:
                 /*! \brief Constructor */
                 diffuseScatter() :
-                    m_generator(time(0)),
-                    m_one(),
+                    m_generator(philox::default_seed, scatterStream),
                     m_2pi_distribution(0, 2.0*boost::math::constants::pi<double>()) {
                     }
-                /*! \brief Destructor */
-                virtual ~diffuseScatter() {}
+
+                /*! \brief Set the seed of the random number generator
+                 *
+                 * This function restarts the random number stream of the instance with the given seed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    m_generator.seed(seed, scatterStream);
+                }
+
+                /*! \brief Get the seed of the random number generator. */
+                uint64_t get_seed() const {
+                    return m_generator.get_seed();
+                }
 
                 /*! \brief Generate random direction vector.
                  *
@@ -31,16 +41,33 @@ namespace wallLoad {
                  * \param normal Normal vector of the surface the ray is scattered on.
                  */
                 vektor get_direction(const vektor & normal) {
-                    double alpha = m_2pi_distribution(m_generator);
-                    double beta = asin(m_one(m_generator));
-                    vektor candidate(sin(beta)*cos(alpha), sin(beta)*sin(alpha), cos(beta));
+                    return get_direction(normal, m_generator);
+                }
 
-                    return candidate;
+                /*! \brief Generate random direction vector with the given random number generator.
+                 *
+                 * This function returns a random direction vector for diffuse scatter, distributed according to Lambert's
+                 * cosine law about the given unit normal vector, i.e. \f$\sin^2\beta\f$ is uniform for the angle \f$\beta\f$
+                 * to the normal.
+                 * It does not change the instance, so it can be called from several threads at once
+                 * as long as every thread uses its own generator.
+                 * \param normal Unit normal vector of the surface, pointing to the side the ray is scattered to.
+                 * \param generator Random number generator.
+                 */
+                template<class Generator>
+                vektor get_direction(const vektor & normal, Generator & generator) const {
+                    boost::random::uniform_01<double> uniform;
+                    double alpha = m_2pi_distribution(generator);
+                    double sinBeta = sqrt(uniform(generator));
+                    double cosBeta = sqrt(1.0 - sinBeta*sinBeta);
+                    vektor tangent = fabs(normal.x) < 0.9 ? vektor(1.0, 0.0, 0.0) : vektor(0.0, 1.0, 0.0);
+                    vektor u = normal.get_cross_product(tangent).get_normalized();
+                    vektor v = normal.get_cross_product(u);
+                    return sinBeta*cos(alpha)*u + sinBeta*sin(alpha)*v + cosBeta*normal;
                 }
 
             protected:
-                boost::random::mt19937 m_generator; /*!< \brief Random number generator */
-                boost::random::uniform_01<double> m_one; /*!< \brief Random uniform distribution \f$[0,1[\f$. */
+                philox m_generator; /*!< \brief Random number generator */
                 boost::random::uniform_real_distribution<double> m_2pi_distribution; /*!< \brief Random number distribution \f$[0,2\pi[\f$. */
 
         };
@@ -2,18 +2,28 @@
 #define include_wallLoad_core_directionGenerator_hpp
 
 #include <boost/python.hpp>
-#include <time.h>
 #include <math.h>
-#include <boost/random.hpp>
-#include <boost/math/constants/constants.hpp>
+#include <string>
+#include <stdint.h>
 #include <wallLoad/core/vektor.hpp>
+#include <wallLoad/core/philox.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(WALLLOAD_NO_SIMD)
+#define WALLLOAD_SIMD
+#include <immintrin.h>
+#endif
 
 namespace wallLoad {
     namespace core {
         /*! \brief Class to generate random direction vectors.
          *
-         * This class generates random direction vectors.
+         * This class generates isotropic random direction vectors, i.e. uniformly distributed on the unit sphere.
          * It is intended for the Monte Carlo approach to calculate the wall load.
+         * Every direction is made from one block of four 32 bit random numbers: two of them give \f$u\f$,
+         * the other two give \f$v\f$, both uniform in \f$[0,1[\f$ with 53 bits.
+         * The polar angle follows from \f$\cos\theta = 1 - 2u\f$, the azimuth is \f$\varphi = 2\pi v\f$.
+         * The sine and cosine of the azimuth are evaluated with a polynomial in plain arithmetic,
+         * so the batch kernels give the same directions as the scalar generate().
          */
         class directionGenerator {
             public:
@@ -21,20 +31,64 @@ namespace wallLoad {
                  *
                  * This constructor initializes the random number generator.
                  */
-                directionGenerator() : 
-                    m_generator(time(0)),
-                    m_2pi_distribution(0.0, 2.0*boost::math::constants::pi<double>()), 
-                    m_pi_distribution(0.0, boost::math::constants::pi<double>()) {
+                directionGenerator() :
+                    m_generator(philox::default_seed, directionStream),
+                    m_kernel(&generate_scalar), m_instructionSet("scalar") {
+                    select_kernel();
+                }
+
+                /*! \brief Set the seed of the random number generator
+                 *
+                 * This function restarts the random number stream of the instance with the given seed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    m_generator.seed(seed, directionStream);
+                }
+
+                /*! \brief Get the seed of the random number generator. */
+                uint64_t get_seed() const {
+                    return m_generator.get_seed();
+                }
+
+                /*! \brief Get the instruction set used by the batch generation. */
+                std::string get_instruction_set() const {
+                    return m_instructionSet;
                 }
-                /*! \brief Destructor. */
-                virtual ~directionGenerator() {}
 
                 /*! \brief Generate random direction vector. */
                 inline vektor generate() {
-                    double alpha = m_2pi_distribution(m_generator);
-                    double beta = m_pi_distribution(m_generator);
-                    return vektor(sin(beta)*cos(alpha), sin(beta)*sin(alpha), cos(beta));
+                    return generate(m_generator);
+                }
+
+                /*! \brief Generate random direction vector with the given random number generator.
+                 *
+                 * This function draws four 32 bit random numbers from the generator.
+                 * It does not change the instance, so it can be called from several threads at once
+                 * as long as every thread uses its own generator.
+                 */
+                template<class Generator>
+                inline vektor generate(Generator & generator) const {
+                    uint32_t w0 = generator();
+                    uint32_t w1 = generator();
+                    uint32_t w2 = generator();
+                    uint32_t w3 = generator();
+                    double x, y, z;
+                    to_direction(w0, w1, w2, w3, x, y, z);
+                    return vektor(x, y, z);
                 }
+
+                /*! \brief Get the direction for the given point of the unit square
+                 *
+                 * This function maps \f$(u,v) \in [0,1[^2\f$ to the direction with \f$\cos\theta = 1 - 2u\f$ and \f$\varphi = 2\pi v\f$,
+                 * so uniformly distributed points give isotropic directions.
+                 * It is used to make directions from quasi-random points.
+                 */
+                static vektor get_direction(const double u, const double v) {
+                    double x, y, z;
+                    to_direction(u, v, x, y, z);
+                    return vektor(x, y, z);
+                }
+
                 /*! \brief Generate N random direction vectors. */
                 inline std::vector<vektor> generate(const uint32_t N) {
                     std::vector<vektor> output;
@@ -44,8 +98,20 @@ namespace wallLoad {
                     return output;
                 }
 
-                /*! \brief Generate N random direction vectors as python list. 
-                 * 
+                /*! \brief Generate the directions of a range of samples
+                 *
+                 * This function writes the directions of the samples first, ..., first + N - 1 as structure of arrays
+                 * to x, y and z.
+                 * The direction of sample i is the one generate() returns for a philox generator seeded with
+                 * (seed, directionStream, i), but the samples are generated several at a time with the widest
+                 * instruction set supported by the processor.
+                 */
+                void generate(const uint64_t seed, const uint64_t first, const uint64_t N, double * x, double * y, double * z) const {
+                    m_kernel(seed, first, N, x, y, z);
+                }
+
+                /*! \brief Generate N random direction vectors as python list.
+                 *
                  * This function returns N random direction vectors as python list.
                  * This function is intended as python interface.
                  * Do not use this function from within C++.
@@ -59,11 +125,165 @@ namespace wallLoad {
                     return list;
                 }
             protected:
-                boost::random::mt19937 m_generator; /*!< \brief Random number generator. */
-                boost::random::uniform_real_distribution<double> m_2pi_distribution; /*!< \brief Random uniform distribution \f$[0,2\pi[\f$. */
-                boost::random::uniform_real_distribution<double> m_pi_distribution; /*!< \brief Random uniform distribution \f$[0,\pi[\f$. */
-        };    
+                /*! \brief Signature of the batch kernels. */
+                typedef void (*kernel)(const uint64_t, const uint64_t, const uint64_t, double *, double *, double *);
+
+                /*! \brief Make a direction from a block of four random numbers.
+                 *
+                 * The first two numbers give \f$u\f$, the other two \f$v\f$, each with 53 bits.
+                 */
+                __attribute__((optimize("fp-contract=off")))
+                static void to_direction(const uint32_t w0, const uint32_t w1, const uint32_t w2, const uint32_t w3,
+                    double & x, double & y, double & z) {
+                    double u = ((double)(w0 >> 5)*s_2pow26 + (double)(w1 >> 6))*s_2powm53;
+                    double v = ((double)(w2 >> 5)*s_2pow26 + (double)(w3 >> 6))*s_2powm53;
+                    to_direction(u, v, x, y, z);
+                }
+
+                /*! \brief Make a direction from a point of the unit square.
+                 *
+                 * The azimuth \f$2\pi v\f$ is reduced to \f$r \in [-\pi/4,\pi/4]\f$ around the nearest quarter turn,
+                 * where sine and cosine are given by their Taylor series up to \f$r^{17}\f$ and \f$r^{18}\f$.
+                 */
+                __attribute__((optimize("fp-contract=off")))
+                static void to_direction(const double u, const double v, double & x, double & y, double & z) {
+                    double q = floor(4.0*v + 0.5);
+                    double r = (v - 0.25*q)*s_2pi;
+                    double r2 = r*r;
+                    double s = r*(1.0 + r2*(s_sin[0] + r2*(s_sin[1] + r2*(s_sin[2] + r2*(s_sin[3] + r2*(s_sin[4] + r2*(s_sin[5] + r2*(s_sin[6] + r2*s_sin[7]))))))));
+                    double c = 1.0 + r2*(s_cos[0] + r2*(s_cos[1] + r2*(s_cos[2] + r2*(s_cos[3] + r2*(s_cos[4] + r2*(s_cos[5] + r2*(s_cos[6] + r2*(s_cos[7] + r2*s_cos[8]))))))));
+                    double sinPhi, cosPhi;
+                    switch((uint32_t)q & 3) {
+                        case 0: sinPhi = s; cosPhi = c; break;
+                        case 1: sinPhi = c; cosPhi = -s; break;
+                        case 2: sinPhi = -s; cosPhi = -c; break;
+                        default: sinPhi = -c; cosPhi = s; break;
+                    }
+                    double sinTheta = 2.0*sqrt(u*(1.0 - u));
+                    x = sinTheta*cosPhi;
+                    y = sinTheta*sinPhi;
+                    z = 1.0 - 2.0*u;
+                }
+
+                /*! \brief Scalar batch kernel */
+                static void generate_scalar(const uint64_t seed, const uint64_t first, const uint64_t N, double * x, double * y, double * z) {
+                    philox generator;
+                    for(uint64_t i = 0; i < N; ++i) {
+                        generator.seed(seed, directionStream, first + i);
+                        uint32_t w0 = generator();
+                        uint32_t w1 = generator();
+                        uint32_t w2 = generator();
+                        uint32_t w3 = generator();
+                        to_direction(w0, w1, w2, w3, x[i], y[i], z[i]);
+                    }
+                }
+
+#ifdef WALLLOAD_SIMD
+                /*! \brief Convert integers below \f$2^{52}\f$ in the 64 bit lanes to double. */
+                __attribute__((target("avx2")))
+                static __m256d to_double_avx2(const __m256i value) {
+                    const __m256d magic = _mm256_set1_pd(4503599627370496.0);
+                    return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(value, _mm256_castpd_si256(magic))), magic);
+                }
+
+                /*! \brief AVX2 batch kernel
+                 *
+                 * This kernel runs four philox generators in the 64 bit lanes and makes four directions at a time.
+                 * Fused multiply-add is not used, so the results are identical to the scalar kernel.
+                 */
+                __attribute__((target("avx2"), optimize("fp-contract=off")))
+                static void generate_avx2(const uint64_t seed, const uint64_t first, const uint64_t N, double * x, double * y, double * z) {
+                    const __m256i low = _mm256_set1_epi64x(0xFFFFFFFFll);
+                    const __m256i M0 = _mm256_set1_epi64x(0xD2511F53ll);
+                    const __m256i M1 = _mm256_set1_epi64x(0xCD9E8D57ll);
+                    const __m256d two26 = _mm256_set1_pd(s_2pow26);
+                    const __m256d twom53 = _mm256_set1_pd(s_2powm53);
+                    const __m256d one = _mm256_set1_pd(1.0);
+                    const __m256d two = _mm256_set1_pd(2.0);
+                    const __m256d half = _mm256_set1_pd(0.5);
+                    const __m256d quarter = _mm256_set1_pd(0.25);
+                    const __m256d four = _mm256_set1_pd(4.0);
+                    const __m256d twoPi = _mm256_set1_pd(s_2pi);
+                    const __m256d signBit = _mm256_set1_pd(-0.0);
+                    uint64_t i = 0;
+                    for( ; i + 4 <= N; i += 4) {
+                        uint64_t sample = first + i;
+                        __m256i c0 = _mm256_setzero_si256();
+                        __m256i c1 = _mm256_set1_epi64x(directionStream);
+                        __m256i c2 = _mm256_set_epi64x((uint32_t)(sample + 3), (uint32_t)(sample + 2), (uint32_t)(sample + 1), (uint32_t)sample);
+                        __m256i c3 = _mm256_set_epi64x((sample + 3) >> 32, (sample + 2) >> 32, (sample + 1) >> 32, sample >> 32);
+                        uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+                        for(uint32_t round = 0; round < 10; ++round) {
+                            __m256i product0 = _mm256_mul_epu32(M0, c0);
+                            __m256i product1 = _mm256_mul_epu32(M1, c2);
+                            c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), c1), _mm256_set1_epi64x(k0));
+                            c1 = _mm256_and_si256(product1, low);
+                            c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), c3), _mm256_set1_epi64x(k1));
+                            c3 = _mm256_and_si256(product0, low);
+                            k0 += 0x9E3779B9u;
+                            k1 += 0xBB67AE85u;
+                        }
+                        __m256d u = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(to_double_avx2(_mm256_srli_epi64(c0, 5)), two26),
+                            to_double_avx2(_mm256_srli_epi64(c1, 6))), twom53);
+                        __m256d v = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(to_double_avx2(_mm256_srli_epi64(c2, 5)), two26),
+                            to_double_avx2(_mm256_srli_epi64(c3, 6))), twom53);
+                        __m256d q = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(four, v), half));
+                        __m256d r = _mm256_mul_pd(_mm256_sub_pd(v, _mm256_mul_pd(quarter, q)), twoPi);
+                        __m256d r2 = _mm256_mul_pd(r, r);
+                        __m256d s = _mm256_set1_pd(s_sin[7]);
+                        for(int k = 6; k >= 0; --k) {
+                            s = _mm256_add_pd(_mm256_set1_pd(s_sin[k]), _mm256_mul_pd(r2, s));
+                        }
+                        s = _mm256_mul_pd(r, _mm256_add_pd(one, _mm256_mul_pd(r2, s)));
+                        __m256d c = _mm256_set1_pd(s_cos[8]);
+                        for(int k = 7; k >= 0; --k) {
+                            c = _mm256_add_pd(_mm256_set1_pd(s_cos[k]), _mm256_mul_pd(r2, c));
+                        }
+                        c = _mm256_add_pd(one, _mm256_mul_pd(r2, c));
+                        __m256d k = _mm256_sub_pd(q, _mm256_mul_pd(four, _mm256_floor_pd(_mm256_mul_pd(q, quarter))));
+                        __m256d odd = _mm256_or_pd(_mm256_cmp_pd(k, one, _CMP_EQ_OQ), _mm256_cmp_pd(k, _mm256_set1_pd(3.0), _CMP_EQ_OQ));
+                        __m256d negativeSin = _mm256_cmp_pd(k, two, _CMP_GE_OQ);
+                        __m256d negativeCos = _mm256_or_pd(_mm256_cmp_pd(k, one, _CMP_EQ_OQ), _mm256_cmp_pd(k, two, _CMP_EQ_OQ));
+                        __m256d sinPhi = _mm256_xor_pd(_mm256_blendv_pd(s, c, odd), _mm256_and_pd(negativeSin, signBit));
+                        __m256d cosPhi = _mm256_xor_pd(_mm256_blendv_pd(c, s, odd), _mm256_and_pd(negativeCos, signBit));
+                        __m256d sinTheta = _mm256_mul_pd(two, _mm256_sqrt_pd(_mm256_mul_pd(u, _mm256_sub_pd(one, u))));
+                        _mm256_storeu_pd(x + i, _mm256_mul_pd(sinTheta, cosPhi));
+                        _mm256_storeu_pd(y + i, _mm256_mul_pd(sinTheta, sinPhi));
+                        _mm256_storeu_pd(z + i, _mm256_sub_pd(one, _mm256_mul_pd(two, u)));
+                    }
+                    generate_scalar(seed, first + i, N - i, x + i, y + i, z + i);
+                }
+#endif
+
+                /*! \brief Select the batch kernel
+                 *
+                 * This function selects the widest instruction set supported by the processor.
+                 */
+                void select_kernel() {
+#ifdef WALLLOAD_SIMD
+                    if(__builtin_cpu_supports("avx2")) {
+                        m_kernel = &generate_avx2;
+                        m_instructionSet = "avx2";
+                        return;
+                    }
+#endif
+                    m_kernel = &generate_scalar;
+                    m_instructionSet = "scalar";
+                }
+
+                static constexpr double s_2pow26 = 67108864.0; /*!< \brief \f$2^{26}\f$ */
+                static constexpr double s_2powm53 = 1.0/9007199254740992.0; /*!< \brief \f$2^{-53}\f$ */
+                static constexpr double s_2pi = 6.283185307179586476925286766559; /*!< \brief \f$2\pi\f$ */
+                static constexpr double s_sin[8] = {-1.0/6.0, 1.0/120.0, -1.0/5040.0, 1.0/362880.0, -1.0/39916800.0,
+                    1.0/6227020800.0, -1.0/1307674368000.0, 1.0/355687428096000.0}; /*!< \brief Taylor coefficients of \f$\sin(r)/r - 1\f$ in \f$r^2\f$. */
+                static constexpr double s_cos[9] = {-1.0/2.0, 1.0/24.0, -1.0/720.0, 1.0/40320.0, -1.0/3628800.0,
+                    1.0/479001600.0, -1.0/87178291200.0, 1.0/20922789888000.0, -1.0/6402373705728000.0}; /*!< \brief Taylor coefficients of \f$\cos(r) - 1\f$ in \f$r^2\f$. */
+
+                philox m_generator; /*!< \brief Random number generator. */
+                kernel m_kernel; /*!< \brief Selected batch kernel. */
+                std::string m_instructionSet; /*!< \brief Name of the selected instruction set. */
+        };
     }
 }
 
-#endif 
+#endif
@@ -5,9 +5,14 @@
 #include <boost/python/numeric.hpp>
 #include <stdint.h>
 #include <string.h>
-#include <fstream>
 #include <math.h>
+#include <ctype.h>
 #include <algorithm>
+#include <vector>
+#include <stdexcept>
+#include <wallLoad/core/mappedFile.hpp>
+#include <wallLoad/core/textParser.hpp>
+#include <wallLoad/core/bicubicSpline.hpp>
 
 namespace wallLoad {
     namespace core {
@@ -20,97 +25,220 @@ namespace wallLoad {
                 /*! \brief Constructor
                  *
                  * This constructor reads the equilibrium from an eqdsk file.
+                 * The file is memory mapped and parsed with a textParser, so that the fixed width Fortran format
+                 * with numbers without separating white space is understood.
+                 * Besides the header and the poloidal flux matrix the profiles fpol, pres, ffprim, pprime and q
+                 * as well as the boundary and limiter contours are kept. The contours are optional.
+                 * A std::runtime_error with the position in the file is thrown if the file is malformed.
                  */
-                equilibrium(const std::string & filename) {
-                    std::ifstream file(filename.c_str(), std::ios::in);
-                    uint32_t temp;
-                    double dTemp;
-                    file >> m_comment >> temp >> m_NR >> m_Nz;
-                    m_R = new double[m_NR];
-                    m_z = new double[m_Nz];
-                    file >> m_rBoxLength >> m_zBoxLength >> m_r0Exp >> m_rBoxLeft >> m_zBoxMid;
-                    m_R = new double[m_NR];
-                    m_z = new double[m_Nz];
-                    m_psi = new double[m_NR*m_Nz];
-                    double dR = m_rBoxLength/(m_NR-1);
+                equilibrium(const std::string & filename) : m_useSpline(false), m_spline() {
+                    mappedFile file(filename);
+                    textParser parser(file.begin(), file.end(), filename);
+                    read_first_line(parser);
+                    if(m_NR < 2 || m_Nz < 2) {
+                        parser.fail("the poloidal flux matrix must have at least 2x2 points");
+                    }
+                    double header[20];
+                    parser.read_doubles(header, 20, "the header");
+                    m_rBoxLength = header[0];
+                    m_zBoxLength = header[1];
+                    m_r0Exp = header[2];
+                    m_rBoxLeft = header[3];
+                    m_zBoxMid = header[4];
+                    m_R0 = header[5];
+                    m_z0 = header[6];
+                    m_psiAxis = header[7];
+                    m_psiEdge = header[8];
+                    m_Btor = header[9];
+                    m_Ip = header[10];
+                    if(!(m_rBoxLength > 0.0) || !(m_zBoxLength > 0.0)) {
+                        parser.fail("the size of the poloidal flux matrix must be positive");
+                    }
+                    m_fpol.resize(m_NR);
+                    m_pres.resize(m_NR);
+                    m_ffprim.resize(m_NR);
+                    m_pprime.resize(m_NR);
+                    m_q.resize(m_NR);
+                    parser.read_doubles(m_fpol.data(), m_NR, "fpol");
+                    parser.read_doubles(m_pres.data(), m_NR, "pres");
+                    parser.read_doubles(m_ffprim.data(), m_NR, "ffprim");
+                    parser.read_doubles(m_pprime.data(), m_NR, "pprime");
+                    std::vector<double> psi(m_NR*m_Nz);
+                    parser.read_doubles(psi.data(), psi.size(), "psirz");
+                    parser.read_doubles(m_q.data(), m_NR, "qpsi");
+                    if(!parser.at_end()) {
+                        int64_t Nboundary = parser.read_integer("the number of boundary points");
+                        int64_t Nlimiter = parser.read_integer("the number of limiter points");
+                        if(Nboundary < 0 || Nlimiter < 0) {
+                            parser.fail("the number of boundary and limiter points must not be negative");
+                        }
+                        read_contour(parser, Nboundary, m_boundaryR, m_boundaryz, "the boundary");
+                        read_contour(parser, Nlimiter, m_limiterR, m_limiterz, "the limiter");
+                    }
+
+                    m_R.resize(m_NR);
+                    m_z.resize(m_Nz);
+                    m_psi.resize(m_NR*m_Nz);
+                    set_spacing();
                     for(uint32_t i = 0; i < m_NR; ++i){ 
-                        *(m_R + i) = m_rBoxLeft + dR * i;
+                        m_R[i] = m_rBoxLeft + m_dR * i;
                     }
-                    double dz = m_zBoxLength/(m_Nz-1);
                     for(uint32_t i = 0; i < m_Nz; ++i) {
-                        *(m_z + i) = m_zBoxMid - m_zBoxLength/2.0 + dz * i;
-                    }
-                    file >> m_R0 >> m_z0 >> m_psiAxis >> m_psiEdge >> m_Btor;
-                    file >> m_Ip >> dTemp >> dTemp >> dTemp >> dTemp;
-                    file >> dTemp >> dTemp >> dTemp >> dTemp >> dTemp;
-                    for(uint32_t i = 0; i < m_NR*4; ++i) {
-                        file >> dTemp;
+                        m_z[i] = m_zBoxMid - m_zBoxLength/2.0 + m_dz * i;
                     }
-                    dTemp = 0;
                     for(uint32_t i = 0; i < m_NR*m_Nz; ++i) {
-                        file >> *(m_psi + i);
-                        *(m_psi + i) *= -1.0;
-                        if(*(m_psi + i) < dTemp) dTemp = *(m_psi + i);
+                        m_psi[i] = -psi[i];
                     }
+                }
 
+                /*! \brief Destructor */
+                virtual ~equilibrium() {
                 }
 
-                /*! \brief Copy constructor */
-                equilibrium(const equilibrium & rhs) : m_comment(rhs.m_comment), m_NR(rhs.m_NR), m_Nz(rhs.m_Nz),
-                    m_rBoxLength(rhs.m_rBoxLength), m_zBoxLength(rhs.m_zBoxLength), m_r0Exp(rhs.m_r0Exp),
-                    m_rBoxLeft(rhs.m_rBoxLeft), m_zBoxMid(rhs.m_zBoxMid), m_R0(rhs.m_R0), m_z0(rhs.m_z0),
-                    m_psiAxis(rhs.m_psiAxis), m_psiEdge(rhs.m_psiEdge), m_Btor(rhs.m_Btor), m_Ip(rhs.m_Ip),
-                    m_R(new double[rhs.m_NR]), m_z(new double[rhs.m_Nz]), m_psi(new double[rhs.m_NR*rhs.m_Nz]) {
-                    std::copy(rhs.m_R, rhs.m_R + m_NR, m_R);
-                    std::copy(rhs.m_z, rhs.m_z + m_Nz, m_z);
-                    std::copy(rhs.m_psi, rhs.m_psi + m_NR*m_Nz, m_psi);
+                /*! \brief Switch the bicubic spline interpolation on or off
+                 *
+                 * If switched on, \f$\psi\f$ is interpolated with a bicubic spline instead of bilinearly.
+                 * The spline coefficients are calculated once when the interpolation is switched on.
+                 */
+                void set_spline(const bool useSpline) {
+                    if(useSpline && m_spline.empty()) {
+                        m_spline.build(m_psi.data(), m_NR, m_Nz, m_rBoxLeft, m_dR, m_z.front(), m_dz);
+                    }
+                    m_useSpline = useSpline;
                 }
-                /*! \brief Destructor constructor */
-                virtual ~equilibrium() {
-                    delete [] m_R;
-                    delete [] m_z;
-                    delete [] m_psi;
+
+                /*! \brief Check if the bicubic spline interpolation is used. */
+                bool get_spline() const {
+                    return m_useSpline;
                 }
 
                 /*! \brief Calculate the poloidal magnetic flux \f$\psi\f$ at the specified point \f$(R,z)\f$.
                  *
-                 * This function returns the linear interpolated poloidal magnetic flux \f$\psi\f$ at the point \f$(R,z)\f$.
+                 * This function returns the interpolated poloidal magnetic flux \f$\psi\f$ at the point \f$(R,z)\f$.
+                 * The interpolation is bilinear unless the spline interpolation has been switched on with set_spline().
                  */
                 double get_psi(const double R, const double z) const {
-                    uint32_t i0;
-                    uint32_t j0;
-                    double R0, R1;
-                    double z0, z1;
-                    if( (R < *(m_R)) || (z > *(m_R + m_NR - 1)) || (z < *(m_z)) || (z > *(m_z + m_Nz -1))) {
+                    if(m_useSpline) {
+                        return m_spline.evaluate(R, z);
+                    }
+                    double x = (R - m_rBoxLeft)*m_invdR;
+                    double y = (z - m_z.front())*m_invdz;
+                    if( !(x >= 0.0) || !(y >= 0.0) || (x > m_NR - 1) || (y > m_Nz - 1)) {
                         return 0.0;
                     }
-                    bool found = false;
-                    for(uint32_t i = 0; i < m_NR-2; ++i) {
-                        if((*(m_R + i) <= R) && (*(m_R + i + 1) >= R)) {
-                            i0 = i;
-                            R0 = *(m_R + i);
-                            R1 = *(m_R + i + 1);
-                            found = true;
-                        }
+                    uint32_t i0 = x;
+                    uint32_t j0 = y;
+                    if(i0 > m_NR - 2) i0 = m_NR - 2;
+                    if(j0 > m_Nz - 2) j0 = m_Nz - 2;
+                    double t = x - i0;
+                    double u = y - j0;
+                    const double * Q = m_psi.data() + i0 + j0*m_NR;
+                    double fR0 = (1.0 - t)*Q[0] + t*Q[1];
+                    double fR1 = (1.0 - t)*Q[m_NR] + t*Q[m_NR + 1];
+                    return (1.0 - u)*fR0 + u*fR1;
+                }
+
+                /*! \brief Calculate the poloidal magnetic flux \f$\psi\f$ at several points.
+                 *
+                 * This function returns the linear interpolated poloidal magnetic flux \f$\psi\f$ at the points \f$(R_i,z_i)\f$.
+                 */
+                std::vector<double> get_psi_values(const std::vector<double> & R, const std::vector<double> & z) const {
+                    if(R.size() != z.size()) {
+                        throw std::invalid_argument("R and z must have the same length.");
                     }
-                    if(!found) return 0.0;
-                    found = false;
-                    for(uint32_t j = 0; j < m_Nz-2; ++j) {
-                        if((*(m_z + j) <= z) && (*(m_z + j + 1) >= z)) {
-                            j0 = j;
-                            z0 = *(m_z + j);
-                            z1 = *(m_z + j + 1);
-                            found = true;
-                        }
+                    std::vector<double> output(R.size());
+                    if(m_useSpline) {
+                        m_spline.evaluate(R.data(), z.data(), R.size(), output.data());
+                        return output;
+                    }
+                    for(uint32_t i = 0; i < R.size(); ++i) {
+                        output[i] = get_psi(R[i], z[i]);
                     }
-                    if(!found) return 0.0;
-                    double fQ00 = *(m_psi + i0 + j0*m_NR);
-                    double fQ10 = *(m_psi + i0+1 + j0*m_NR);
-                    double fQ11 = *(m_psi + i0+1 + (j0+1)*m_NR);
-                    double fQ01 = *(m_psi + i0 + (j0+1)*m_NR);
-                    double fR0 = ((R1-R)/(R1-R0) * fQ00) + ((R-R0)/(R1-R0) * fQ10);
-                    double fR1 = ((R1-R)/(R1-R0) * fQ01) + ((R-R0)/(R1-R0) * fQ11);
-                    return (z1-z)/(z1-z0) * fR0 + (z-z0)/(z1-z0) * fR1;
+                    return output;
+                }
+
+                /*! \brief Calculate the gradient of the poloidal magnetic flux \f$\psi\f$ at the specified point \f$(R,z)\f$.
+                 *
+                 * This function calculates \f$\partial \psi/\partial R\f$ and \f$\partial \psi/\partial z\f$ of the interpolated flux.
+                 * Outside of the grid both are zero.
+                 */
+                void get_psi_gradient(const double R, const double z, double & dpsidR, double & dpsidz) const {
+                    if(m_useSpline) {
+                        double psi;
+                        m_spline.evaluate(R, z, psi, dpsidR, dpsidz);
+                        return;
+                    }
+                    dpsidR = 0.0;
+                    dpsidz = 0.0;
+                    double x = (R - m_rBoxLeft)*m_invdR;
+                    double y = (z - m_z.front())*m_invdz;
+                    if( !(x >= 0.0) || !(y >= 0.0) || (x > m_NR - 1) || (y > m_Nz - 1)) {
+                        return;
+                    }
+                    uint32_t i0 = x;
+                    uint32_t j0 = y;
+                    if(i0 > m_NR - 2) i0 = m_NR - 2;
+                    if(j0 > m_Nz - 2) j0 = m_Nz - 2;
+                    double t = x - i0;
+                    double u = y - j0;
+                    const double * Q = m_psi.data() + i0 + j0*m_NR;
+                    dpsidR = ((1.0 - u)*(Q[1] - Q[0]) + u*(Q[m_NR + 1] - Q[m_NR]))*m_invdR;
+                    dpsidz = ((1.0 - t)*(Q[m_NR] - Q[0]) + t*(Q[m_NR + 1] - Q[1]))*m_invdz;
+                }
+
+                /*! \brief Calculate the gradient of the poloidal magnetic flux \f$\psi\f$ at several points.
+                 *
+                 * This function writes \f$\partial \psi/\partial R\f$ and \f$\partial \psi/\partial z\f$ at the points \f$(R_i,z_i)\f$ to dpsidR and dpsidz.
+                 */
+                void get_psi_gradient_values(const std::vector<double> & R, const std::vector<double> & z,
+                    std::vector<double> & dpsidR, std::vector<double> & dpsidz) const {
+                    if(R.size() != z.size()) {
+                        throw std::invalid_argument("R and z must have the same length.");
+                    }
+                    dpsidR.resize(R.size());
+                    dpsidz.resize(R.size());
+                    if(m_useSpline) {
+                        std::vector<double> psi(R.size());
+                        m_spline.evaluate(R.data(), z.data(), R.size(), psi.data(), dpsidR.data(), dpsidz.data());
+                        return;
+                    }
+                    for(uint32_t i = 0; i < R.size(); ++i) {
+                        get_psi_gradient(R[i], z[i], dpsidR[i], dpsidz[i]);
+                    }
+                }
+
+                /*! \brief Calculate the gradient of the poloidal magnetic flux \f$\psi\f$ as python tuple.
+                 *
+                 * This function returns \f$(\partial \psi/\partial R, \partial \psi/\partial z)\f$ at the point \f$(R,z)\f$.
+                 * This function is intended as python interface.
+                 * Do not use this function from within C++.
+                 */
+                boost::python::tuple get_psi_gradient_python(const double R, const double z) const {
+                    double dpsidR, dpsidz;
+                    get_psi_gradient(R, z, dpsidR, dpsidz);
+                    return boost::python::make_tuple(dpsidR, dpsidz);
+                }
+
+                /*! \brief Calculate the gradient of the poloidal magnetic flux \f$\psi\f$ at several points as python tuple of lists.
+                 *
+                 * This function returns the lists of \f$\partial \psi/\partial R\f$ and \f$\partial \psi/\partial z\f$ at the points \f$(R_i,z_i)\f$.
+                 * This function is intended as python interface.
+                 * Do not use this function from within C++.
+                 */
+                boost::python::tuple get_psi_gradient_list_python(const boost::python::list & R, const boost::python::list & z) const {
+                    std::vector<double> dpsidR, dpsidz;
+                    get_psi_gradient_values(to_vector(R), to_vector(z), dpsidR, dpsidz);
+                    return boost::python::make_tuple(to_list(dpsidR), to_list(dpsidz));
+                }
+
+                /*! \brief Calculate the poloidal magnetic flux \f$\psi\f$ at several points as python list.
+                 *
+                 * This function returns the linear interpolated poloidal magnetic flux \f$\psi\f$ at the points \f$(R_i,z_i)\f$.
+                 * This function is intended as python interface.
+                 * Do not use this function from within C++.
+                 */
+                boost::python::list get_psi_python(const boost::python::list & R, const boost::python::list & z) const {
+                    return to_list(get_psi_values(to_vector(R), to_vector(z)));
                 }
 
                 /*! \brief Calculate \f$\rho_{pol}\f$ at the specified point \f$(R,z)\f$.
@@ -121,6 +249,29 @@ namespace wallLoad {
                     return sqrt((m_psiAxis-get_psi(R,z))/(m_psiAxis-m_psiEdge));
                 }
 
+                /*! \brief Calculate \f$\rho_{pol}\f$ at several points.
+                 *
+                 * This function returns the linear interpolated \f$\rho_{pol}\f$ at the points \f$(R_i,z_i)\f$.
+                 */
+                std::vector<double> get_rho_values(const std::vector<double> & R, const std::vector<double> & z) const {
+                    std::vector<double> output = get_psi_values(R, z);
+                    double norm = 1.0/(m_psiAxis-m_psiEdge);
+                    for(auto iter = output.begin(); iter != output.end(); ++iter) {
+                        *iter = sqrt((m_psiAxis-*iter)*norm);
+                    }
+                    return output;
+                }
+
+                /*! \brief Calculate \f$\rho_{pol}\f$ at several points as python list.
+                 *
+                 * This function returns the linear interpolated \f$\rho_{pol}\f$ at the points \f$(R_i,z_i)\f$.
+                 * This function is intended as python interface.
+                 * Do not use this function from within C++.
+                 */
+                boost::python::list get_rho_python(const boost::python::list & R, const boost::python::list & z) const {
+                    return to_list(get_rho_values(to_vector(R), to_vector(z)));
+                }
+
                 /*! \brief Get the comment */
                 std::string get_comment() const { return m_comment; }
                 /*! \brief Get the shape of the poloidal flux matrix as python tuple. 
@@ -133,7 +284,7 @@ namespace wallLoad {
 
                 /*! \brief Get R values of poloidal flux matrix. */
                 std::vector<double> get_R() const {
-                    return std::vector<double>(m_R, m_R + m_NR);
+                    return m_R;
                 }
 
                 /*! \brief Get R values of poloidal flux matrix as python list. 
@@ -144,7 +295,7 @@ namespace wallLoad {
                  */
                 boost::python::list get_R_python() const {
                     boost::python::list output;
-                    for(double * iter = m_R; iter != m_R + m_NR; ++iter) {
+                    for(auto iter = m_R.begin(); iter != m_R.end(); ++iter) {
                         output.append(*iter);
                     }
                     return output;
@@ -152,7 +303,7 @@ namespace wallLoad {
 
                 /*! \brief Get z values of poloidal flux matrix. */
                 std::vector<double> get_z() const {
-                    return std::vector<double>(m_z, m_z + m_Nz);
+                    return m_z;
                 }
 
                 /*! \brief Get z values of poloidal flux matrix as python list. 
@@ -163,7 +314,7 @@ namespace wallLoad {
                  */
                 boost::python::list get_z_python() const {
                     boost::python::list output;
-                    for(double * iter = m_z; iter != m_z + m_Nz; ++iter) {
+                    for(auto iter = m_z.begin(); iter != m_z.end(); ++iter) {
                         output.append(*iter);
                     }
                     return output;
@@ -189,8 +340,134 @@ namespace wallLoad {
                 /*! \brief Get the largest z value \f$z_{max}\f$ of the poloidal flux matrix. */
                 double get_zmax() const { return m_zBoxMid + m_zBoxLength/2.0; }
 
+                /*! \brief Get the poloidal current function \f$F = R B_{tor}\f$ on the uniform \f$\psi\f$ grid from axis to separatrix. */
+                const std::vector<double> & get_fpol() const { return m_fpol; }
+                /*! \brief Get the plasma pressure on the uniform \f$\psi\f$ grid. */
+                const std::vector<double> & get_pres() const { return m_pres; }
+                /*! \brief Get \f$FF'\f$ on the uniform \f$\psi\f$ grid. */
+                const std::vector<double> & get_ffprim() const { return m_ffprim; }
+                /*! \brief Get \f$p'\f$ on the uniform \f$\psi\f$ grid. */
+                const std::vector<double> & get_pprime() const { return m_pprime; }
+                /*! \brief Get the safety factor \f$q\f$ on the uniform \f$\psi\f$ grid. */
+                const std::vector<double> & get_q() const { return m_q; }
+                /*! \brief Get the R values of the plasma boundary. */
+                const std::vector<double> & get_boundaryR() const { return m_boundaryR; }
+                /*! \brief Get the z values of the plasma boundary. */
+                const std::vector<double> & get_boundaryz() const { return m_boundaryz; }
+                /*! \brief Get the R values of the limiter contour. */
+                const std::vector<double> & get_limiterR() const { return m_limiterR; }
+                /*! \brief Get the z values of the limiter contour. */
+                const std::vector<double> & get_limiterz() const { return m_limiterz; }
+
+                /*! \brief Get the poloidal current function as python list. */
+                boost::python::list get_fpol_python() const { return to_list(m_fpol); }
+                /*! \brief Get the plasma pressure as python list. */
+                boost::python::list get_pres_python() const { return to_list(m_pres); }
+                /*! \brief Get \f$FF'\f$ as python list. */
+                boost::python::list get_ffprim_python() const { return to_list(m_ffprim); }
+                /*! \brief Get \f$p'\f$ as python list. */
+                boost::python::list get_pprime_python() const { return to_list(m_pprime); }
+                /*! \brief Get the safety factor as python list. */
+                boost::python::list get_q_python() const { return to_list(m_q); }
+                /*! \brief Get the R values of the plasma boundary as python list. */
+                boost::python::list get_boundaryR_python() const { return to_list(m_boundaryR); }
+                /*! \brief Get the z values of the plasma boundary as python list. */
+                boost::python::list get_boundaryz_python() const { return to_list(m_boundaryz); }
+                /*! \brief Get the R values of the limiter contour as python list. */
+                boost::python::list get_limiterR_python() const { return to_list(m_limiterR); }
+                /*! \brief Get the z values of the limiter contour as python list. */
+                boost::python::list get_limiterz_python() const { return to_list(m_limiterz); }
+
 
             protected:
+                /*! \brief Read the first line of an eqdsk file
+                 *
+                 * The first line holds a comment of 48 characters followed by three integers in fields of 4 characters,
+                 * of which the last two are the number of points in R and z direction. Fields of 4 characters may run
+                 * together (e.g. "   3 5131025"), so a line of exactly this width is split at the fixed columns.
+                 * Otherwise the integers are taken as the last three words of the line, so that shorter or longer
+                 * comments are accepted as well.
+                 */
+                void read_first_line(textParser & parser) {
+                    uint64_t line = parser.get_line();
+                    std::string text = parser.read_line();
+                    const char * begin = text.data();
+                    const char * end = begin + text.size();
+                    while(end != begin && isspace(*(end - 1))) --end;
+                    int64_t integers[3];
+                    const char * first = begin + 48;
+                    bool fixed = (end - begin == 60);
+                    for(uint32_t i = 0; fixed && i < 3; ++i) {
+                        fixed = read_field(first + 4*i, first + 4*(i + 1), integers[i]);
+                    }
+                    if(!fixed) {
+                        first = end;
+                        for(uint32_t i = 0; i < 3; ++i) {
+                            while(first != begin && isspace(*(first - 1))) --first;
+                            while(first != begin && !isspace(*(first - 1))) --first;
+                        }
+                        textParser words(first, end, parser.get_name());
+                        words.set_position(first, line);
+                        integers[0] = words.read_integer("the first integer of the header");
+                        integers[1] = words.read_integer("the number of R values");
+                        integers[2] = words.read_integer("the number of z values");
+                        if(!words.at_end()) {
+                            words.fail("the first line must end with three integers");
+                        }
+                    }
+                    const char * last = first;
+                    while(last != begin && isspace(*(last - 1))) --last;
+                    m_comment = std::string(begin, last);
+                    if(integers[1] < 0 || integers[2] < 0 || integers[1] > 0xffff || integers[2] > 0xffff) {
+                        throw std::runtime_error(parser.get_name() + ":" + std::to_string(line) + ": invalid size of the poloidal flux matrix");
+                    }
+                    m_NR = integers[1];
+                    m_Nz = integers[2];
+                }
+
+                /*! \brief Read an integer filling the field [first, last) with leading blanks. Returns false if this fails. */
+                static bool read_field(const char * first, const char * last, int64_t & value) {
+                    while(first != last && *first == ' ') ++first;
+                    std::from_chars_result result = std::from_chars(first, last, value);
+                    return result.ec == std::errc() && result.ptr == last;
+                }
+
+                /*! \brief Read N (R,z) pairs of a contour. */
+                static void read_contour(textParser & parser, const int64_t N, std::vector<double> & R, std::vector<double> & z, const char * description) {
+                    R.resize(N);
+                    z.resize(N);
+                    for(int64_t i = 0; i < N; ++i) {
+                        R[i] = parser.read_double(description);
+                        z[i] = parser.read_double(description);
+                    }
+                }
+
+                /*! \brief Calculate the grid spacing and its reciprocal from the box size. */
+                void set_spacing() {
+                    m_dR = m_rBoxLength/(m_NR-1);
+                    m_dz = m_zBoxLength/(m_Nz-1);
+                    m_invdR = 1.0/m_dR;
+                    m_invdz = 1.0/m_dz;
+                }
+
+                /*! \brief Convert a python list into a vector. */
+                static std::vector<double> to_vector(const boost::python::list & input) {
+                    std::vector<double> output(boost::python::len(input));
+                    for(uint32_t i = 0; i < output.size(); ++i) {
+                        output[i] = boost::python::extract<double>(input[i]);
+                    }
+                    return output;
+                }
+
+                /*! \brief Convert a vector into a python list. */
+                static boost::python::list to_list(const std::vector<double> & input) {
+                    boost::python::list output;
+                    for(auto iter = input.begin(); iter != input.end(); ++iter) {
+                        output.append(*iter);
+                    }
+                    return output;
+                }
+
                 std::string m_comment; /*!< \brief Comment to the equilibrium. */
                 uint32_t m_NR; /*!< \brief Number of R values in the equilibrium. */
                 uint32_t m_Nz; /*!< \brief Number of z values in the equilibrium. */
@@ -205,9 +482,24 @@ namespace wallLoad {
                 double m_psiEdge; /*!< \brief Poloidal magnetic flux \f$\psi\f$ at the separatrix. */
                 double m_Btor; /*!< \brief Toroidal magnetic field at the axis. */
                 double m_Ip; /*!< \brief Plasma current. */
-                double * m_R; /*!< \brief R values of the poloidal flux matrix. */
-                double * m_z; /*!< \brief z values of the poloidal flux matrix. */
-                double * m_psi; /*!< \brief Poloidal flux matrix. */
+                std::vector<double> m_R; /*!< \brief R values of the poloidal flux matrix. */
+                std::vector<double> m_z; /*!< \brief z values of the poloidal flux matrix. */
+                std::vector<double> m_psi; /*!< \brief Poloidal flux matrix. */
+                double m_dR; /*!< \brief Grid spacing in R direction. */
+                double m_dz; /*!< \brief Grid spacing in z direction. */
+                double m_invdR; /*!< \brief Reciprocal grid spacing in R direction. */
+                double m_invdz; /*!< \brief Reciprocal grid spacing in z direction. */
+                std::vector<double> m_fpol; /*!< \brief Poloidal current function on the uniform \f$\psi\f$ grid. */
+                std::vector<double> m_pres; /*!< \brief Plasma pressure on the uniform \f$\psi\f$ grid. */
+                std::vector<double> m_ffprim; /*!< \brief \f$FF'\f$ on the uniform \f$\psi\f$ grid. */
+                std::vector<double> m_pprime; /*!< \brief \f$p'\f$ on the uniform \f$\psi\f$ grid. */
+                std::vector<double> m_q; /*!< \brief Safety factor on the uniform \f$\psi\f$ grid. */
+                std::vector<double> m_boundaryR; /*!< \brief R values of the plasma boundary. */
+                std::vector<double> m_boundaryz; /*!< \brief z values of the plasma boundary. */
+                std::vector<double> m_limiterR; /*!< \brief R values of the limiter contour. */
+                std::vector<double> m_limiterz; /*!< \brief z values of the limiter contour. */
+                bool m_useSpline; /*!< \brief Information if the bicubic spline interpolation is used. */
+                bicubicSpline m_spline; /*!< \brief Bicubic spline of the poloidal flux matrix. */
         };        
     }
 }
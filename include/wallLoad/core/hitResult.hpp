@@ -1,14 +1,16 @@
 #ifndef include_wallLoad_core_hitResult_hpp
 #define include_wallLoad_core_hitResult_hpp
 
-#include <boost/python.hpp>
 #include <wallLoad/core/vektor.hpp>
+#include <stdint.h>
+#include <type_traits>
 
 namespace wallLoad {
     namespace core {
         /*! \brief Class to store the hit result of an intersection check.
          *
          * This class stores the intersection point, the information if a hit occurred and what element got hit.
+         * It is a trivially copyable standard layout type, the members are ordered so that it fits into 32 bytes.
          */
         class hitResult
         {
@@ -17,40 +19,21 @@ namespace wallLoad {
                  *
                  * This constructor initializes an empty hit result.
                  */
-                hitResult() : hasHit(false), hitPoint(), element(-1) {}
+                constexpr hitResult() : hitPoint(), element(-1), hasHit(false) {}
                 /*! \brief Constructor
                  *
                  * This constructor initializes the hit result with hit information and hit point.
                  */
-                hitResult(const bool HasHit, const vektor & HitPoint) :
-                    hasHit(HasHit), hitPoint(HitPoint), element(-1) {
+                constexpr hitResult(const bool HasHit, const vektor & HitPoint) :
+                    hitPoint(HitPoint), element(-1), hasHit(HasHit) {
                 }
-                /*! \brief Copy constructor */
-                hitResult(const hitResult & rhs) :
-                    hasHit(rhs.hasHit), hitPoint(rhs.hitPoint),
-                    element(rhs.element) {
-                }
-                /*! \brief Destructor */
-                virtual ~hitResult() {}
 
-                /*! \brief Assignment operator
-                 *
-                 * This operator copies the information of the given hit result to the current instance.
-                 */
-                hitResult & operator= (const hitResult & rhs) {
-                    if(this != &rhs) {
-                        hasHit = rhs.hasHit;
-                        hitPoint = rhs.hitPoint;
-                        element = rhs.element;
-                    }
-                    return *this;
-                }
                 /*! \brief Bool operator
                  *
                  * This operator evaluates the instance as bool.
                  * True if the hit occurred, false if not.
                  */
-                explicit operator bool() const { return hasHit; }
+                constexpr explicit operator bool() const { return hasHit; }
                 /*! \brief Calculate the distance between the hit point and the given point.
                  *
                  * This function calculates the distance between the hit point and the given point.
@@ -59,10 +42,13 @@ namespace wallLoad {
                     return (hitPoint - rhs).get_length();
                 }
             public:
-                bool hasHit; /*!< \brief Information if the hit occurred. */
                 vektor hitPoint; /*!< \brief Position where the intersection occurs. */
-                int32_t element; /*!< \brief Number of the element that got hit. */ 
+                int32_t element; /*!< \brief Number of the element that got hit. */
+                bool hasHit; /*!< \brief Information if the hit occurred. */
         };
+
+        static_assert(std::is_trivially_copyable<hitResult>::value && std::is_standard_layout<hitResult>::value && sizeof(hitResult) == 32,
+                "hitResult needs to be a plain 32 byte record");
     }
 }
 
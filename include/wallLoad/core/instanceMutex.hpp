@@ -0,0 +1,32 @@
+#ifndef include_wallLoad_core_instanceMutex_hpp
+#define include_wallLoad_core_instanceMutex_hpp
+
+#include <shared_mutex>
+#include <mutex>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Mutex guarding a single instance of a class.
+         *
+         * This class is a std::shared_mutex which can be a member of a copyable class.
+         * A copy does not share the lock of the original, it starts with a new, unlocked mutex.
+         * Functions which only read the instance take a std::shared_lock, functions which modify it take a std::unique_lock.
+         */
+        class instanceMutex : public std::shared_mutex {
+            public:
+                /*! \brief Default constructor */
+                instanceMutex() : std::shared_mutex() {}
+                /*! \brief Copy constructor, creates a new mutex. */
+                instanceMutex(const instanceMutex &) : std::shared_mutex() {}
+                /*! \brief Assignment operator, keeps the mutex. */
+                instanceMutex & operator=(const instanceMutex &) {
+                    return *this;
+                }
+        };
+
+        typedef std::shared_lock<std::shared_mutex> readLock; /*!< \brief Lock for reading an instance. */
+        typedef std::unique_lock<std::shared_mutex> writeLock; /*!< \brief Lock for modifying an instance. */
+    }
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef include_wallLoad_core_mappedFile_hpp
+#define include_wallLoad_core_mappedFile_hpp
+
+#include <string>
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Read only memory mapping of a file.
+         *
+         * This class maps a whole file into memory, so that parsers can work directly on the characters without copying them.
+         * The mapping is removed when the instance is destroyed.
+         * A std::runtime_error is thrown if the file can not be opened or mapped.
+         */
+        class mappedFile {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor opens and maps the given file.
+                 * If sequential is set the kernel is told that the file is read from front to back,
+                 * otherwise that it is accessed randomly.
+                 */
+                mappedFile(const std::string & filename, const bool sequential = true) : m_filename(filename), m_data(0), m_size(0) {
+                    int descriptor = open(filename.c_str(), O_RDONLY);
+                    if(descriptor < 0) {
+                        throw std::runtime_error("Could not open " + filename + ": " + strerror(errno));
+                    }
+                    struct stat status;
+                    if(fstat(descriptor, &status) != 0) {
+                        int error = errno;
+                        close(descriptor);
+                        throw std::runtime_error("Could not read the size of " + filename + ": " + strerror(error));
+                    }
+                    m_size = status.st_size;
+                    if(m_size > 0) {
+                        void * data = mmap(0, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                        if(data == MAP_FAILED) {
+                            int error = errno;
+                            close(descriptor);
+                            throw std::runtime_error("Could not map " + filename + ": " + strerror(error));
+                        }
+                        m_data = static_cast<const char *>(data);
+                        madvise(data, m_size, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+                    }
+                    close(descriptor);
+                }
+
+                /*! \brief Destructor */
+                virtual ~mappedFile() {
+                    if(m_data) {
+                        munmap(const_cast<char *>(m_data), m_size);
+                    }
+                }
+
+                /*! \brief Get the first character of the file. */
+                const char * begin() const {
+                    return m_data;
+                }
+
+                /*! \brief Get the position behind the last character of the file. */
+                const char * end() const {
+                    return m_data + m_size;
+                }
+
+                /*! \brief Get the size of the file in bytes. */
+                uint64_t size() const {
+                    return m_size;
+                }
+
+                /*! \brief Get the name of the file. */
+                std::string get_filename() const {
+                    return m_filename;
+                }
+
+            protected:
+                mappedFile(const mappedFile &); /*!< \brief Mappings are not copyable. */
+                mappedFile & operator=(const mappedFile &); /*!< \brief Mappings are not assignable. */
+
+                std::string m_filename; /*!< \brief Name of the mapped file. */
+                const char * m_data; /*!< \brief Start of the mapping. */
+                uint64_t m_size; /*!< \brief Size of the mapping in bytes. */
+        };
+    }
+}
+
+#endif
@@ -3,122 +3,274 @@
 
 #include <boost/python.hpp>
 #include <boost/random.hpp>
-#include <time.h>
 #include <algorithm>
 #include <iterator>
 #include <vector>
 #include <stdint.h>
 #include <string.h>
-#include <fstream>
+#include <map>
+#include <thread>
+#include <limits>
+#include <stdexcept>
+#include <math.h>
+#include <boost/math/constants/constants.hpp>
 #include <wallLoad/core/vertex.hpp>
 #include <wallLoad/core/vektor.hpp>
+#include <wallLoad/core/boundingVolumeHierarchy.hpp>
+#include <wallLoad/core/philox.hpp>
+#include <wallLoad/core/triangleStore.hpp>
+#include <wallLoad/core/mshFile.hpp>
+#include <wallLoad/core/meshCache.hpp>
+#include <wallLoad/core/instanceMutex.hpp>
 
 namespace wallLoad {
     namespace core {
         /*! \brief Class representing the mesh of the first wall.
          *
-         * This class stores the vertices of the first wall contour.
+         * This class stores the vertices of the first wall contour as indexed triangles:
+         * an array with the coordinates of the nodes, which are shared by the vertices, and three 32 bit node indices per vertex.
+         * A vertex is only created on request, e.g. by operator[].
+         *
+         * The mesh can stand for several copies of itself rotated about the z axis, e.g. the sectors of a torus,
+         * see set_instances(). Only the vertices of one copy and their hierarchy are stored; rays are traced against
+         * every copy by rotating them into its frame, so they are shadowed by all copies.
+         * The functions which return a vertex index then return the index within the copy.
+         * The functions which modify the mesh and the ones which trace many rays at once lock the mutex of the instance,
+         * so the mesh can be shared by several threads. The other functions do not lock.
          */
-        class mesh : public std::vector<vertex>
+        class mesh
         {
             public:
                 /*! \brief Copy constructor */
                 mesh(const mesh & rhs) : 
-                    std::vector<vertex>(rhs),
-                    m_emissivity(rhs.size(), 1.0),
-                    m_generator(time(0)),
-                    m_uniform() {
+                    m_nodes(rhs.m_nodes),
+                    m_indices(rhs.m_indices),
+                    m_emissivity(rhs.m_emissivity),
+                    m_physical(rhs.m_physical),
+                    m_physicalNames(rhs.m_physicalNames),
+                    m_generator(rhs.m_generator),
+                    m_uniform(),
+                    m_hierarchy(rhs.m_hierarchy),
+                    m_triangles(rhs.m_triangles),
+                    m_source(rhs.m_source),
+                    m_fromCache(rhs.m_fromCache),
+                    m_instances(rhs.m_instances),
+                    m_rotation(rhs.m_rotation),
+                    m_order(rhs.m_order),
+                    m_centre(rhs.m_centre),
+                    m_halfWidth(rhs.m_halfWidth) {
                 }
 
                 /*! \brief Python constructor
                  *
                  * This constructor loads the vertices from a python list.
+                 * Points with identical coordinates are stored as one node.
                  * This constructor is intended as python interface.
                  * Do not use this constructor from within C++.
                  */
                 mesh(const boost::python::list & rhs) : 
-                    std::vector<vertex>(),
+                    m_nodes(),
+                    m_indices(),
                     m_emissivity(boost::python::len(rhs), 1.0),
-                    m_generator(time(0)),
-                    m_uniform() {
+                    m_physical(boost::python::len(rhs), 0),
+                    m_physicalNames(),
+                    m_generator(philox::default_seed, meshStream),
+                    m_uniform(),
+                    m_hierarchy(),
+                    m_triangles(),
+                    m_source(),
+                    m_fromCache(false),
+                    m_instances(),
+                    m_rotation(),
+                    m_order(),
+                    m_centre(),
+                    m_halfWidth(0.0) {
                     for(uint32_t i = 0; i < boost::python::len(rhs); ++i){
-                        std::vector<vertex>::push_back(boost::python::extract<vertex>(rhs[i]));
+                        add_vertex(boost::python::extract<vertex>(rhs[i]));
                     }
+                    merge_nodes();
+                    build_hierarchy();
                 }
 
                 /*! Constructor
                  *
-                 * This constructor loads the vertices from a *.msh file created by gmsh.
+                 * This constructor loads the vertices from a *.msh file created by gmsh in the format 2.x or 4.1, ASCII or binary,
+                 * or from a mesh cache written by save().
+                 * The *.msh file is parsed with the given number of threads, 0 uses one thread per processor core.
+                 * The physical group of every vertex is kept, see mshFile.
+                 * A cache is used as it is, without checking its source file.
+                 * A std::runtime_error is thrown if the file can not be read.
                  */
-                mesh(const std::string & filename) : 
-                    std::vector<vertex>(),
+                mesh(const std::string & filename, const uint32_t threads = 0) : 
+                    m_nodes(),
+                    m_indices(),
                     m_emissivity(),
-                    m_generator(time(0)),
-                    m_uniform() {
-                    std::fstream file(filename.c_str(), std::ios::in);
-                    if(file.is_open()) {
-                        std::string temp;
-                        while(temp!="$Nodes") {
-                            std::getline(file, temp, '\n');
-                        }
-                        uint32_t nNodes;
-                        file >> nNodes;
-                        std::vector<vektor> nodes;
-                        uint32_t nodeNumber;
-                        double x,y,z;
-                        for(uint32_t i = 0; i < nNodes; ++i) {
-                            file >> nodeNumber >> x >> y >> z;
-                            nodes.push_back(vektor(x,y,z));
-                        }
-                        while(temp!="$Elements") {
-                            std::getline(file, temp, '\n');
-                        }
-                        uint32_t nElements;
-                        file >> nElements;
-                        uint32_t elementId, elementType;
-                        uint32_t nTags, tag;
-                        uint32_t node1, node2, node3;
-                        for(uint32_t i = 0; i < nElements; ++i) {
-                            file >> elementId >> elementType;
-                            if(elementType==2) {
-                                file >> nTags;
-                                for(uint32_t j = 0; j < nTags; ++j) {
-                                    file >> tag;
-                                }
-                                file >> node1 >> node2 >> node3;
-                                std::vector<vertex>::push_back(vertex(nodes[node1-1], nodes[node2-1], nodes[node3-1]));
-                                m_emissivity.push_back(1.0);
-                            }
-                            else {
-                                std::getline(file, temp, '\n');
-                            }
-                        }
+                    m_physical(),
+                    m_physicalNames(),
+                    m_generator(philox::default_seed, meshStream),
+                    m_uniform(),
+                    m_hierarchy(),
+                    m_triangles(),
+                    m_source(),
+                    m_fromCache(false),
+                    m_instances(),
+                    m_rotation(),
+                    m_order(),
+                    m_centre(),
+                    m_halfWidth(0.0) {
+                    if(meshCache::is_cache(filename)) {
+                        read_cache(meshCache(filename));
+                    }
+                    else {
+                        read_msh(filename, threads);
+                    }
+                }
 
-                        file.close();
+                /*! Constructor
+                 *
+                 * This constructor loads the vertices from the given mesh cache if it was written for the current version of the given
+                 * *.msh file. Otherwise the *.msh file is read with the given number of threads and the cache is written.
+                 * The source file is identified by its size and modification time.
+                 * A std::runtime_error is thrown if the *.msh file can not be read.
+                 * If the cache can not be written, e.g. in a read-only directory, the mesh read from the *.msh file is kept
+                 * and get_from_cache() returns false.
+                 */
+                mesh(const std::string & filename, const std::string & cache, const uint32_t threads = 0) : 
+                    m_nodes(),
+                    m_indices(),
+                    m_emissivity(),
+                    m_physical(),
+                    m_physicalNames(),
+                    m_generator(philox::default_seed, meshStream),
+                    m_uniform(),
+                    m_hierarchy(),
+                    m_triangles(),
+                    m_source(),
+                    m_fromCache(false),
+                    m_instances(),
+                    m_rotation(),
+                    m_order(),
+                    m_centre(),
+                    m_halfWidth(0.0) {
+                    meshCache::source origin = meshCache::get_source(filename);
+                    try {
+                        meshCache file(cache);
+                        if(file.get_source() == origin) {
+                            read_cache(file);
+                            return;
+                        }
+                    }
+                    catch(const std::runtime_error &) {
+                    }
+                    read_msh(filename, threads);
+                    try {
+                        save(cache);
+                    }
+                    catch(const std::runtime_error &) {
                     }
                 }
 
                 /*! \brief Destructor */
                 virtual ~mesh() {}
 
+                /*! \brief Set the seed of the random number generator
+                 *
+                 * This function restarts the random number stream of the instance with the given seed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    writeLock lock(m_mutex);
+                    m_generator.seed(seed, meshStream);
+                }
+
+                /*! \brief Get the seed of the random number generator. */
+                uint64_t get_seed() const {
+                    return m_generator.get_seed();
+                }
+
                 /*! \brief Assignment operator
                  *
-                 * This operators copies the vertices from the given mesh to the current instance.
+                 * This operators copies the vertices and the random number generator from the given mesh to the current instance.
+                 * The given mesh is copied while its mutex is locked for reading, the copy is then assigned with the mutex
+                 * of the instance locked for writing.
                  */
                 mesh & operator=(const mesh & rhs) {
                     if(this != &rhs) {
-                        std::vector<vertex>::operator=(rhs);
-                        m_emissivity = rhs.m_emissivity;
+                        mesh copy(rhs, readLock(rhs.m_mutex));
+                        writeLock lock(m_mutex);
+                        m_nodes = copy.m_nodes;
+                        m_indices = copy.m_indices;
+                        m_emissivity = copy.m_emissivity;
+                        m_physical = copy.m_physical;
+                        m_physicalNames = copy.m_physicalNames;
+                        m_generator = copy.m_generator;
+                        m_hierarchy = copy.m_hierarchy;
+                        m_triangles = copy.m_triangles;
+                        m_source = copy.m_source;
+                        m_fromCache = copy.m_fromCache;
+                        m_instances = copy.m_instances;
+                        m_rotation = copy.m_rotation;
+                        m_order = copy.m_order;
+                        m_centre = copy.m_centre;
+                        m_halfWidth = copy.m_halfWidth;
                     }
                     return *this;
                 }
 
                 /*! \brief Append vertex
                  *
-                 * This function appends the given vertex to the mesh.
+                 * This function appends the given vertex to the mesh. Its points are added as new nodes.
+                 * The bounding volume hierarchy is discarded, call build_hierarchy() after the last vertex is appended.
+                 * For an instanced mesh the toroidal extent of the copies is updated.
                  */
                 inline void append(const vertex & rhs) {
-                    std::vector<vertex>::push_back(rhs);
+                    writeLock lock(m_mutex);
+                    add_vertex(rhs);
+                    m_emissivity.push_back(1.0);
+                    m_physical.push_back(0);
+                    m_hierarchy.clear();
+                    m_triangles.clear();
+                    if(!m_instances.empty()) {
+                        update_instances();
+                    }
+                }
+
+                /*! \brief Build the bounding volume hierarchy
+                 *
+                 * This function builds the bounding volume hierarchy used by evaluateHit() and evaluateHits().
+                 * It is called by the constructors and needs to be called again after the vertices of the mesh were changed.
+                 * Together with the hierarchy the vertices are stored in leaf order in a structure of arrays,
+                 * which is tested with the widest instruction set supported by the processor.
+                 * Without hierarchy every vertex is tested for each ray.
+                 */
+                void build_hierarchy() {
+                    writeLock lock(m_mutex);
+                    m_hierarchy.build(m_nodes, m_indices);
+                    m_triangles.build(m_nodes, m_indices, m_hierarchy.get_indices());
+                }
+
+                /*! \brief Check if the bounding volume hierarchy is built. */
+                bool has_hierarchy() const {
+                    return !m_hierarchy.empty();
+                }
+
+                /*! \brief Save the mesh as cache
+                 *
+                 * This function writes the nodes and the indexed vertices, their physical groups and emissivities and,
+                 * if it is built, the bounding volume hierarchy to a binary file, which can be loaded again by the constructors.
+                 */
+                void save(const std::string & filename) const {
+                    readLock lock(m_mutex);
+                    meshCache::write(filename, m_source, m_nodes, m_indices, m_physical, m_emissivity, m_hierarchy, m_triangles, m_physicalNames);
+                }
+
+                /*! \brief Check if the mesh was loaded from a cache. */
+                bool get_from_cache() const {
+                    return m_fromCache;
+                }
+
+                /*! \brief Get the instruction set used for the intersection tests. */
+                std::string get_instruction_set() const {
+                    return m_triangles.get_instruction_set();
                 }
 
                 /*! \brief Calculate the intersections of the given ray with the mesh.
@@ -130,11 +282,16 @@ namespace wallLoad {
                 std::vector<hitResult> intersect(const vektor & origin, const vektor & direction) const {
                     hitResult temp;
                     std::vector<hitResult> output;
-                    for(mesh::const_iterator iter = begin(); iter != end(); ++iter) {
-                        temp = iter->intersect(origin, direction);
-                        if(temp) {
-                            temp.element = std::distance(begin(), iter);
-                            output.push_back(temp);
+                    for(uint32_t k = 0; k < get_instance_count(); ++k) {
+                        vektor start = m_instances.empty() ? origin : rotate(origin, k, -1.0);
+                        vektor ray = m_instances.empty() ? direction : rotate(direction, k, -1.0);
+                        for(uint32_t i = 0; i < size(); ++i) {
+                            temp = get_vertex(i).intersect(start, ray);
+                            if(temp) {
+                                temp.element = i;
+                                temp.hitPoint = m_instances.empty() ? temp.hitPoint : rotate(temp.hitPoint, k);
+                                output.push_back(temp);
+                            }
                         }
                     }
                     return output;
@@ -142,26 +299,86 @@ namespace wallLoad {
 
                 /*! \brief Calculate the hit point of the ray
                  *
-                 * This function calculates the intersections of the given ray with the mesh.
+                 * This function calculates the closest intersection of the given ray with the mesh.
                  * Only the real hit point of the ray is returned.
                  * This means only points that lie in the direction of the ray and from those the one closest to the origin.
+                 * If several vertices are hit at the same distance, e.g. on a shared edge, the vertex with the lowest index is returned.
+                 * If the bounding volume hierarchy is built it is used to find the hit, otherwise every vertex is tested.
+                 * Both ways return the same result and allocate no memory on the heap.
                  */
                 hitResult evaluateHit(const vektor & origin, const vektor & direction) const {
-                    std::vector<hitResult> temp = intersect(origin, direction);
-                    if(temp.size()==0) {
+                    double t;
+                    int32_t closest = evaluate_closest(origin, direction, t);
+                    if(closest < 0) {
                         return hitResult();
                     }
-                    std::vector<double> distance;
-                    for(auto iter = temp.begin(); iter != temp.end(); ++iter) {
-                        distance.push_back(iter->get_distance(origin));
+                    hitResult output(true, origin + t*direction);
+                    output.element = closest;
+                    return output;
+                }
+
+                /*! \brief Calculate the closest hit of the ray
+                 *
+                 * This function does the same as evaluateHit(), but returns the ray parameter instead of the hit point.
+                 * \param origin Position from where the ray originates.
+                 * \param direction The direction in which the ray travels.
+                 * \param t Ray parameter of the hit, the hit point is origin + t*direction. Infinity if nothing is hit.
+                 * \return Index of the vertex that got hit, -1 if nothing is hit.
+                 */
+                int32_t evaluate_closest(const vektor & origin, const vektor & direction, double & t) const {
+                    uint32_t instance;
+                    return evaluate_closest(origin, direction, t, instance);
+                }
+
+                /*! \brief Calculate the closest hit of the ray and the copy of the mesh it hits
+                 *
+                 * This function does the same as evaluate_closest() and writes the index of the copy that got hit to instance,
+                 * 0 for a miss or if the mesh is not instanced.
+                 */
+                int32_t evaluate_closest(const vektor & origin, const vektor & direction, double & t, uint32_t & instance) const {
+                    double tClosest = std::numeric_limits<double>::infinity();
+                    int32_t closest = -1;
+                    instance = 0;
+                    if(m_instances.empty()) {
+                        closest_hit(origin, direction, tClosest, closest);
+                        t = tClosest;
+                        return closest;
                     }
-                    std::vector<double>::iterator minimum = std::min_element(distance.begin(), distance.end());
-                    uint32_t element = std::distance(distance.begin(), minimum);
-                    hitResult output = temp[std::distance(distance.begin(), minimum)];
-                    if(std::count(distance.begin(), distance.end(), *minimum) != 1) {
-                        output.hasHit = false;
+                    // visit the copies from the one closest to the origin outward, so the first hits prune the others
+                    uint32_t N = m_centre.size();
+                    double phi = atan2(origin.y, origin.x);
+                    uint32_t right = (std::lower_bound(m_centre.begin(), m_centre.end(), phi) - m_centre.begin()) % N;
+                    uint32_t left = (right + N - 1) % N;
+                    // the toroidal angle along a straight ray is monotonic, so it only sweeps over the angles between
+                    // the origin and the closest hit, or the asymptote of the ray
+                    double L = origin.x*direction.y - origin.y*direction.x;
+                    double sense = L > 0.0 ? 1.0 : -1.0;
+                    double sweep = toroidal_sweep(origin, direction, tClosest, sense);
+                    bool cull = L != 0.0 && m_halfWidth < 0.5*boost::math::constants::pi<double>();
+                    for(uint32_t n = 0; n < N; ++n) {
+                        uint32_t next;
+                        if(angular_distance(phi, m_centre[right]) <= angular_distance(phi, m_centre[left])) {
+                            next = right;
+                            right = (right + 1) % N;
+                        }
+                        else {
+                            next = left;
+                            left = (left + N - 1) % N;
+                        }
+                        if(cull && !within_sweep(phi, sense, sweep, m_centre[next])) {
+                            continue;
+                        }
+                        uint32_t k = m_order[next];
+                        double tBefore = tClosest;
+                        int32_t before = closest;
+                        closest_hit(rotate(origin, k, -1.0), rotate(direction, k, -1.0), tClosest, closest);
+                        if(tClosest != tBefore || closest != before) {
+                            instance = k;
+                            sweep = toroidal_sweep(origin, direction, tClosest, sense);
+                        }
                     }
-                    return output;
+                    t = tClosest;
+                    return closest;
                 }
 
                 /*! \brief Calculate the hit points of the rays
@@ -172,7 +389,9 @@ namespace wallLoad {
                  */
                 std::vector<hitResult> evaluateHits(const std::vector<vektor> & origins, 
                     const std::vector<vektor> & directions) const {
+                    readLock lock(m_mutex);
                     std::vector<hitResult> output;
+                    output.reserve(origins.size());
                     std::vector<vektor>::const_iterator origin = origins.begin();
                     std::vector<vektor>::const_iterator direction = directions.begin();
                     for( ; origin != origins.end(); ++origin, ++ direction) {
@@ -181,39 +400,166 @@ namespace wallLoad {
                     return output;
                 }
 
-                /*! \brief Calculate the hit points of the rays and return them as python list.
+                /*! \brief Get the mutex of the instance.
+                 *
+                 * Lock it for reading to keep the mesh unchanged while it is used by evaluate_closest() from several threads.
+                 */
+                instanceMutex & get_mutex() const {
+                    return m_mutex;
+                }
+
+                /*! \brief Set the copies of the mesh
+                 *
+                 * The mesh stands for one copy rotated by each of the given toroidal angles about the z axis, in radians.
+                 * An empty list removes the copies, so the mesh stands for itself only.
+                 */
+                void set_instances(const std::vector<double> & angles) {
+                    writeLock lock(m_mutex);
+                    m_instances = angles;
+                    m_rotation.resize(2*angles.size());
+                    for(uint32_t k = 0; k < angles.size(); ++k) {
+                        m_rotation[2*k] = cos(angles[k]);
+                        m_rotation[2*k + 1] = sin(angles[k]);
+                    }
+                    update_instances();
+                }
+
+                /*! \brief Set N copies of the mesh evenly spaced in the toroidal direction
+                 *
+                 * The kth copy is rotated by \f$2\pi k/N\f$, so a mesh of one of N sectors stands for the whole torus.
+                 */
+                void set_toroidal_instances(const uint32_t N) {
+                    std::vector<double> angles(N);
+                    for(uint32_t k = 0; k < N; ++k) {
+                        angles[k] = 2.0*boost::math::constants::pi<double>()*k/N;
+                    }
+                    set_instances(angles);
+                }
+
+                /*! \brief Get the rotation angles of the copies of the mesh, empty if it is not instanced. */
+                const std::vector<double> & get_instances() const {
+                    return m_instances;
+                }
+
+                /*! \brief Get the number of copies of the mesh, one if it is not instanced. */
+                uint32_t get_instance_count() const {
+                    return std::max<uint32_t>(1, m_instances.size());
+                }
+
+                /*! \brief Rotate a vector from the frame of the mesh to the one of the given copy, or back for a sign of -1. */
+                vektor rotate(const vektor & v, const uint32_t instance, const double sign = 1.0) const {
+                    if(m_rotation.empty()) {
+                        return v;
+                    }
+                    double c = m_rotation[2*instance];
+                    double s = sign*m_rotation[2*instance + 1];
+                    return vektor(c*v.x - s*v.y, s*v.x + c*v.y, v.z);
+                }
+
+                /*! \brief Get the number of vertices. */
+                uint32_t size() const {
+                    return m_indices.size()/3;
+                }
+
+                /*! \brief Check if the mesh has no vertices. */
+                bool empty() const {
+                    return m_indices.empty();
+                }
+
+                /*! \brief Get the ith vertex of the mesh without range check. */
+                vertex get_vertex(const uint32_t i) const {
+                    return vertex(get_node(m_indices[3*i]), get_node(m_indices[3*i + 1]), get_node(m_indices[3*i + 2]));
+                }
+
+                /*! \brief Get the ith vertex of the mesh
+                 *
+                 * The vertex is a copy, changing it does not change the mesh.
+                 * A std::out_of_range exception is thrown for an invalid index.
+                 */
+                vertex operator[] (const uint32_t i) const { 
+                    if(i >= size()) {
+                        throw std::out_of_range("vertex index out of range");
+                    }
+                    return get_vertex(i);
+                }
+
+                /*! \brief Get the coordinates of the nodes, three per node. */
+                const std::vector<double> & get_nodes() const {
+                    return m_nodes;
+                }
+
+                /*! \brief Get the node indices of the vertices, three per vertex. */
+                const std::vector<uint32_t> & get_indices() const {
+                    return m_indices;
+                }
+
+                /*! \brief Get the emissivity of every vertex
+                 *
+                 * By Kirchhoff's law the emissivity is also the fraction of the incident radiation which is absorbed,
+                 * the rest is reflected, see radiationLoad.
+                 */
+                const std::vector<double> & get_emissivity() const {
+                    return m_emissivity;
+                }
+
+                /*! \brief Set the emissivity of every vertex
+                 *
+                 * A std::invalid_argument exception is thrown if the number of values does not match the number of vertices
+                 * or a value is outside of [0,1].
+                 */
+                void set_emissivity(const std::vector<double> & emissivity) {
+                    if(emissivity.size() != size()) {
+                        throw std::invalid_argument("one emissivity per vertex is needed");
+                    }
+                    if(std::any_of(emissivity.begin(), emissivity.end(), [](const double e) { return !(e >= 0.0 && e <= 1.0); })) {
+                        throw std::invalid_argument("emissivity needs to be in [0,1]");
+                    }
+                    writeLock lock(m_mutex);
+                    m_emissivity = emissivity;
+                }
+
+                /*! \brief Set the emissivity of all vertices of the given physical group */
+                void set_emissivity(const int32_t physical, const double emissivity) {
+                    if(!(emissivity >= 0.0 && emissivity <= 1.0)) {
+                        throw std::invalid_argument("emissivity needs to be in [0,1]");
+                    }
+                    writeLock lock(m_mutex);
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        if(m_physical[i] == physical) {
+                            m_emissivity[i] = emissivity;
+                        }
+                    }
+                }
+
+                /*! \brief Get the physical group of every vertex, 0 if it has none. */
+                const std::vector<int32_t> & get_physical() const {
+                    return m_physical;
+                }
+
+                /*! \brief Get the physical group of every vertex as python list.
                  *
-                 * This function calculates the intersections of each ray with the mesh.
-                 * Only the real hit point of the each ray is returned.
-                 * This means only points that lie in the direction of the ray and from those the one closest to the origin.
                  * This function is intended as python interface.
                  * Do not use it from within C++.
                  */
-                boost::python::list evaluateHits_python(const boost::python::list & origins, 
-                    const boost::python::list & directions) {
-                    std::vector<vektor> tempOrigins;
-                    std::vector<vektor> tempDirections;
-                    uint32_t N = boost::python::len(origins);
-                    for(uint32_t i = 0; i < N; ++i) {
-                        tempOrigins.push_back(boost::python::extract<vektor>(origins[i]));
-                        tempDirections.push_back(boost::python::extract<vektor>(directions[i]));
-                    }
-                    std::vector<vektor>::iterator iterOrigins = tempOrigins.begin();
-                    std::vector<vektor>::iterator iterDirections = tempDirections.begin();
+                boost::python::list get_physical_python() const {
                     boost::python::list output;
-                    hitResult temp;
-                    for( ; iterOrigins != tempOrigins.end(); ++iterOrigins, ++iterDirections) {
-                        temp = evaluateHit(*iterOrigins, *iterDirections);
-                        if(temp.hasHit) {
-                            output.append(temp);
-                        }
+                    for(auto iter = m_physical.begin(); iter != m_physical.end(); ++iter) {
+                        output.append(*iter);
                     }
                     return output;
                 }
 
-                /*! \brief Get ith vertex of the mesh. */
-                vertex & operator[] (const uint32_t i) { 
-                    return std::vector<vertex>::operator[](i);
+                /*! \brief Get the names of the physical groups as python dictionary.
+                 *
+                 * This function is intended as python interface.
+                 * Do not use it from within C++.
+                 */
+                boost::python::dict get_physical_names_python() const {
+                    boost::python::dict output;
+                    for(auto iter = m_physicalNames.begin(); iter != m_physicalNames.end(); ++iter) {
+                        output[iter->first] = iter->second;
+                    }
+                    return output;
                 }
 
                 /*! \brief Calculate the areas of the vertices.
@@ -221,16 +567,255 @@ namespace wallLoad {
                  * This function calculates the area of each vertex in the mesh and returns the result as an array.
                  */
                 std::vector<double> get_areas() const {
-                    std::vector<double> output;
-                    for(std::vector<vertex>::const_iterator iter = begin(); iter != end(); ++iter) {
-                        output.push_back(iter->get_area());
+                    std::vector<double> output(size());
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        output[i] = get_vertex(i).get_area();
                     }
                     return output;
                 }
+
+                /*! \brief Get the toroidal extent of the mesh
+                 *
+                 * This function finds the smallest toroidal sector \f$[\varphi_{min}, \varphi_{min} + \Delta\varphi]\f$ which contains
+                 * the mesh, i.e. the complement of the largest toroidal gap between the nodes of its vertices, and the smallest and largest distance
+                 * of the mesh from the axis. The smallest distance is the one of the closest point of any edge.
+                 * If an edge spans the gap or passes the axis, or the mesh is empty, the sector is the whole torus with
+                 * \f$\Delta\varphi = 2\pi\f$. For an instanced mesh the sector contains all copies.
+                 */
+                void get_toroidal_extent(double & phiMin, double & phiWidth, double & Rmin, double & Rmax) const {
+                    const double twoPi = 2.0*boost::math::constants::pi<double>();
+                    phiMin = 0.0;
+                    phiWidth = twoPi;
+                    Rmin = std::numeric_limits<double>::infinity();
+                    Rmax = 0.0;
+                    std::vector<double> instances(m_instances.empty() ? std::vector<double>(1, 0.0) : m_instances);
+                    std::vector<double> phi(m_nodes.size()/3);
+                    std::vector<double> sorted;
+                    std::vector<uint8_t> used(phi.size(), 0);
+                    for(auto iter = m_indices.begin(); iter != m_indices.end(); ++iter) {
+                        if(!used[*iter]) {
+                            used[*iter] = 1;
+                            phi[*iter] = atan2(m_nodes[3*(*iter) + 1], m_nodes[3*(*iter)]);
+                            for(auto angle = instances.begin(); angle != instances.end(); ++angle) {
+                                double rotated = phi[*iter] + *angle + boost::math::constants::pi<double>();
+                                sorted.push_back(rotated - twoPi*floor(rotated/twoPi) - boost::math::constants::pi<double>());
+                            }
+                            Rmax = std::max(Rmax, hypot(m_nodes[3*(*iter)], m_nodes[3*(*iter) + 1]));
+                        }
+                    }
+                    for(uint32_t i = 0; i < m_indices.size(); ++i) {
+                        uint32_t a = m_indices[i];
+                        uint32_t b = m_indices[i % 3 == 2 ? i - 2 : i + 1];
+                        double ax = m_nodes[3*a], ay = m_nodes[3*a + 1];
+                        double dx = m_nodes[3*b] - ax, dy = m_nodes[3*b + 1] - ay;
+                        double length = dx*dx + dy*dy;
+                        double t = length > 0.0 ? std::min(1.0, std::max(0.0, -(ax*dx + ay*dy)/length)) : 0.0;
+                        Rmin = std::min(Rmin, hypot(ax + t*dx, ay + t*dy));
+                    }
+                    if(sorted.empty() || Rmin <= 0.0) {
+                        return;
+                    }
+                    std::sort(sorted.begin(), sorted.end());
+                    double gap = sorted.front() + twoPi - sorted.back();
+                    double start = sorted.front();
+                    for(uint32_t i = 1; i < sorted.size(); ++i) {
+                        if(sorted[i] - sorted[i - 1] > gap) {
+                            gap = sorted[i] - sorted[i - 1];
+                            start = sorted[i];
+                        }
+                    }
+                    bool wrapped = false;
+                    for(auto angle = instances.begin(); angle != instances.end(); ++angle) {
+                        for(uint32_t i = 0; i < m_indices.size() && !wrapped; ++i) {
+                            double a = phi[m_indices[i]] + *angle - start;
+                            double b = phi[m_indices[i % 3 == 2 ? i - 2 : i + 1]] + *angle - start;
+                            wrapped = fabs(a - twoPi*floor(a/twoPi) - b + twoPi*floor(b/twoPi)) > boost::math::constants::pi<double>();
+                        }
+                    }
+                    if(!wrapped) {
+                        phiMin = start;
+                        phiWidth = twoPi - gap;
+                    }
+                }
             protected:
+                /*! \brief Copy constructor
+                 *
+                 * This constructor copies the given instance while the given lock keeps it unchanged.
+                 * The public copy constructor does not lock, since the classes holding a mesh copy it under their own lock of it.
+                 */
+                mesh(const mesh & rhs, const readLock &) :
+                    mesh(rhs) {
+                }
+
+                /*! \brief Toroidal angle swept by the ray from its origin to t, in the sense given by the sign of its angular momentum. */
+                static double toroidal_sweep(const vektor & origin, const vektor & direction, const double t, const double sense) {
+                    double x = direction.x, y = direction.y;
+                    if(t != std::numeric_limits<double>::infinity()) {
+                        x = origin.x + t*direction.x;
+                        y = origin.y + t*direction.y;
+                    }
+                    return sense*atan2(origin.x*y - origin.y*x, origin.x*x + origin.y*y);
+                }
+
+                /*! \brief Check if the copy centred at the given angle may reach into the sweep of a ray from phi. */
+                bool within_sweep(const double phi, const double sense, const double sweep, const double centre) const {
+                    const double twoPi = 2.0*boost::math::constants::pi<double>();
+                    const double tolerance = 1e-9;
+                    double offset = sense*(centre - phi);
+                    offset -= twoPi*floor(offset/twoPi + 0.5);
+                    for(int32_t shift = -1; shift <= 1; ++shift) {
+                        double position = offset + shift*twoPi;
+                        if(position + m_halfWidth >= -tolerance && position - m_halfWidth <= sweep + tolerance) {
+                            return true;
+                        }
+                    }
+                    return false;
+                }
+
+                /*! \brief Update the toroidal extent and the order of the copies without locking the instance
+                 *
+                 * The centre and half width of the mesh are taken from its nodes, so this is needed whenever the copies or the nodes change.
+                 */
+                void update_instances() {
+                    double x = 0.0, y = 0.0;
+                    for(auto iter = m_indices.begin(); iter != m_indices.end(); ++iter) {
+                        double R = hypot(m_nodes[3*(*iter)], m_nodes[3*(*iter) + 1]);
+                        if(R > 0.0) {
+                            x += m_nodes[3*(*iter)]/R;
+                            y += m_nodes[3*(*iter) + 1]/R;
+                        }
+                    }
+                    double centre = atan2(y, x);
+                    m_halfWidth = 0.0;
+                    for(auto iter = m_indices.begin(); iter != m_indices.end(); ++iter) {
+                        double phi = atan2(m_nodes[3*(*iter) + 1], m_nodes[3*(*iter)]);
+                        m_halfWidth = std::max(m_halfWidth, angular_distance(phi, centre));
+                    }
+                    std::vector<std::pair<double, uint32_t> > order(m_instances.size());
+                    for(uint32_t k = 0; k < m_instances.size(); ++k) {
+                        order[k] = std::make_pair(atan2(sin(centre + m_instances[k]), cos(centre + m_instances[k])), k);
+                    }
+                    std::sort(order.begin(), order.end());
+                    m_order.resize(order.size());
+                    m_centre.resize(order.size());
+                    for(uint32_t k = 0; k < order.size(); ++k) {
+                        m_centre[k] = order[k].first;
+                        m_order[k] = order[k].second;
+                    }
+                }
+
+                /*! \brief Distance of two toroidal angles in \f$[-\pi,\pi[\f$ around the torus. */
+                static double angular_distance(const double a, const double b) {
+                    double distance = fabs(a - b);
+                    return std::min(distance, 2.0*boost::math::constants::pi<double>() - distance);
+                }
+
+                /*! \brief Improve the closest hit of the ray with the vertices of the mesh, without copies.
+                 *
+                 * If the hierarchy is built, it is used, otherwise every vertex is tested.
+                 */
+                void closest_hit(const vektor & origin, const vektor & direction, double & tClosest, int32_t & closest) const {
+                    if(!m_hierarchy.empty()) {
+                        m_hierarchy.evaluate_closest(m_triangles, origin, direction, tClosest, closest);
+                        return;
+                    }
+                    double t;
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        if(get_vertex(i).intersect_before(origin, direction, tClosest, t) && t < tClosest) {
+                            tClosest = t;
+                            closest = i;
+                        }
+                    }
+                }
+
+                /*! \brief Read the vertices from a *.msh file with the given number of threads. */
+                void read_msh(const std::string & filename, const uint32_t threads) {
+                    mshFile file(filename, threads > 0 ? threads : std::thread::hardware_concurrency());
+                    m_nodes.swap(file.get_nodes());
+                    m_indices.swap(file.get_triangles());
+                    m_emissivity.assign(size(), 1.0);
+                    m_physical = file.get_physical();
+                    m_physicalNames = file.get_physical_names();
+                    m_source = meshCache::get_source(filename);
+                    build_hierarchy();
+                }
+
+                /*! \brief Read the vertices from a mesh cache, the hierarchy uses the mapped file. */
+                void read_cache(const meshCache & file) {
+                    m_nodes.assign(file.get_nodes().begin(), file.get_nodes().end());
+                    m_indices.assign(file.get_triangles().begin(), file.get_triangles().end());
+                    m_emissivity.assign(file.get_emissivity().begin(), file.get_emissivity().end());
+                    m_physical.assign(file.get_physical().begin(), file.get_physical().end());
+                    m_physicalNames = file.get_physical_names();
+                    m_source = file.get_source();
+                    m_fromCache = true;
+                    if(file.has_hierarchy()) {
+                        file.assign(m_hierarchy, m_triangles);
+                    }
+                }
+
+                /*! \brief Get the ith node as vektor. */
+                vektor get_node(const uint32_t i) const {
+                    return vektor(m_nodes[3*i], m_nodes[3*i + 1], m_nodes[3*i + 2]);
+                }
+
+                /*! \brief Add the points of the vertex as new nodes and the vertex as their indices. */
+                void add_vertex(const vertex & rhs) {
+                    const vektor * points[3] = {&rhs.p1, &rhs.p2, &rhs.p3};
+                    for(uint32_t k = 0; k < 3; ++k) {
+                        m_indices.push_back(m_nodes.size()/3);
+                        m_nodes.push_back(points[k]->x);
+                        m_nodes.push_back(points[k]->y);
+                        m_nodes.push_back(points[k]->z);
+                    }
+                }
+
+                /*! \brief Merge nodes with identical coordinates
+                 *
+                 * This function sorts the nodes by their coordinates, stores every distinct point once and updates the indices.
+                 */
+                void merge_nodes() {
+                    uint32_t N = m_nodes.size()/3;
+                    std::vector<uint32_t> order(N);
+                    for(uint32_t i = 0; i < N; ++i) {
+                        order[i] = i;
+                    }
+                    const double * x = m_nodes.data();
+                    std::sort(order.begin(), order.end(), [x](const uint32_t a, const uint32_t b) {
+                        return std::lexicographical_compare(x + 3*a, x + 3*a + 3, x + 3*b, x + 3*b + 3);
+                    });
+                    std::vector<double> nodes;
+                    std::vector<uint32_t> index(N);
+                    for(uint32_t i = 0; i < N; ++i) {
+                        const double * point = x + 3*order[i];
+                        if(i == 0 || !std::equal(point, point + 3, nodes.end() - 3)) {
+                            nodes.insert(nodes.end(), point, point + 3);
+                        }
+                        index[order[i]] = nodes.size()/3 - 1;
+                    }
+                    for(auto iter = m_indices.begin(); iter != m_indices.end(); ++iter) {
+                        *iter = index[*iter];
+                    }
+                    m_nodes.swap(nodes);
+                }
+
+                std::vector<double> m_nodes; /*!< \brief Coordinates of the nodes, three per node. */
+                std::vector<uint32_t> m_indices; /*!< \brief Node indices of the vertices, three per vertex. */
                 std::vector<double> m_emissivity; /*!< \brief Emissivity of the wall elements. */
-                boost::random::mt19937 m_generator; /*!< \brief Random number generator */
+                std::vector<int32_t> m_physical; /*!< \brief Physical group of the wall elements. */
+                std::map<int32_t, std::string> m_physicalNames; /*!< \brief Names of the physical groups. */
+                philox m_generator; /*!< \brief Random number generator */
                 boost::random::uniform_01<double> m_uniform; /*!< \brief Uniform random distribution \f$[0,1[\f$. */
+                boundingVolumeHierarchy m_hierarchy; /*!< \brief Bounding volume hierarchy for the intersection tests. */
+                triangleStore m_triangles; /*!< \brief Vertices in leaf order of the hierarchy for the intersection tests. */
+                meshCache::source m_source; /*!< \brief Fingerprint of the *.msh file the mesh was read from. */
+                bool m_fromCache; /*!< \brief Information if the mesh was loaded from a cache. */
+                std::vector<double> m_instances; /*!< \brief Rotation angles of the copies of the mesh, empty for a single one. */
+                std::vector<double> m_rotation; /*!< \brief Cosine and sine of the rotation angle of every copy. */
+                std::vector<uint32_t> m_order; /*!< \brief Copies sorted by the toroidal angle of their centre. */
+                std::vector<double> m_centre; /*!< \brief Sorted toroidal angles of the centres of the copies. */
+                double m_halfWidth; /*!< \brief Largest toroidal angle between a node and the centre of the mesh. */
+                mutable instanceMutex m_mutex; /*!< \brief Mutex guarding the instance. */
 
         };
     }
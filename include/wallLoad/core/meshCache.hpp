@@ -0,0 +1,348 @@
+#ifndef include_wallLoad_core_meshCache_hpp
+#define include_wallLoad_core_meshCache_hpp
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <wallLoad/core/mappedFile.hpp>
+#include <wallLoad/core/sharedArray.hpp>
+#include <wallLoad/core/boundingVolumeHierarchy.hpp>
+#include <wallLoad/core/triangleStore.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Binary cache of a mesh.
+         *
+         * This class reads and writes a binary file with everything needed to trace rays through a mesh:
+         * the nodes and the indexed triangles, the physical group and the emissivity of every triangle,
+         * the bounding volume hierarchy and the structure of arrays of the triangleStore.
+         * The file is memory mapped when it is read. The hierarchy and the triangleStore use the mapped arrays directly,
+         * so opening a cache is fast and processes on the same node share the read only pages.
+         * The size and modification time of the source file are stored, so that a changed source can be detected.
+         * The file starts with a header holding a magic string, the format version, a byte order mark and the position
+         * of each section. All sections start at a multiple of 64 bytes and are in the byte order of the writing machine.
+         * All errors are reported as std::runtime_error.
+         */
+        class meshCache {
+            public:
+                /*! \brief Fingerprint of the source file of a cache. */
+                struct source {
+                    uint64_t size; /*!< \brief Size of the source file in bytes. */
+                    int64_t time; /*!< \brief Modification time of the source file in nanoseconds. */
+
+                    /*! \brief Check if two fingerprints are equal. */
+                    bool operator==(const source & rhs) const {
+                        return size == rhs.size && time == rhs.time;
+                    }
+                };
+
+                /*! \brief Sections of the file. */
+                enum section {
+                    nodes, /*!< \brief Coordinates of the nodes, three doubles per node. */
+                    triangles, /*!< \brief Node indices of the triangles, three uint32_t per triangle. */
+                    physical, /*!< \brief Physical group of every triangle as int32_t. */
+                    emissivity, /*!< \brief Emissivity of every triangle as double. */
+                    hierarchyNodes, /*!< \brief Nodes of the bounding volume hierarchy. */
+                    hierarchyIndices, /*!< \brief Triangle indices in leaf order of the hierarchy as uint32_t. */
+                    coordinates, /*!< \brief First of the nine coordinate arrays of the triangleStore, see triangleStore::get_coordinates(). */
+                    elements = coordinates + 9, /*!< \brief Element index of every entry of the triangleStore as int32_t. */
+                    names, /*!< \brief Physical names as lines "tag name". */
+                    numberOfSections /*!< \brief Number of sections. */
+                };
+
+                /*! \brief Constructor
+                 *
+                 * This constructor maps and checks the given cache file.
+                 */
+                meshCache(const std::string & filename) : m_file(std::make_shared<mappedFile>(filename, false)), m_header() {
+                    if(m_file->size() < sizeof(header)) {
+                        fail("the file is too short");
+                    }
+                    memcpy(&m_header, m_file->begin(), sizeof(header));
+                    if(memcmp(m_header.magic, s_magic, sizeof(m_header.magic)) != 0) {
+                        fail("the file is not a mesh cache");
+                    }
+                    if(m_header.byteOrder != s_byteOrder) {
+                        fail("the byte order of the file differs from this machine");
+                    }
+                    if(m_header.version != s_version) {
+                        fail("the cache has the version " + std::to_string(m_header.version) + " instead of " + std::to_string(s_version));
+                    }
+                    for(uint32_t i = 0; i < numberOfSections; ++i) {
+                        if(m_header.offset[i] % s_alignment != 0 || m_header.offset[i] > m_file->size() ||
+                            m_header.count[i] > (m_file->size() - m_header.offset[i])/element_size(i)) {
+                            fail("section " + std::to_string(i) + " lies outside of the file");
+                        }
+                    }
+                    uint64_t Nnodes = m_header.count[nodes]/3;
+                    uint64_t Ntriangles = m_header.count[triangles]/3;
+                    bool consistent = m_header.count[nodes] % 3 == 0 && m_header.count[triangles] % 3 == 0 &&
+                        m_header.count[physical] == Ntriangles && m_header.count[emissivity] == Ntriangles &&
+                        (m_header.count[hierarchyIndices] == Ntriangles || m_header.count[hierarchyNodes] == 0) &&
+                        m_header.count[elements] == m_header.count[hierarchyIndices];
+                    for(uint32_t k = 0; k < 9; ++k) {
+                        consistent = consistent && m_header.count[coordinates + k] ==
+                            (m_header.count[elements] > 0 ? m_header.count[elements] + triangleStore::get_padding() : 0);
+                    }
+                    if(!consistent) {
+                        fail("the sizes of the sections do not match");
+                    }
+                    const uint32_t * indices = get_array<uint32_t>(triangles).data();
+                    for(uint64_t i = 0; i < 3*Ntriangles; ++i) {
+                        if(indices[i] >= Nnodes) {
+                            fail("a triangle references a node which does not exist");
+                        }
+                    }
+                    sharedArray<uint32_t> order = get_array<uint32_t>(hierarchyIndices);
+                    for(uint64_t i = 0; i < order.size(); ++i) {
+                        if(order[i] >= Ntriangles) {
+                            fail("the hierarchy references a triangle which does not exist");
+                        }
+                    }
+                    check_hierarchy();
+                }
+
+                /*! \brief Get the fingerprint of the source the cache was written for. */
+                source get_source() const {
+                    source output;
+                    output.size = m_header.sourceSize;
+                    output.time = m_header.sourceTime;
+                    return output;
+                }
+
+                /*! \brief Get the coordinates of the nodes, three per node. */
+                sharedArray<double> get_nodes() const {
+                    return get_array<double>(nodes);
+                }
+
+                /*! \brief Get the node indices of the triangles, three per triangle. */
+                sharedArray<uint32_t> get_triangles() const {
+                    return get_array<uint32_t>(triangles);
+                }
+
+                /*! \brief Get the physical group of every triangle. */
+                sharedArray<int32_t> get_physical() const {
+                    return get_array<int32_t>(physical);
+                }
+
+                /*! \brief Get the emissivity of every triangle. */
+                sharedArray<double> get_emissivity() const {
+                    return get_array<double>(emissivity);
+                }
+
+                /*! \brief Check if the cache holds a bounding volume hierarchy. */
+                bool has_hierarchy() const {
+                    return m_header.count[hierarchyNodes] > 0;
+                }
+
+                /*! \brief Set up the given hierarchy and triangleStore with the mapped arrays. */
+                void assign(boundingVolumeHierarchy & hierarchy, triangleStore & store) const {
+                    hierarchy.assign(get_array<boundingVolumeHierarchy::node>(hierarchyNodes), get_array<uint32_t>(hierarchyIndices));
+                    sharedArray<double> arrays[9];
+                    for(uint32_t k = 0; k < 9; ++k) {
+                        arrays[k] = get_array<double>(coordinates + k);
+                    }
+                    store.assign(arrays, get_array<int32_t>(elements));
+                }
+
+                /*! \brief Get the physical names. */
+                std::map<int32_t, std::string> get_physical_names() const {
+                    std::map<int32_t, std::string> output;
+                    std::istringstream text(std::string(m_file->begin() + m_header.offset[names], m_header.count[names]));
+                    int32_t tag;
+                    std::string name;
+                    while(text >> tag && std::getline(text, name)) {
+                        output[tag] = name.substr(name.empty() ? 0 : 1);
+                    }
+                    return output;
+                }
+
+                /*! \brief Get the fingerprint of a file
+                 *
+                 * A std::runtime_error is thrown if the file does not exist.
+                 */
+                static source get_source(const std::string & filename) {
+                    struct stat status;
+                    if(stat(filename.c_str(), &status) != 0) {
+                        throw std::runtime_error("Could not read the status of " + filename + ": " + strerror(errno));
+                    }
+                    source output;
+                    output.size = status.st_size;
+                    output.time = int64_t(status.st_mtim.tv_sec)*1000000000 + status.st_mtim.tv_nsec;
+                    return output;
+                }
+
+                /*! \brief Check if the given file starts like a mesh cache. */
+                static bool is_cache(const std::string & filename) {
+                    char magic[sizeof(s_magic)];
+                    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+                    return file.read(magic, sizeof(magic)) && memcmp(magic, s_magic, sizeof(magic)) == 0;
+                }
+
+                /*! \brief Write a cache
+                 *
+                 * This function writes the given mesh data to a temporary file, which then replaces the given file.
+                 * Processes that have mapped the old file keep using it.
+                 * The hierarchy and the store may be empty.
+                 */
+                static void write(const std::string & filename, const source & origin, const std::vector<double> & nodeCoordinates,
+                    const std::vector<uint32_t> & nodeIndices, const std::vector<int32_t> & physicalGroups,
+                    const std::vector<double> & emissivities, const boundingVolumeHierarchy & hierarchy, const triangleStore & store,
+                    const std::map<int32_t, std::string> & physicalNames) {
+                    std::string nameText;
+                    for(auto iter = physicalNames.begin(); iter != physicalNames.end(); ++iter) {
+                        nameText += std::to_string(iter->first) + " " + iter->second + "\n";
+                    }
+                    const void * data[numberOfSections];
+                    header head;
+                    memset(&head, 0, sizeof(head));
+                    memcpy(head.magic, s_magic, sizeof(head.magic));
+                    head.version = s_version;
+                    head.byteOrder = s_byteOrder;
+                    head.sourceSize = origin.size;
+                    head.sourceTime = origin.time;
+                    set_section(head, data, nodes, nodeCoordinates.data(), nodeCoordinates.size());
+                    set_section(head, data, triangles, nodeIndices.data(), nodeIndices.size());
+                    set_section(head, data, physical, physicalGroups.data(), physicalGroups.size());
+                    set_section(head, data, emissivity, emissivities.data(), emissivities.size());
+                    set_section(head, data, hierarchyNodes, hierarchy.get_nodes().data(), hierarchy.get_nodes().size());
+                    set_section(head, data, hierarchyIndices, hierarchy.get_indices().data(), hierarchy.get_indices().size());
+                    for(uint32_t k = 0; k < 9; ++k) {
+                        set_section(head, data, coordinates + k, store.get_coordinates(k).data(), store.get_coordinates(k).size());
+                    }
+                    set_section(head, data, elements, store.get_elements().data(), store.get_elements().size());
+                    set_section(head, data, names, nameText.data(), nameText.size());
+                    uint64_t position = sizeof(header);
+                    for(uint32_t i = 0; i < numberOfSections; ++i) {
+                        position = (position + s_alignment - 1)/s_alignment*s_alignment;
+                        head.offset[i] = position;
+                        position += head.count[i]*element_size(i);
+                    }
+
+                    std::string temporary = filename + ".tmp" + std::to_string(getpid());
+                    std::ofstream file(temporary.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                    if(!file.is_open()) {
+                        throw std::runtime_error("Could not open " + temporary + " for writing");
+                    }
+                    file.write(reinterpret_cast<const char *>(&head), sizeof(head));
+                    position = sizeof(header);
+                    const char zeros[s_alignment] = {0};
+                    for(uint32_t i = 0; i < numberOfSections; ++i) {
+                        file.write(zeros, head.offset[i] - position);
+                        file.write(static_cast<const char *>(data[i]), head.count[i]*element_size(i));
+                        position = head.offset[i] + head.count[i]*element_size(i);
+                    }
+                    file.close();
+                    if(!file || rename(temporary.c_str(), filename.c_str()) != 0) {
+                        unlink(temporary.c_str());
+                        throw std::runtime_error("Could not write " + filename);
+                    }
+                }
+
+            protected:
+                /*! \brief Header of the file. */
+                struct header {
+                    char magic[8]; /*!< \brief Magic string "wallLoad". */
+                    uint32_t version; /*!< \brief Version of the format. */
+                    uint32_t byteOrder; /*!< \brief Byte order mark. */
+                    uint64_t sourceSize; /*!< \brief Size of the source file. */
+                    int64_t sourceTime; /*!< \brief Modification time of the source file in nanoseconds. */
+                    uint64_t offset[numberOfSections]; /*!< \brief Position of each section in bytes. */
+                    uint64_t count[numberOfSections]; /*!< \brief Number of elements of each section. */
+                };
+
+                static_assert(std::is_trivially_copyable<boundingVolumeHierarchy::node>::value, "hierarchy nodes must be trivially copyable");
+
+                /*! \brief Get the size of an element of the given section in bytes. */
+                static uint64_t element_size(const uint32_t i) {
+                    if(i == nodes || i == emissivity || (i >= coordinates && i < elements)) {
+                        return sizeof(double);
+                    }
+                    if(i == hierarchyNodes) {
+                        return sizeof(boundingVolumeHierarchy::node);
+                    }
+                    if(i == names) {
+                        return 1;
+                    }
+                    return sizeof(uint32_t);
+                }
+
+                /*! \brief Set the data and the number of elements of a section. */
+                static void set_section(header & head, const void ** data, const uint32_t i, const void * sectionData, const uint64_t count) {
+                    data[i] = sectionData;
+                    head.count[i] = count;
+                }
+
+                /*! \brief Get a section as array of T, which shares the mapping. */
+                template<class T>
+                sharedArray<T> get_array(const uint32_t i) const {
+                    return sharedArray<T>(m_file, reinterpret_cast<const T *>(m_file->begin() + m_header.offset[i]), m_header.count[i]);
+                }
+
+                /*! \brief Throw a std::runtime_error with the name of the file. */
+                void fail(const std::string & message) const {
+                    throw std::runtime_error(m_file->get_filename() + ": " + message);
+                }
+
+                /*! \brief Check the nodes of the hierarchy
+                 *
+                 * The nodes are stored depth first, so the left child of an inner node follows it and the right child comes later.
+                 * Every node but the root needs exactly one parent, the leaves have to lie within the triangleStore
+                 * and the depth may not exceed boundingVolumeHierarchy::get_max_depth(), so traversal stays within its stack.
+                 */
+                void check_hierarchy() const {
+                    sharedArray<boundingVolumeHierarchy::node> hierarchy = get_array<boundingVolumeHierarchy::node>(hierarchyNodes);
+                    uint64_t N = hierarchy.size();
+                    uint64_t Nentries = m_header.count[elements];
+                    std::vector<uint32_t> depth(N, 0);
+                    std::vector<bool> reached(N, false);
+                    for(uint64_t i = 0; i < N; ++i) {
+                        const boundingVolumeHierarchy::node & current = hierarchy[i];
+                        if(i > 0 && !reached[i]) {
+                            fail("the hierarchy contains a node which is not reached from the root");
+                        }
+                        if(current.count > 0) {
+                            if(uint64_t(current.offset) + current.count > Nentries) {
+                                fail("a leaf of the hierarchy references triangles which do not exist");
+                            }
+                            continue;
+                        }
+                        if(i + 1 >= N || current.offset <= i + 1 || current.offset >= N) {
+                            fail("an inner node of the hierarchy references a child which does not exist");
+                        }
+                        if(depth[i] + 1 > boundingVolumeHierarchy::get_max_depth()) {
+                            fail("the hierarchy is deeper than " + std::to_string(boundingVolumeHierarchy::get_max_depth()) + " levels");
+                        }
+                        uint64_t children[2] = {i + 1, current.offset};
+                        for(uint32_t k = 0; k < 2; ++k) {
+                            if(reached[children[k]]) {
+                                fail("a node of the hierarchy has several parents");
+                            }
+                            reached[children[k]] = true;
+                            depth[children[k]] = depth[i] + 1;
+                        }
+                    }
+                }
+
+                static constexpr char s_magic[8] = {'w', 'a', 'l', 'l', 'L', 'o', 'a', 'd'}; /*!< \brief Magic string at the start of the file. */
+                static const uint32_t s_version = 1; /*!< \brief Version of the format. */
+                static const uint32_t s_byteOrder = 0x01020304; /*!< \brief Byte order mark. */
+                static const uint64_t s_alignment = 64; /*!< \brief Alignment of the sections in bytes. */
+
+                std::shared_ptr<mappedFile> m_file; /*!< \brief Mapping of the file. */
+                header m_header; /*!< \brief Header of the file. */
+        };
+    }
+}
+
+#endif
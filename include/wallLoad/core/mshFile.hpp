@@ -0,0 +1,607 @@
+#ifndef include_wallLoad_core_mshFile_hpp
+#define include_wallLoad_core_mshFile_hpp
+
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <wallLoad/core/mappedFile.hpp>
+#include <wallLoad/core/textParser.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Reader for *.msh files created by gmsh.
+         *
+         * This class reads the nodes and the triangles of a gmsh mesh in the formats 2.x and 4.1, both ASCII and binary.
+         * The file is memory mapped. The node and element lines of the ASCII formats are split into chunks
+         * that are parsed on several threads.
+         * Node tags do not need to be contiguous, the triangles are returned as indices into the list of nodes.
+         * Triangles (element type 2) and second order triangles (type 9, only their corners) are read,
+         * all other elements are skipped.
+         * For every triangle the physical group is kept: the first tag of the element in format 2.x and the
+         * first physical tag of its surface in format 4.1. Triangles without physical group get 0.
+         * All errors are reported as std::runtime_error with the position in the file.
+         */
+        class mshFile {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor reads the given file with the given number of threads.
+                 */
+                mshFile(const std::string & filename, const uint32_t threads) :
+                    m_threads(std::max(1u, threads)), m_version(0.0), m_binary(false), m_dataSize(8) {
+                    mappedFile file(filename);
+                    textParser parser(file.begin(), file.end(), filename);
+                    bool hasNodes = false;
+                    while(!parser.at_end()) {
+                        std::string section = parser.read_line();
+                        while(!section.empty() && section.back() == ' ') section.pop_back();
+                        if(section.size() < 2 || section[0] != '$') {
+                            parser.fail("expected the start of a section instead of \"" + excerpt(section) + "\"");
+                        }
+                        section.erase(0, 1);
+                        if(section == "MeshFormat") {
+                            read_format(parser);
+                        }
+                        else if(m_version == 0.0) {
+                            parser.fail("the file must start with $MeshFormat");
+                        }
+                        else if(section == "PhysicalNames") {
+                            read_physical_names(parser);
+                        }
+                        else if(section == "Entities" && m_version >= 4.0) {
+                            read_entities(parser);
+                        }
+                        else if(section == "Nodes") {
+                            if(m_version >= 4.0) {
+                                read_nodes_v4(parser);
+                            }
+                            else {
+                                read_nodes_v2(parser);
+                            }
+                            hasNodes = true;
+                        }
+                        else if(section == "Elements") {
+                            if(m_version >= 4.0) {
+                                read_elements_v4(parser);
+                            }
+                            else {
+                                read_elements_v2(parser);
+                            }
+                        }
+                        else {
+                            skip_section(parser, section);
+                            continue;
+                        }
+                        read_end(parser, section);
+                    }
+                    if(m_version == 0.0) {
+                        parser.fail("no $MeshFormat section");
+                    }
+                    if(!hasNodes) {
+                        parser.fail("no $Nodes section");
+                    }
+                    resolve(parser);
+                }
+
+                /*! \brief Get the coordinates of the nodes, three per node. */
+                const std::vector<double> & get_nodes() const {
+                    return m_nodes;
+                }
+
+                /*! \brief Get the coordinates of the nodes, three per node, e.g. to swap them into a mesh. */
+                std::vector<double> & get_nodes() {
+                    return m_nodes;
+                }
+
+                /*! \brief Get the triangles as three indices into the nodes per triangle. */
+                const std::vector<uint32_t> & get_triangles() const {
+                    return m_triangles;
+                }
+
+                /*! \brief Get the triangles as three indices into the nodes per triangle, e.g. to swap them into a mesh. */
+                std::vector<uint32_t> & get_triangles() {
+                    return m_triangles;
+                }
+
+                /*! \brief Get the physical group of every triangle. */
+                const std::vector<int32_t> & get_physical() const {
+                    return m_physical;
+                }
+
+                /*! \brief Get the names of the two dimensional physical groups. */
+                const std::map<int32_t, std::string> & get_physical_names() const {
+                    return m_physicalNames;
+                }
+
+                /*! \brief Get the version of the file format. */
+                double get_version() const {
+                    return m_version;
+                }
+
+            protected:
+                /*! \brief Get the number of nodes of the given element type, 0 if the type is unknown. */
+                static uint32_t nodes_per_element(const int64_t type) {
+                    static const uint32_t table[] = {0, 2, 3, 4, 4, 8, 6, 5, 3, 6, 9, 10, 27, 18, 14, 1, 8, 20, 15, 13,
+                        9, 10, 12, 15, 15, 21, 4, 5, 6, 20, 35, 56};
+                    return (type > 0 && type < int64_t(sizeof(table)/sizeof(table[0]))) ? table[type] : 0;
+                }
+
+                /*! \brief Check if the element type is a triangle with its corners as first three nodes. */
+                static bool is_triangle(const int64_t type) {
+                    return type == 2 || type == 9;
+                }
+
+                /*! \brief Read the $MeshFormat section. */
+                void read_format(textParser & parser) {
+                    m_version = parser.read_double("the version");
+                    int64_t fileType = parser.read_integer("the file type");
+                    int64_t dataSize = parser.read_integer("the data size");
+                    if(m_version < 2.0 || m_version >= 5.0 || (m_version >= 3.0 && m_version < 4.1)) {
+                        char version[32];
+                        snprintf(version, sizeof(version), "%g", m_version);
+                        parser.fail(std::string("gmsh format ") + version + " is not supported, save the mesh as version 2.2 or 4.1");
+                    }
+                    if(dataSize != 4 && dataSize != 8) {
+                        parser.fail("unsupported data size " + std::to_string(dataSize));
+                    }
+                    m_binary = (fileType == 1);
+                    m_dataSize = dataSize;
+                    parser.skip_line();
+                    if(m_binary) {
+                        if(read_binary<int32_t>(parser, "the byte order") != 1) {
+                            parser.fail("the byte order of the binary file differs from this machine");
+                        }
+                        if(m_version < 4.0 && m_dataSize != sizeof(double)) {
+                            parser.fail("binary files of format 2 must use a data size of 8");
+                        }
+                    }
+                }
+
+                /*! \brief Read the $PhysicalNames section, only the names of surfaces are kept. */
+                void read_physical_names(textParser & parser) {
+                    int64_t N = parser.read_integer("the number of physical names");
+                    for(int64_t i = 0; i < N; ++i) {
+                        int64_t dimension = parser.read_integer("the dimension of a physical group");
+                        int64_t tag = parser.read_integer("the tag of a physical group");
+                        parser.skip_whitespace();
+                        std::string name = parser.read_line();
+                        while(!name.empty() && name.back() == ' ') name.pop_back();
+                        if(name.size() >= 2 && name.front() == '"' && name.back() == '"') {
+                            name = name.substr(1, name.size() - 2);
+                        }
+                        if(dimension == 2) {
+                            m_physicalNames[tag] = name;
+                        }
+                    }
+                }
+
+                /*! \brief Read the $Entities section of format 4.1, only the physical tags of surfaces are kept. */
+                void read_entities(textParser & parser) {
+                    uint64_t N[4];
+                    for(uint32_t i = 0; i < 4; ++i) {
+                        N[i] = m_binary ? read_size(parser, "the number of entities") : parser.read_integer("the number of entities");
+                    }
+                    if(!m_binary) {
+                        parser.skip_line();
+                    }
+                    for(uint32_t dimension = 0; dimension < 4; ++dimension) {
+                        for(uint64_t i = 0; i < N[dimension]; ++i) {
+                            if(!m_binary) {
+                                if(dimension == 2) {
+                                    int64_t tag = parser.read_integer("the tag of a surface");
+                                    for(uint32_t j = 0; j < 6; ++j) {
+                                        parser.read_double("the bounding box of a surface");
+                                    }
+                                    int64_t Nphysical = parser.read_integer("the number of physical tags");
+                                    m_surfacePhysical[tag] = Nphysical > 0 ? parser.read_integer("a physical tag") : 0;
+                                }
+                                parser.skip_line();
+                                continue;
+                            }
+                            int32_t tag = read_binary<int32_t>(parser, "the tag of an entity");
+                            skip_binary(parser, (dimension == 0 ? 3 : 6)*sizeof(double), "the bounding box of an entity");
+                            uint64_t Nphysical = read_size(parser, "the number of physical tags");
+                            std::vector<int32_t> physical(Nphysical);
+                            read_binary_array(parser, physical.data(), Nphysical, "the physical tags");
+                            if(dimension == 2) {
+                                m_surfacePhysical[tag] = Nphysical > 0 ? physical[0] : 0;
+                            }
+                            if(dimension > 0) {
+                                uint64_t Nbounding = read_size(parser, "the number of bounding entities");
+                                skip_binary(parser, Nbounding*sizeof(int32_t), "the bounding entities");
+                            }
+                        }
+                    }
+                }
+
+                /*! \brief Read the $Nodes section of format 2.x. */
+                void read_nodes_v2(textParser & parser) {
+                    int64_t N = parser.read_integer("the number of nodes");
+                    if(N < 0) {
+                        parser.fail("the number of nodes must not be negative");
+                    }
+                    parser.skip_line();
+                    uint64_t offset = m_nodeTags.size();
+                    m_nodes.resize(3*(offset + N));
+                    m_nodeTags.resize(offset + N);
+                    if(m_binary) {
+                        for(int64_t i = 0; i < N; ++i) {
+                            m_nodeTags[offset + i] = read_binary<int32_t>(parser, "the tag of a node");
+                            read_binary_array(parser, &m_nodes[3*(offset + i)], 3, "the coordinates of a node");
+                        }
+                        return;
+                    }
+                    parse_lines(parser, N, [this, offset](textParser & line, const uint64_t i) {
+                        m_nodeTags[offset + i] = line.read_integer("the tag of a node");
+                        m_nodes[3*(offset + i)] = line.read_double("the x coordinate of a node");
+                        m_nodes[3*(offset + i) + 1] = line.read_double("the y coordinate of a node");
+                        m_nodes[3*(offset + i) + 2] = line.read_double("the z coordinate of a node");
+                    });
+                }
+
+                /*! \brief Read the $Nodes section of format 4.1. */
+                void read_nodes_v4(textParser & parser) {
+                    uint64_t Nblocks = read_count(parser, "the number of node blocks");
+                    read_count(parser, "the number of nodes");
+                    read_count(parser, "the smallest node tag");
+                    read_count(parser, "the largest node tag");
+                    for(uint64_t block = 0; block < Nblocks; ++block) {
+                        int64_t dimension = read_int(parser, "the dimension of a node block");
+                        read_int(parser, "the entity of a node block");
+                        int64_t parametric = read_int(parser, "the parametric flag of a node block");
+                        uint64_t N = read_count(parser, "the number of nodes in a block");
+                        uint64_t offset = m_nodeTags.size();
+                        m_nodes.resize(3*(offset + N));
+                        m_nodeTags.resize(offset + N);
+                        if(m_binary) {
+                            for(uint64_t i = 0; i < N; ++i) {
+                                m_nodeTags[offset + i] = read_size(parser, "the tag of a node");
+                            }
+                            uint32_t stride = 3 + (parametric ? dimension : 0);
+                            std::vector<double> x(N*stride);
+                            read_binary_array(parser, x.data(), x.size(), "the coordinates of the nodes");
+                            for(uint64_t i = 0; i < N; ++i) {
+                                for(uint32_t k = 0; k < 3; ++k) {
+                                    m_nodes[3*(offset + i) + k] = x[i*stride + k];
+                                }
+                            }
+                            continue;
+                        }
+                        parser.skip_line();
+                        parse_lines(parser, N, [this, offset](textParser & line, const uint64_t i) {
+                            m_nodeTags[offset + i] = line.read_integer("the tag of a node");
+                        });
+                        parse_lines(parser, N, [this, offset](textParser & line, const uint64_t i) {
+                            m_nodes[3*(offset + i)] = line.read_double("the x coordinate of a node");
+                            m_nodes[3*(offset + i) + 1] = line.read_double("the y coordinate of a node");
+                            m_nodes[3*(offset + i) + 2] = line.read_double("the z coordinate of a node");
+                        });
+                    }
+                }
+
+                /*! \brief Read the $Elements section of format 2.x. */
+                void read_elements_v2(textParser & parser) {
+                    int64_t N = parser.read_integer("the number of elements");
+                    if(N < 0) {
+                        parser.fail("the number of elements must not be negative");
+                    }
+                    parser.skip_line();
+                    if(m_binary) {
+                        int64_t read = 0;
+                        while(read < N) {
+                            int32_t type = read_binary<int32_t>(parser, "the type of an element block");
+                            int32_t Nelements = read_binary<int32_t>(parser, "the number of elements in a block");
+                            int32_t Ntags = read_binary<int32_t>(parser, "the number of tags");
+                            uint32_t Nnodes = nodes_per_element(type);
+                            if(Nnodes == 0 || Nelements < 0 || Ntags < 0) {
+                                parser.fail("unsupported element type " + std::to_string(type));
+                            }
+                            std::vector<int32_t> record(1 + Ntags + Nnodes);
+                            for(int32_t i = 0; i < Nelements; ++i) {
+                                read_binary_array(parser, record.data(), record.size(), "an element");
+                                if(is_triangle(type)) {
+                                    m_physical.push_back(Ntags > 0 ? record[1] : 0);
+                                    for(uint32_t j = 0; j < 3; ++j) {
+                                        m_triangleTags.push_back(record[1 + Ntags + j]);
+                                    }
+                                }
+                            }
+                            read += Nelements;
+                        }
+                        return;
+                    }
+                    std::vector<uint64_t> tags(3*N);
+                    std::vector<int32_t> physical(N);
+                    std::vector<uint8_t> triangle(N, 0);
+                    parse_lines(parser, N, [&tags, &physical, &triangle](textParser & line, const uint64_t i) {
+                        line.read_integer("the tag of an element");
+                        int64_t type = line.read_integer("the type of an element");
+                        if(!is_triangle(type)) {
+                            return;
+                        }
+                        int64_t Ntags = line.read_integer("the number of tags");
+                        for(int64_t j = 0; j < Ntags; ++j) {
+                            int64_t tag = line.read_integer("a tag of an element");
+                            if(j == 0) {
+                                physical[i] = tag;
+                            }
+                        }
+                        for(uint32_t j = 0; j < 3; ++j) {
+                            tags[3*i + j] = line.read_integer("a node of an element");
+                        }
+                        triangle[i] = 1;
+                    });
+                    for(int64_t i = 0; i < N; ++i) {
+                        if(triangle[i]) {
+                            m_physical.push_back(physical[i]);
+                            m_triangleTags.insert(m_triangleTags.end(), tags.begin() + 3*i, tags.begin() + 3*i + 3);
+                        }
+                    }
+                }
+
+                /*! \brief Read the $Elements section of format 4.1. */
+                void read_elements_v4(textParser & parser) {
+                    uint64_t Nblocks = read_count(parser, "the number of element blocks");
+                    read_count(parser, "the number of elements");
+                    read_count(parser, "the smallest element tag");
+                    read_count(parser, "the largest element tag");
+                    for(uint64_t block = 0; block < Nblocks; ++block) {
+                        int64_t dimension = read_int(parser, "the dimension of an element block");
+                        int64_t entity = read_int(parser, "the entity of an element block");
+                        int64_t type = read_int(parser, "the type of an element block");
+                        uint64_t N = read_count(parser, "the number of elements in a block");
+                        uint32_t Nnodes = nodes_per_element(type);
+                        bool triangles = (dimension == 2 && is_triangle(type));
+                        uint64_t offset = m_physical.size();
+                        if(triangles) {
+                            m_physical.resize(offset + N, -1 - entity);
+                            m_triangleTags.resize(3*(offset + N));
+                        }
+                        if(m_binary) {
+                            if(Nnodes == 0) {
+                                parser.fail("unsupported element type " + std::to_string(type));
+                            }
+                            if(!triangles) {
+                                skip_binary(parser, N*(1 + Nnodes)*m_dataSize, "the elements of a block");
+                                continue;
+                            }
+                            for(uint64_t i = 0; i < N; ++i) {
+                                read_size(parser, "the tag of an element");
+                                for(uint32_t j = 0; j < Nnodes; ++j) {
+                                    uint64_t tag = read_size(parser, "a node of an element");
+                                    if(j < 3) {
+                                        m_triangleTags[3*(offset + i) + j] = tag;
+                                    }
+                                }
+                            }
+                            continue;
+                        }
+                        parser.skip_line();
+                        if(!triangles) {
+                            for(uint64_t i = 0; i < N; ++i) {
+                                parser.skip_line();
+                            }
+                            continue;
+                        }
+                        parse_lines(parser, N, [this, offset](textParser & line, const uint64_t i) {
+                            line.read_integer("the tag of an element");
+                            for(uint32_t j = 0; j < 3; ++j) {
+                                m_triangleTags[3*(offset + i) + j] = line.read_integer("a node of an element");
+                            }
+                        });
+                    }
+                }
+
+                /*! \brief Skip an unknown section. */
+                void skip_section(textParser & parser, const std::string & section) {
+                    std::string marker = "\n$End" + section;
+                    const char * position = std::search(parser.get_position() - 1, parser.get_end(), marker.begin(), marker.end());
+                    if(position == parser.get_end()) {
+                        parser.fail("the section $" + section + " is not closed");
+                    }
+                    uint64_t line = parser.get_line() + std::count(parser.get_position(), position + 1, '\n');
+                    parser.set_position(position + 1, line);
+                    parser.skip_line();
+                }
+
+                /*! \brief Check that the section is closed. */
+                void read_end(textParser & parser, const std::string & section) {
+                    parser.skip_whitespace();
+                    std::string line = parser.read_line();
+                    while(!line.empty() && line.back() == ' ') line.pop_back();
+                    if(line != "$End" + section) {
+                        parser.fail("expected $End" + section + " instead of \"" + excerpt(line) + "\"");
+                    }
+                }
+
+                /*! \brief Get the start of a line for error messages, with unprintable characters replaced. */
+                static std::string excerpt(const std::string & line) {
+                    std::string output = line.substr(0, 40);
+                    for(auto iter = output.begin(); iter != output.end(); ++iter) {
+                        if(!isprint(static_cast<unsigned char>(*iter))) {
+                            *iter = '?';
+                        }
+                    }
+                    return output;
+                }
+
+                /*! \brief Replace the node tags of the triangles by node indices and the entities by physical groups. */
+                void resolve(textParser & parser) {
+                    uint64_t maxTag = 0;
+                    for(auto iter = m_nodeTags.begin(); iter != m_nodeTags.end(); ++iter) {
+                        maxTag = std::max(maxTag, *iter);
+                    }
+                    const uint32_t missing = 0xffffffff;
+                    m_triangles.resize(m_triangleTags.size());
+                    if(maxTag < 4*m_nodeTags.size() + 1024) {
+                        std::vector<uint32_t> index(maxTag + 1, missing);
+                        for(uint64_t i = 0; i < m_nodeTags.size(); ++i) {
+                            index[m_nodeTags[i]] = i;
+                        }
+                        for(uint64_t i = 0; i < m_triangleTags.size(); ++i) {
+                            m_triangles[i] = m_triangleTags[i] <= maxTag ? index[m_triangleTags[i]] : missing;
+                            if(m_triangles[i] == missing) {
+                                throw std::runtime_error(parser.get_name() + ": a triangle references the unknown node " + std::to_string(m_triangleTags[i]));
+                            }
+                        }
+                    }
+                    else {
+                        std::vector<std::pair<uint64_t, uint32_t> > index(m_nodeTags.size());
+                        for(uint64_t i = 0; i < m_nodeTags.size(); ++i) {
+                            index[i] = std::make_pair(m_nodeTags[i], uint32_t(i));
+                        }
+                        std::sort(index.begin(), index.end());
+                        for(uint64_t i = 0; i < m_triangleTags.size(); ++i) {
+                            auto found = std::lower_bound(index.begin(), index.end(), std::make_pair(m_triangleTags[i], uint32_t(0)));
+                            if(found == index.end() || found->first != m_triangleTags[i]) {
+                                throw std::runtime_error(parser.get_name() + ": a triangle references the unknown node " + std::to_string(m_triangleTags[i]));
+                            }
+                            m_triangles[i] = found->second;
+                        }
+                    }
+                    for(auto iter = m_physical.begin(); iter != m_physical.end(); ++iter) {
+                        if(*iter < 0) {
+                            auto found = m_surfacePhysical.find(-1 - *iter);
+                            *iter = (found != m_surfacePhysical.end()) ? found->second : 0;
+                        }
+                    }
+                    std::vector<uint64_t>().swap(m_nodeTags);
+                    std::vector<uint64_t>().swap(m_triangleTags);
+                }
+
+                /*! \brief Parse the next N lines
+                 *
+                 * The lines are split into chunks of consecutive lines, which are parsed on up to m_threads threads.
+                 * For every line the function parse(line, i) is called with a parser positioned at the start of the ith line.
+                 * It must not read beyond the end of the line, the rest of the line is skipped.
+                 * The parser is moved behind the N lines.
+                 */
+                template<class F>
+                void parse_lines(textParser & parser, const uint64_t N, const F & parse) {
+                    uint64_t Nchunks = std::max(uint64_t(1), std::min(uint64_t(m_threads), N/s_minLines));
+                    std::vector<const char *> start(Nchunks + 1);
+                    std::vector<uint64_t> first(Nchunks + 1);
+                    const char * position = parser.get_position();
+                    for(uint64_t chunk = 0; chunk <= Nchunks; ++chunk) {
+                        first[chunk] = chunk*N/Nchunks;
+                        start[chunk] = position;
+                        uint64_t lines = (chunk < Nchunks) ? (chunk + 1)*N/Nchunks - first[chunk] : 0;
+                        for(uint64_t i = 0; i < lines; ++i) {
+                            const char * next = static_cast<const char *>(memchr(position, '\n', parser.get_end() - position));
+                            if(!next) {
+                                parser.set_position(parser.get_end(), parser.get_line() + first[chunk] + i);
+                                parser.fail("unexpected end of the file");
+                            }
+                            position = next + 1;
+                        }
+                    }
+                    std::vector<std::exception_ptr> errors(Nchunks);
+                    auto run = [&](const uint64_t chunk) {
+                        try {
+                            textParser line(start[chunk], start[chunk + 1], parser.get_name());
+                            for(uint64_t i = first[chunk]; i < first[chunk + 1]; ++i) {
+                                uint64_t number = parser.get_line() + i;
+                                line.set_position(line.get_position(), number);
+                                parse(line, i);
+                                if(line.get_line() != number) {
+                                    line.set_position(line.get_position(), number);
+                                    line.fail("the line is too short");
+                                }
+                                line.skip_line();
+                            }
+                        }
+                        catch(...) {
+                            errors[chunk] = std::current_exception();
+                        }
+                    };
+                    std::vector<std::thread> workers;
+                    for(uint64_t chunk = 0; chunk + 1 < Nchunks; ++chunk) {
+                        workers.push_back(std::thread(run, chunk));
+                    }
+                    run(Nchunks - 1);
+                    for(auto iter = workers.begin(); iter != workers.end(); ++iter) {
+                        iter->join();
+                    }
+                    for(auto iter = errors.begin(); iter != errors.end(); ++iter) {
+                        if(*iter) {
+                            std::rethrow_exception(*iter);
+                        }
+                    }
+                    parser.set_position(start[Nchunks], parser.get_line() + N);
+                }
+
+                /*! \brief Read a value of type T from a binary section. */
+                template<class T>
+                T read_binary(textParser & parser, const char * description) {
+                    T value;
+                    read_binary_array(parser, &value, 1, description);
+                    return value;
+                }
+
+                /*! \brief Read N values of type T from a binary section. */
+                template<class T>
+                void read_binary_array(textParser & parser, T * output, const uint64_t N, const char * description) {
+                    const char * position = parser.get_position();
+                    if(uint64_t(parser.get_end() - position) < N*sizeof(T)) {
+                        parser.fail(std::string("unexpected end of the file in ") + description);
+                    }
+                    memcpy(output, position, N*sizeof(T));
+                    parser.set_position(position + N*sizeof(T), parser.get_line());
+                }
+
+                /*! \brief Skip the given number of bytes of a binary section. */
+                void skip_binary(textParser & parser, const uint64_t bytes, const char * description) {
+                    const char * position = parser.get_position();
+                    if(uint64_t(parser.get_end() - position) < bytes) {
+                        parser.fail(std::string("unexpected end of the file in ") + description);
+                    }
+                    parser.set_position(position + bytes, parser.get_line());
+                }
+
+                /*! \brief Read a size_t of the data size given in the header from a binary section. */
+                uint64_t read_size(textParser & parser, const char * description) {
+                    return m_dataSize == 8 ? read_binary<uint64_t>(parser, description) : read_binary<uint32_t>(parser, description);
+                }
+
+                /*! \brief Read a count, which is a size_t in binary files of format 4.1. */
+                uint64_t read_count(textParser & parser, const char * description) {
+                    if(m_binary) {
+                        return read_size(parser, description);
+                    }
+                    int64_t value = parser.read_integer(description);
+                    if(value < 0) {
+                        parser.fail(std::string("negative value for ") + description);
+                    }
+                    return value;
+                }
+
+                /*! \brief Read an integer, which is an int in binary files of format 4.1. */
+                int64_t read_int(textParser & parser, const char * description) {
+                    return m_binary ? read_binary<int32_t>(parser, description) : parser.read_integer(description);
+                }
+
+                uint32_t m_threads; /*!< \brief Number of threads used to parse the ASCII formats. */
+                double m_version; /*!< \brief Version of the file format. */
+                bool m_binary; /*!< \brief Information if the file is binary. */
+                uint32_t m_dataSize; /*!< \brief Size of size_t in binary files of format 4.1. */
+                std::vector<double> m_nodes; /*!< \brief Coordinates of the nodes, three per node. */
+                std::vector<uint64_t> m_nodeTags; /*!< \brief Tags of the nodes, only used while reading. */
+                std::vector<uint64_t> m_triangleTags; /*!< \brief Node tags of the triangles, only used while reading. */
+                std::vector<uint32_t> m_triangles; /*!< \brief Node indices of the triangles. */
+                std::vector<int32_t> m_physical; /*!< \brief Physical group of the triangles, -1 - entity tag while reading format 4.1. */
+                std::map<int32_t, int32_t> m_surfacePhysical; /*!< \brief First physical tag of every surface in format 4.1. */
+                std::map<int32_t, std::string> m_physicalNames; /*!< \brief Names of the two dimensional physical groups. */
+                static const uint64_t s_minLines = 16384; /*!< \brief Smallest number of lines parsed by one thread. */
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef include_wallLoad_core_philox_hpp
+#define include_wallLoad_core_philox_hpp
+
+#include <stdint.h>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Identifiers of the independent random number streams.
+         *
+         * Every part of the calculation draws from its own stream, so that e.g. source points and directions are uncorrelated
+         * even if the same seed is used.
+         */
+        enum randomStream {
+            meshStream = 1, /*!< \brief Stream of the mesh. */
+            sourceStream = 2, /*!< \brief Stream for the source points of the radiation distribution. */
+            directionStream = 3, /*!< \brief Stream for the direction vectors. */
+            scatterStream = 4, /*!< \brief Stream for the diffuse scatter. */
+            probabilityStream = 5, /*!< \brief Stream of the probability distribution. */
+            scrambleStream = 6 /*!< \brief Stream for the scrambles of the quasi-random sequences. */
+        };
+
+        /*! \brief Counter based random number generator Philox4x32-10.
+         *
+         * This class implements the Philox4x32-10 generator of Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (2011).
+         * The random numbers are a bijective function of a 128 bit counter, keyed with the 64 bit seed.
+         * The counter is made of the stream id, the sample index and the number of the block drawn within the sample.
+         * Every (seed, stream, sample) triple therefore gives an independent sequence, which does not depend on
+         * which thread draws it or how many samples were drawn before.
+         * The class fulfills the requirements of a uniform random bit generator and can be used with the boost::random distributions.
+         */
+        class philox {
+            public:
+                typedef uint32_t result_type; /*!< \brief Type of the generated random numbers. */
+
+                static const uint64_t default_seed = 0x2545F4914F6CDD1DULL; /*!< \brief Seed used if none is given. */
+
+                /*! \brief Constructor
+                 *
+                 * This constructor initializes the generator for the given seed, stream and sample index.
+                 */
+                philox(const uint64_t seed = default_seed, const uint32_t stream = 0, const uint64_t sample = 0) {
+                    this->seed(seed, stream, sample);
+                }
+
+                /*! \brief Reset the generator
+                 *
+                 * This function sets seed, stream and sample index and restarts the sequence.
+                 */
+                void seed(const uint64_t seed, const uint32_t stream = 0, const uint64_t sample = 0) {
+                    m_key[0] = (uint32_t)seed;
+                    m_key[1] = (uint32_t)(seed >> 32);
+                    m_counter[0] = 0;
+                    m_counter[1] = stream;
+                    m_counter[2] = (uint32_t)sample;
+                    m_counter[3] = (uint32_t)(sample >> 32);
+                    m_index = 4;
+                }
+
+                /*! \brief Smallest generated value. */
+                static constexpr result_type min() { return 0; }
+                /*! \brief Largest generated value. */
+                static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+                /*! \brief Get the next random number. */
+                inline result_type operator()() {
+                    if(m_index == 4) {
+                        generate_block();
+                    }
+                    return m_output[m_index++];
+                }
+
+                /*! \brief Skip the next n random numbers. */
+                void discard(uint64_t n) {
+                    for( ; n > 0; --n) {
+                        (*this)();
+                    }
+                }
+
+                /*! \brief Get the seed. */
+                uint64_t get_seed() const {
+                    return ((uint64_t)m_key[1] << 32) | m_key[0];
+                }
+
+                /*! \brief Get the sample index. */
+                uint64_t get_sample() const {
+                    return ((uint64_t)m_counter[3] << 32) | m_counter[2];
+                }
+
+            protected:
+                /*! \brief Calculate the next block of four random numbers and advance the block counter. */
+                void generate_block() {
+                    uint32_t c0 = m_counter[0], c1 = m_counter[1], c2 = m_counter[2], c3 = m_counter[3];
+                    uint32_t k0 = m_key[0], k1 = m_key[1];
+                    for(uint32_t round = 0; round < 10; ++round) {
+                        uint64_t product0 = (uint64_t)0xD2511F53u*c0;
+                        uint64_t product1 = (uint64_t)0xCD9E8D57u*c2;
+                        uint32_t hi0 = (uint32_t)(product0 >> 32), lo0 = (uint32_t)product0;
+                        uint32_t hi1 = (uint32_t)(product1 >> 32), lo1 = (uint32_t)product1;
+                        c0 = hi1 ^ c1 ^ k0;
+                        c1 = lo1;
+                        c2 = hi0 ^ c3 ^ k1;
+                        c3 = lo0;
+                        k0 += 0x9E3779B9u;
+                        k1 += 0xBB67AE85u;
+                    }
+                    m_output[0] = c0;
+                    m_output[1] = c1;
+                    m_output[2] = c2;
+                    m_output[3] = c3;
+                    ++m_counter[0];
+                    m_index = 0;
+                }
+
+                uint32_t m_key[2]; /*!< \brief Key made from the seed. */
+                uint32_t m_counter[4]; /*!< \brief Counter: block, stream, sample (low and high word). */
+                uint32_t m_output[4]; /*!< \brief Current block of random numbers. */
+                uint32_t m_index; /*!< \brief Position of the next random number in the current block. */
+        };
+    }
+}
+
+#endif
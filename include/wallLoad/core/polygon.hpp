@@ -26,13 +26,6 @@ namespace wallLoad {
                 polygon(const std::vector<double> & R, const std::vector<double> & z) 
                     : m_R(R), m_z(z) {
                 }
-                /*! \brief Copy constructor */
-                polygon(const polygon & rhs) 
-                    : m_R(rhs.m_R), m_z(rhs.m_z) {
-                }
-                /*! \brief Destructor */
-                virtual ~polygon() {
-                }
                 /*! \brief Python constructor
                  *
                  * This constructor initializes the polygon with the given \f$(R,z)\f$ points.
@@ -47,32 +40,20 @@ namespace wallLoad {
                     }
                 }
 
-                /*! \brief Assignment operator
-                 *
-                 * This operator copies the points of the given polygon to the current instance.
-                 */
-                polygon & operator= (const polygon & rhs) {
-                    if(this != &rhs) {
-                        m_R = rhs.m_R;
-                        m_z = rhs.m_z;
-                    }
-                    return *this;
-                }
-
                 /*! \brief Get \f$R\f$ coordinates.
                  *
                  * This function returns the \f$R\f$ coordinates of the polygon.
                  */
-                std::vector<double> get_R() const {
-                    return std::vector<double>(m_R.cbegin(), m_R.cend());
+                const std::vector<double> & get_R() const {
+                    return m_R;
                 }
 
                 /*! \brief Get \f$z\f$ coordinates.
                  *
                  * This function returns the \f$z\f$ coordinates of the polygon.
                  */
-                std::vector<double> get_z() const {
-                    return std::vector<double>(m_z.cbegin(), m_z.cend());
+                const std::vector<double> & get_z() const {
+                    return m_z;
                 }
 
                 /*! \brief Get \f$R\f$ coordinates as python list.
@@ -106,6 +87,7 @@ namespace wallLoad {
                 /*! \brief Check if point \f$(x,y)\f$ is inside the polygon 
                  *
                  * This function checks if the point \f$(x,y)\f$ lies within the polygon.
+                 * The polygon is closed by the edge from its last to its first point, which may repeat the first one.
                  */
                 bool inside(const double x, const double y) const {
                     bool inside = false;
@@ -116,7 +98,7 @@ namespace wallLoad {
                     double y2 = m_z[0];
                     bool startUeber = y1 >= y? true : false;
                     bool endUeber;
-                    for(uint32_t i = 1; i < N ; ++i) {
+                    for(uint32_t i = 1; i <= N ; ++i) {
                         endUeber = y2 >= y? true : false;
                         if(startUeber != endUeber) {
                             if((y2 - y)*(x2 - x1) <= (y2 - y1)*(x2 - x)) {
@@ -133,8 +115,8 @@ namespace wallLoad {
                         startUeber = endUeber;
                         y1 = y2;
                         x1 = x2;
-                        x2 = m_R[i];
-                        y2 = m_z[i];
+                        x2 = m_R[i % N];
+                        y2 = m_z[i % N];
                     }
                     return inside;
                 }
@@ -5,7 +5,7 @@
 #include <vector>
 #include <stdint.h>
 #include <boost/random.hpp>
-#include <time.h>
+#include <wallLoad/core/philox.hpp>
 #include <algorithm>
 
 namespace wallLoad {
@@ -24,34 +24,22 @@ namespace wallLoad {
                  * Do not use this function from within C++.
                  */
                 probabilityDistribution(const boost::python::list & x, const boost::python::list & y) : 
-                    m_generator(time(0)), N(boost::python::len(x)), 
-                    m_x(new double[N]), m_y(new double[N]), m_accumulated(new double[N]) {
+                    m_generator(philox::default_seed, probabilityStream), N(boost::python::len(x)), 
+                    m_x(N), m_y(N), m_accumulated(N) {
                     for(uint32_t i = 0; i < boost::python::len(x); ++i) {
-                        *(m_x + i) = boost::python::extract<double>(x[i]);
-                        *(m_y + i) = boost::python::extract<double>(y[i]);
+                        m_x[i] = boost::python::extract<double>(x[i]);
+                        m_y[i] = boost::python::extract<double>(y[i]);
                     }
                     calculate_accumulated();
                 }
 
-                /*! \brief Copy constructor */
-                probabilityDistribution(const probabilityDistribution & rhs) :
-                    m_generator(time(0)), N(rhs.N),
-                    m_x(new double[N]), m_y(new double[N]), m_accumulated(new double[N]) {
-                    std::copy(rhs.m_x, rhs.m_x + N, m_x);
-                    std::copy(rhs.m_y, rhs.m_y + N, m_y);
-                    std::copy(rhs.m_accumulated, rhs.m_accumulated + N, m_accumulated);
-                }
-
-                
                 /*! \brief Constructor
                  *
                  * This constructor initializes the probability density function with the x,y values.
                  */
                 probabilityDistribution(const std::vector<double> & x, const std::vector<double> & y) :
-                    m_generator(time(0)), N(x.size()), 
-                    m_x(new double[N]), m_y(new double[N]), m_accumulated(new double[N]) {
-                    std::copy(x.begin(), x.end(), m_x);
-                    std::copy(y.begin(), y.end(), m_y);
+                    m_generator(philox::default_seed, probabilityStream), N(x.size()), 
+                    m_x(x), m_y(y), m_accumulated(N) {
                     calculate_accumulated();
                 }
 
@@ -60,18 +48,22 @@ namespace wallLoad {
                  * This constructor initializes the probability density function with the x,y values.
                  */
                 probabilityDistribution(const uint32_t n, const double * x, const double * y) :
-                    m_generator(time(0)), N(n), 
-                    m_x(new double[N]), m_y(new double[N]), m_accumulated(new double[N]) {
-                    std::copy(x, x + N, m_x);
-                    std::copy(y, y + N, m_y);
+                    m_generator(philox::default_seed, probabilityStream), N(n), 
+                    m_x(x, x + N), m_y(y, y + N), m_accumulated(N) {
                     calculate_accumulated();
                 }
 
-                /*! \brief Destructor */
-                virtual ~probabilityDistribution() {
-                    delete [] m_x;
-                    delete [] m_y;
-                    delete [] m_accumulated;
+                /*! \brief Set the seed of the random number generator
+                 *
+                 * This function restarts the random number stream of the instance with the given seed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    m_generator.seed(seed, probabilityStream);
+                }
+
+                /*! \brief Get the seed of the random number generator. */
+                uint64_t get_seed() const {
+                    return m_generator.get_seed();
                 }
 
                 /*! \brief Get points on x axis.
@@ -79,7 +71,7 @@ namespace wallLoad {
                  * Returns the values on the x axis of the probability distribution.
                  */
                 inline std::vector<double> get_x() const {
-                    return std::vector<double>(m_x, m_x + N);
+                    return m_x;
                 }
 
                 /*! \brief Get points on y axis.
@@ -87,7 +79,7 @@ namespace wallLoad {
                  * Returns the values on the y axis of the probability distribution.
                  */
                 inline std::vector<double> get_y() const {
-                    return std::vector<double>(m_x, m_y + N);
+                    return m_y;
                 }
 
                 /*! \brief Get the cumulated density function
@@ -95,7 +87,7 @@ namespace wallLoad {
                  * Returns the cumulated density function.
                  */
                 inline std::vector<double> get_accumulated() const {
-                    return std::vector<double>(m_accumulated, m_accumulated + N);
+                    return m_accumulated;
                 }
 
 
@@ -107,7 +99,7 @@ namespace wallLoad {
                  */
                 boost::python::list get_accumulated_python() const {
                     boost::python::list output;
-                    for(double * iter = m_accumulated; iter != m_accumulated + N; ++iter) {
+                    for(auto iter = m_accumulated.cbegin(); iter != m_accumulated.cend(); ++iter) {
                         output.append(*iter);
                     }
                     return output;
@@ -121,7 +113,7 @@ namespace wallLoad {
                  */
                 boost::python::list get_x_python() const {
                     boost::python::list output;
-                    for(double * iter = m_x; iter != m_x + N; ++iter) {
+                    for(auto iter = m_x.cbegin(); iter != m_x.cend(); ++iter) {
                         output.append(*iter);
                     }
                     return output;
@@ -135,7 +127,7 @@ namespace wallLoad {
                  */
                 boost::python::list get_y_python() const {
                     boost::python::list output;
-                    for(double * iter = m_y; iter != m_y + N; ++iter) {
+                    for(auto iter = m_y.cbegin(); iter != m_y.cend(); ++iter) {
                         output.append(*iter);
                     }
                     return output;
@@ -158,19 +150,17 @@ namespace wallLoad {
                 }
 
                 /*! \brief Get the maximum probability density */
-                double get_max() const { return *std::max_element(m_y, m_y+N); }
+                double get_max() const { return *std::max_element(m_y.cbegin(), m_y.cend()); }
 
                 /*! \brief Calculate the probability at the given point x.
                  *
                  * This function returns the linear interpolated probability density at the given point x.
                  */
                 double get_value(const double x) const {
-                    if((x < *m_x) || (x > *(m_x + N - 1))) return 0.0;
-                    uint32_t i0 = 0;
-                    for(uint32_t i = 1; i < N; ++i) {
-                        if((m_x[i-1] <= x) && (m_x[i] >= x)) i0 = i;
-                    }
-                    double t = x - m_x[i0-1];
+                    if((x < m_x[0]) || (x > m_x[N - 1])) return 0.0;
+                    uint32_t i0 = std::upper_bound(m_x.cbegin(), m_x.cend(), x) - m_x.cbegin();
+                    if(i0 >= N) i0 = N - 1;
+                    double t = (x - m_x[i0-1])/(m_x[i0] - m_x[i0-1]);
                     return (1.0 - t)*m_y[i0-1] + t*m_y[i0];
                 }
 
@@ -182,7 +172,7 @@ namespace wallLoad {
                  * This function calculates the cumulated density function for the given probability density function.
                  */
                 void calculate_accumulated() {
-                    *m_accumulated = 0;
+                    m_accumulated[0] = 0.0;
                     for(uint32_t i = 1; i < N; ++i) {
                         m_accumulated[i] = m_accumulated[i-1] + (m_y[i] + m_y[i-1])/2.0*(m_x[i]-m_x[i-1]);
                     }
@@ -192,12 +182,12 @@ namespace wallLoad {
                     }
                 }
 
-                boost::random::mt19937 m_generator; /*!< \brief Random number generator */
+                philox m_generator; /*!< \brief Random number generator */
                 boost::random::uniform_01<double> m_distribution; /*!< \brief Random uniform distribution \f$[0,1[\f$. */
                 uint32_t N; /*!< \brief Number of points on the distribution. */
-                double * m_x; /*!< \brief Points on the x axis of the distribution. */
-                double * m_y; /*!< \brief Values of the probability distribution. */
-                double * m_accumulated; /*!< Cumulated probability density function. */
+                std::vector<double> m_x; /*!< \brief Points on the x axis of the distribution. */
+                std::vector<double> m_y; /*!< \brief Values of the probability distribution. */
+                std::vector<double> m_accumulated; /*!< Cumulated probability density function. */
 
         };
     }
@@ -6,9 +6,16 @@
 #include <wallLoad/core/vektor.hpp>
 #include <wallLoad/core/radiationProfile.hpp>
 #include <wallLoad/core/polygon.hpp>
+#include <wallLoad/core/philox.hpp>
+#include <wallLoad/core/aliasTable.hpp>
+#include <wallLoad/core/instanceMutex.hpp>
 #include <boost/random.hpp>
 #include <boost/math/constants/constants.hpp>
 #include <math.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <numeric>
 
 namespace wallLoad {
     namespace core {
@@ -16,6 +23,8 @@ namespace wallLoad {
          *
          * This class calculates random positions on an equilibrium with a probability which is proportional to the given radiation distribution.
          * A boundary contour can be provided to limit the area in which the points are generated.
+         * The functions which modify the instance or draw from its random number generator lock the mutex of the instance,
+         * so it can be shared by several threads.
          */
         class radiationDistribution {
             public:
@@ -26,12 +35,18 @@ namespace wallLoad {
                 radiationDistribution(const equilibrium & equi, const radiationProfile & profile) : 
                     m_equilibrium(equi), m_profile(profile), 
                     m_radiationProbability(profile.get_probabilityDistribution()),
-                    m_generator(time(0)),
+                    m_generator(philox::default_seed, sourceStream),
                     m_R(equi.get_Rmin(), equi.get_Rmax()),
                     m_z(equi.get_zmin(), equi.get_zmax()),
                     m_2pi(0.0, 2.0*boost::math::constants::pi<double>()),
                     m_hasContour(false),
-                    m_contour()
+                    m_contour(),
+                    m_gridNR(0),
+                    m_gridNz(0),
+                    m_gridTable(),
+                    m_gridColumn(),
+                    m_gridCumulative(),
+                    m_gridPartial()
                     {
                 }
 
@@ -42,81 +57,206 @@ namespace wallLoad {
                 radiationDistribution(const equilibrium & equi, const radiationProfile & profile, const polygon & contour) : 
                     m_equilibrium(equi), m_profile(profile), 
                     m_radiationProbability(profile.get_probabilityDistribution()),
-                    m_generator(time(0)),
+                    m_generator(philox::default_seed, sourceStream),
                     m_R(equi.get_Rmin(), equi.get_Rmax()),
                     m_z(equi.get_zmin(), equi.get_zmax()),
                     m_2pi(0.0, 2.0*boost::math::constants::pi<double>()),
                     m_hasContour(true),
-                    m_contour(contour)
+                    m_contour(contour),
+                    m_gridNR(0),
+                    m_gridNz(0),
+                    m_gridTable(),
+                    m_gridColumn(),
+                    m_gridCumulative(),
+                    m_gridPartial()
                     {
                 }
 
-                /*! \brief Destructor */
-                virtual ~radiationDistribution() {}
+
+                /*! \brief Set the seed of the random number generator
+                 *
+                 * This function restarts the random number stream of the instance with the given seed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    writeLock lock(m_mutex);
+                    m_generator.seed(seed, sourceStream);
+                }
+
+                /*! \brief Get the seed of the random number generator. */
+                uint64_t get_seed() const {
+                    return m_generator.get_seed();
+                }
+
+                /*! \brief Get the mutex of the instance.
+                 *
+                 * Lock it for reading to keep the instance unchanged while it is copied.
+                 */
+                instanceMutex & get_mutex() const {
+                    return m_mutex;
+                }
 
                 /*! Get random poloidal points
                  *
                  * This function returns N random points in the poloidal plane.
                  */
                 std::vector<vektor> get_random_points(const uint32_t N = 1) {
-                    std::vector<vektor> output;
+                    std::vector<vektor> output(N);
+                    get_random_points(output.data(), N);
+                    return output;
+                }
+
+                /*! Get random poloidal points
+                 *
+                 * This function writes N random points in the poloidal plane to the given memory.
+                 */
+                void get_random_points(vektor * output, const uint64_t N) {
+                    writeLock lock(m_mutex);
+                    for(uint64_t i = 0; i < N; ++i) {
+                        output[i] = get_random_point(m_generator);
+                    }
+                }
+
+                /*! Get random poloidal point with the given random number generator
+                 *
+                 * This function returns a random point in the poloidal plane drawn with the given random number generator.
+                 * If a grid has been set with set_grid() the point is drawn from the tabulated emissivity,
+                 * otherwise it is found by rejection sampling over the whole \f$(R,z)\f$ box.
+                 */
+                template<class Generator>
+                vektor get_random_point(Generator & generator) const {
+                    if(!m_gridTable.empty()) {
+                        return get_random_grid_point(generator);
+                    }
                     double R, z, u, P, rho;
                     double M = m_radiationProbability.get_max();
-                    double R0 = m_equilibrium.get_R0();
-                    while(output.size() < N) {
-                        R = m_R(m_generator);
-                        z = m_z(m_generator);
-                        u = m_u(m_generator);
+                    double Rmax = get_Rmax();
+                    boost::random::uniform_01<double> uniform;
+                    while(true) {
+                        R = m_R(generator);
+                        z = m_z(generator);
+                        u = uniform(generator);
                         rho = m_equilibrium.get_rho(R,z);
                         P = m_radiationProbability.get_value(rho)*R;
                         if(m_hasContour && !m_contour.inside(R,z)) {
                             P = 0.0;
                         }
-                        if( u < P/R0/M ) {
-                            output.push_back(vektor(R,0,z));
+                        if( u < P/Rmax/M ) {
+                            return vektor(R,0,z);
                         }
                     }
-                    return output;
                 }
 
-                /*! Get random poloidal points as python list.
+                /*! Get random point
                  *
-                 * This function returns N random points in the poloidal plane.
-                 * This function is intended as python interface.
-                 * Do not use this function from within C++.
+                 * This function returns a random point in the torus.
+                 * The point is calculated on the poloidal plane and are then toroidally rotated by a random angle.
                  */
-                boost::python::list get_random_points_python(const uint32_t N = 1) {
-                    std::vector<vektor> temp = get_random_points(N);
-                    boost::python::list output;
-                    for(auto iter = temp.begin(); iter != temp.end(); ++iter) {
-                        output.append(*iter);
+                inline vektor get_random_toroidal_point() {
+                    writeLock lock(m_mutex);
+                    return get_random_toroidal_point(m_generator);
+                }
+
+                /*! Get random point with the given random number generator
+                 *
+                 * This function returns a random point in the torus drawn with the given random number generator.
+                 * It does not change the instance, so it can be called from several threads at once
+                 * as long as every thread uses its own generator.
+                 */
+                template<class Generator>
+                vektor get_random_toroidal_point(Generator & generator) const {
+                    vektor point = get_random_point(generator);
+                    double alpha = m_2pi(generator);
+                    return vektor(point.x*cos(alpha),point.x*sin(alpha),point.z);
+                }
+
+                /*! Get random point in a toroidal sector with the given random number generator
+                 *
+                 * This function returns a random point in the toroidal sector \f$[\varphi_{min}, \varphi_{min} + \Delta\varphi[\f$,
+                 * drawn from the same poloidal distribution as get_random_toroidal_point().
+                 */
+                template<class Generator>
+                vektor get_random_toroidal_point(Generator & generator, const double phiMin, const double phiWidth) const {
+                    vektor point = get_random_point(generator);
+                    boost::random::uniform_01<double> uniform;
+                    double alpha = phiMin + phiWidth*uniform(generator);
+                    return vektor(point.x*cos(alpha),point.x*sin(alpha),point.z);
+                }
+
+                /*! Get quasi-random point
+                 *
+                 * This function maps the point u of the unit cube \f$[0,1[^3\f$ to a point in the toroidal sector
+                 * \f$[\varphi_{min}, \varphi_{min} + \Delta\varphi[\f$: the first two coordinates give the poloidal position and
+                 * the third the toroidal angle.
+                 * The poloidal position is taken from the grid by inverting the cumulative distributions of the emission:
+                 * \f$u_0\f$ gives the column of cells in \f$R\f$ and, from its position within the interval of the column,
+                 * \f$R^2\f$ within the column, \f$u_1\f$ gives the cell within the column and \f$z\f$ within the cell.
+                 * This draws from the same distribution as get_random_toroidal_point() and both \f$R(u_0)\f$ and \f$z(u_1)\f$
+                 * are continuous and monotonic, so a low-discrepancy point set gives evenly spread source points.
+                 * If the point is outside of the contour in a partial cell it is replaced by a random one in the same cell,
+                 * drawn with the given generator like in get_random_toroidal_point().
+                 * Without a grid the poloidal position is drawn with the generator by rejection sampling and only the toroidal
+                 * angle is taken from u.
+                 */
+                template<class Generator>
+                vektor get_quasi_random_toroidal_point(const double * u, Generator & generator,
+                    const double phiMin = 0.0, const double phiWidth = 2.0*boost::math::constants::pi<double>()) const {
+                    vektor point;
+                    if(m_gridTable.empty()) {
+                        point = get_random_point(generator);
                     }
-                    return output;
+                    else {
+                        double fraction;
+                        uint32_t i = invert(m_gridColumn.data(), m_gridNR, u[0], fraction);
+                        double Rmin = get_Rmin();
+                        double dR = (get_Rmax() - Rmin)/m_gridNR;
+                        double R0 = Rmin + i*dR;
+                        double R1 = R0 + dR;
+                        double R = sqrt(R0*R0 + fraction*(R1*R1 - R0*R0));
+                        uint32_t j = invert(m_gridCumulative.data() + i*m_gridNz, m_gridNz, u[1], fraction);
+                        double z = get_zmin() + (j + fraction)*(get_zmax() - get_zmin())/m_gridNz;
+                        uint32_t cell = i*m_gridNz + j;
+                        point = vektor(R,0,z);
+                        if(m_gridPartial[cell] && !m_contour.inside(R,z) && !get_random_cell_point(cell, generator, point)) {
+                            point = get_random_grid_point(generator);
+                        }
+                    }
+                    double alpha = phiMin + phiWidth*u[2];
+                    return vektor(point.x*cos(alpha),point.x*sin(alpha),point.z);
                 }
 
-                /*! Get random point
+                /*! Get random point uniformly distributed in the volume with the given random number generator
                  *
-                 * This function returns a random point in the torus.
-                 * The point is calculated on the poloidal plane and are then toroidally rotated by a random angle.
+                 * This function draws a point uniformly distributed in the volume of the torus within the \f$(R,z)\f$ bounds,
+                 * independent of the radiation profile, and writes its \f$\rho_{pol}\f$ to rho.
+                 * It returns false if the point is outside of the boundary contour or \f$\rho_{pol}\f$ is undefined there, which emits nothing.
                  */
-                inline vektor get_random_toroidal_point() {
-                    double R, z, u, P, rho;
-                    double M = m_radiationProbability.get_max();
-                    double R0 = m_equilibrium.get_R0();
-                    double alpha;
-                    R = m_R(m_generator);
-                    z = m_z(m_generator);
-                    u = m_u(m_generator);
-                    rho = m_equilibrium.get_rho(R,z);
-                    P = m_radiationProbability.get_value(rho)*R;
+                template<class Generator>
+                bool get_random_volume_point(Generator & generator, vektor & point, double & rho) const {
+                    boost::random::uniform_01<double> uniform;
+                    double Rmin = get_Rmin(), Rmax = get_Rmax();
+                    double R = sqrt(Rmin*Rmin + uniform(generator)*(Rmax*Rmax - Rmin*Rmin));
+                    double z = get_zmin() + uniform(generator)*(get_zmax() - get_zmin());
+                    double alpha = m_2pi(generator);
                     if(m_hasContour && !m_contour.inside(R,z)) {
-                        P = 0.0;
+                        return false;
                     }
-                    if( u < P/R0/M ) {
-                        alpha = m_2pi(m_generator);
-                        return vektor(R*cos(alpha),R*sin(alpha),z);
+                    rho = m_equilibrium.get_rho(R,z);
+                    point = vektor(R*cos(alpha),R*sin(alpha),z);
+                    return std::isfinite(rho);
+                }
+
+                /*! \brief Get the emission density at \f$(R,z)\f$
+                 *
+                 * This function returns the power density \f$P(\rho(R,z))\f$ the random points are drawn from,
+                 * up to a constant factor. It is zero outside of the \f$(R,z)\f$ bounds and the boundary contour
+                 * and where \f$\rho_{pol}\f$ is undefined.
+                 */
+                double get_emission(const double R, const double z) const {
+                    if(R < get_Rmin() || R > get_Rmax() || z < get_zmin() || z > get_zmax() || (m_hasContour && !m_contour.inside(R,z))) {
+                        return 0.0;
                     }
-                    return get_random_toroidal_point();
+                    double value = m_radiationProbability.get_value(m_equilibrium.get_rho(R,z));
+                    return std::isfinite(value) ? value : 0.0;
                 }
 
                 /*! Get random points
@@ -125,61 +265,82 @@ namespace wallLoad {
                  * The points are calculated on the poloidal plane and are then toroidally rotated by a random angle.
                  */
                 std::vector<vektor> get_random_toroidal_points(const uint32_t N = 1) {
-                    std::vector<vektor> output;
-                    double R, z, u, P, rho;
-                    double M = m_radiationProbability.get_max();
-                    double R0 = m_equilibrium.get_R0();
-                    double alpha, sina, cosa;
-                    while(output.size() < N) {
-                        R = m_R(m_generator);
-                        z = m_z(m_generator);
-                        u = m_u(m_generator);
-                        rho = m_equilibrium.get_rho(R,z);
-                        P = m_radiationProbability.get_value(rho)*R;
-                        if(m_hasContour && !m_contour.inside(R,z)) {
-                            P = 0.0;
-                        }
-                        if( u < P/R0/M ) {
-                            alpha = m_2pi(m_generator);
-                            cosa = cos(alpha);
-                            sina = sin(alpha);
-                            output.push_back(vektor(R*cosa,R*sina,z));
-                        }
-                    }
+                    std::vector<vektor> output(N);
+                    get_random_toroidal_points(output.data(), N);
                     return output;
                 }
 
-                /*! Get random points as python list
+                /*! Get random points
                  *
-                 * This function returns N random points in the torus.
-                 * The points are calculated on the poloidal plane and are then toroidally rotated by a random angle.
-                 * This function is intended as python interface.
-                 * Do not use this function from within C++.
+                 * This function writes N random points in the torus to the given memory.
                  */
-                boost::python::list get_random_toroidal_points_python(const uint32_t N = 1) {
-                    std::vector<vektor> temp = get_random_toroidal_points(N);
-                    boost::python::list output;
-                    for(auto iter = temp.begin(); iter != temp.end(); ++iter) {
-                        output.append(*iter);
+                void get_random_toroidal_points(vektor * output, const uint64_t N) {
+                    writeLock lock(m_mutex);
+                    for(uint64_t i = 0; i < N; ++i) {
+                        output[i] = get_random_toroidal_point(m_generator);
                     }
-                    return output;
+                }
+
+                /*! \brief Tabulate the emission on a grid
+                 *
+                 * This function tabulates \f$P(\rho(R,z)) R\f$ on a grid of NR x Nz cells covering \f$[R_{min},R_{max}] \times [z_{min},z_{max}]\f$.
+                 * Every cell is weighted with the mean over s_gridSubsamples x s_gridSubsamples points, which are clipped to the boundary contour.
+                 * Points where the emission is undefined, e.g. outside of the flux map of the equilibrium, add nothing, like in rejection sampling.
+                 * Afterwards the random points are drawn by choosing a cell from an alias table and placing the point inside of it,
+                 * so no candidate is rejected. Inside of a cell the emission is taken as constant in z and proportional to R.
+                 * Cells which are only partly inside of the contour are redrawn until the point is inside.
+                 * Setting NR or Nz to zero removes the grid and switches back to rejection sampling.
+                 */
+                void set_grid(const uint32_t NR, const uint32_t Nz) {
+                    writeLock lock(m_mutex);
+                    m_gridNR = NR;
+                    m_gridNz = Nz;
+                    build_grid();
+                }
+
+                /*! \brief Remove the grid and switch back to rejection sampling. */
+                void clear_grid() {
+                    set_grid(0, 0);
+                }
+
+                /*! \brief Check if a grid is used for sampling. */
+                bool has_grid() const {
+                    return !m_gridTable.empty();
+                }
+
+                /*! \brief Get number of grid cells in R */
+                uint32_t get_grid_NR() const {
+                    return m_gridNR;
+                }
+
+                /*! \brief Get number of grid cells in z */
+                uint32_t get_grid_Nz() const {
+                    return m_gridNz;
                 }
 
                 /*! \brief Set \f$R_{min}\f$ */
                 void set_Rmin(const double Rmin) {
+                    writeLock lock(m_mutex);
                     m_R.param(boost::random::uniform_real_distribution<double>::param_type(Rmin, m_R.param().b()));
+                    build_grid();
                 }
                 /*! \brief Set \f$R_{max}\f$ */
                 void set_Rmax(const double Rmax) {
+                    writeLock lock(m_mutex);
                     m_R.param(boost::random::uniform_real_distribution<double>::param_type(m_R.param().a(), Rmax));
+                    build_grid();
                 }
                 /*! \brief Set \f$z_{min}\f$ */
                 void set_zmin(double zmin) {
+                    writeLock lock(m_mutex);
                     m_z.param(boost::random::uniform_real_distribution<double>::param_type(zmin, m_z.param().b()));
+                    build_grid();
                 }
                 /*! \brief Set \f$z_{max}\f$ */
                 void set_zmax(const double zmax) {
+                    writeLock lock(m_mutex);
                     m_z.param(boost::random::uniform_real_distribution<double>::param_type(m_z.param().a(), zmax));
+                    build_grid();
                 }
                 /*! \brief Get \f$R_{min}\f$ */
                 double get_Rmin() const {
@@ -199,16 +360,134 @@ namespace wallLoad {
                 }
 
             protected:
+                /*! \brief Build the alias table for the current grid size and bounds. */
+                void build_grid() {
+                    m_gridTable.clear();
+                    m_gridColumn.clear();
+                    m_gridCumulative.clear();
+                    m_gridPartial.clear();
+                    if(m_gridNR == 0 || m_gridNz == 0) {
+                        return;
+                    }
+                    double Rmin = get_Rmin(), zmin = get_zmin();
+                    double dR = (get_Rmax() - Rmin)/m_gridNR;
+                    double dz = (get_zmax() - zmin)/m_gridNz;
+                    std::vector<double> weights(m_gridNR*m_gridNz, 0.0);
+                    m_gridPartial.assign(m_gridNR*m_gridNz, 0);
+                    for(uint32_t i = 0; i < m_gridNR; ++i) {
+                        for(uint32_t j = 0; j < m_gridNz; ++j) {
+                            double sum = 0.0;
+                            uint32_t inside = 0;
+                            for(uint32_t k = 0; k < s_gridSubsamples; ++k) {
+                                double R = Rmin + (i + (k + 0.5)/s_gridSubsamples)*dR;
+                                for(uint32_t l = 0; l < s_gridSubsamples; ++l) {
+                                    double z = zmin + (j + (l + 0.5)/s_gridSubsamples)*dz;
+                                    if(m_hasContour && !m_contour.inside(R,z)) {
+                                        continue;
+                                    }
+                                    ++inside;
+                                    double value = m_radiationProbability.get_value(m_equilibrium.get_rho(R,z))*R;
+                                    if(std::isfinite(value)) {
+                                        sum += value;
+                                    }
+                                }
+                            }
+                            weights[i*m_gridNz + j] = sum;
+                            m_gridPartial[i*m_gridNz + j] = (inside < s_gridSubsamples*s_gridSubsamples);
+                        }
+                    }
+                    m_gridTable.build(weights);
+                    if(m_gridTable.empty()) {
+                        return;
+                    }
+                    m_gridColumn.assign(m_gridNR, 0.0);
+                    m_gridCumulative.assign(weights.size(), 0.0);
+                    for(uint32_t i = 0; i < m_gridNR; ++i) {
+                        double * column = m_gridCumulative.data() + i*m_gridNz;
+                        std::partial_sum(weights.begin() + i*m_gridNz, weights.begin() + (i + 1)*m_gridNz, column);
+                        m_gridColumn[i] = column[m_gridNz - 1] + (i > 0 ? m_gridColumn[i - 1] : 0.0);
+                        normalize(column, m_gridNz);
+                    }
+                    normalize(m_gridColumn.data(), m_gridNR);
+                }
+
+                /*! \brief Divide the N cumulative sums by the last one, if it is positive. */
+                static void normalize(double * cumulative, const uint32_t N) {
+                    double total = cumulative[N - 1];
+                    if(total <= 0.0) {
+                        return;
+                    }
+                    for(uint32_t i = 0; i < N; ++i) {
+                        cumulative[i] /= total;
+                    }
+                    cumulative[N - 1] = 1.0;
+                }
+
+                /*! \brief Invert a normalized cumulative distribution
+                 *
+                 * This function returns the index of the interval of the N cumulative sums which contains u
+                 * and writes the position of u within this interval to fraction. Intervals of zero width are never returned.
+                 */
+                static uint32_t invert(const double * cumulative, const uint32_t N, const double u, double & fraction) {
+                    uint32_t i = std::upper_bound(cumulative, cumulative + N - 1, u) - cumulative;
+                    double lower = i > 0 ? cumulative[i - 1] : 0.0;
+                    fraction = std::min(1.0, std::max(0.0, (u - lower)/(cumulative[i] - lower)));
+                    return i;
+                }
+
+                /*! \brief Draw a random poloidal point from the grid. */
+                template<class Generator>
+                vektor get_random_grid_point(Generator & generator) const {
+                    vektor point;
+                    while(!get_random_cell_point(m_gridTable.sample(generator), generator, point)) {
+                    }
+                    return point;
+                }
+
+                /*! \brief Draw a random poloidal point in the given grid cell.
+                 *
+                 * The function returns false if no point inside of the contour was found within s_gridAttempts tries.
+                 */
+                template<class Generator>
+                bool get_random_cell_point(const uint32_t cell, Generator & generator, vektor & point) const {
+                    boost::random::uniform_01<double> uniform;
+                    double Rmin = get_Rmin(), zmin = get_zmin();
+                    double dR = (get_Rmax() - Rmin)/m_gridNR;
+                    double dz = (get_zmax() - zmin)/m_gridNz;
+                    double R0 = Rmin + (cell/m_gridNz)*dR;
+                    double z0 = zmin + (cell%m_gridNz)*dz;
+                    double R1 = R0 + dR;
+                    for(uint32_t attempt = 0; attempt < s_gridAttempts; ++attempt) {
+                        double R = sqrt(R0*R0 + uniform(generator)*(R1*R1 - R0*R0));
+                        double z = z0 + uniform(generator)*dz;
+                        if(!m_gridPartial[cell] || m_contour.inside(R,z)) {
+                            point = vektor(R,0,z);
+                            return true;
+                        }
+                    }
+                    return false;
+                }
+
+                static const uint32_t s_gridSubsamples = 4; /*!< \brief Number of sub-samples per cell and direction used to tabulate the grid. */
+                static const uint32_t s_gridAttempts = 64; /*!< \brief Number of tries to place a point in a partial cell before a new cell is drawn. */
+
                 equilibrium m_equilibrium; /*!< \brief Magnetic equilibrium */
                 radiationProfile m_profile; /*!< \brief Radiation profile */
                 probabilityDistribution m_radiationProbability; /*!< \brief Probability distribution of the radiation profile. */
-                boost::random::mt19937 m_generator; /*!< \brief Random number generator */
+                philox m_generator; /*!< \brief Random number generator */
                 boost::random::uniform_real_distribution<double> m_R; /*!< \brief Uniform random distribution \f$[R_{min},R_{max}]\f$ */
                 boost::random::uniform_real_distribution<double> m_z; /*!< \brief Uniform random distribution \f$[z_{min},z_{max}]\f$ */
                 boost::random::uniform_01<double> m_u; /*!< \brief Uniform random distribution \f$[0,1[\f$ */
                 boost::random::uniform_real_distribution<double> m_2pi; /*!< \brief Uniform random distribution \f$[0,2 \pi[\f$ */
                 bool m_hasContour; /*!< \brief Information if boundary contour is set. */
                 polygon m_contour; /*!< \brief Boundary contour. */
+                uint32_t m_gridNR; /*!< \brief Number of grid cells in R, zero if no grid is used. */
+                uint32_t m_gridNz; /*!< \brief Number of grid cells in z, zero if no grid is used. */
+                aliasTable m_gridTable; /*!< \brief Alias table of the grid cells. */
+                std::vector<double> m_gridColumn; /*!< \brief Normalized cumulative emission of the columns of grid cells in R. */
+                std::vector<double> m_gridCumulative; /*!< \brief Normalized cumulative emission of the grid cells within their column. */
+                std::vector<uint8_t> m_gridPartial; /*!< \brief Flag for cells which are only partly inside of the contour. */
+                mutable instanceMutex m_mutex; /*!< \brief Mutex guarding the instance. */
         };
     }
 }
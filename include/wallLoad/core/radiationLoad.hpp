@@ -4,10 +4,20 @@
 #include <boost/python.hpp>
 #include <stdint.h>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <limits>
+#include <atomic>
 #include <wallLoad/core/mesh.hpp>
 #include <wallLoad/core/hitResult.hpp>
 #include <wallLoad/core/radiationDistribution.hpp>
 #include <wallLoad/core/directionGenerator.hpp>
+#include <wallLoad/core/diffuseScatter.hpp>
+#include <wallLoad/core/reflectionPath.hpp>
+#include <wallLoad/core/samplingRounds.hpp>
+#include <wallLoad/core/philox.hpp>
+#include <wallLoad/core/sobolSequence.hpp>
+#include <wallLoad/core/instanceMutex.hpp>
 #include <boost/random.hpp>
 #include <boost/math/constants/constants.hpp>
 
@@ -18,6 +28,27 @@ namespace wallLoad {
          * This class calculates the radiation load onto the first wall for a given mesh and radiation distribution.
          * It is derived from std::vector to store the number of hits for each mesh element.
          * The calculation is done using a Monte Carlo approach.
+         *
+         * The emissivity of the mesh elements is the fraction of the incident power they absorb, the rest is reflected
+         * diffusely following Lambert's law about the element normal or, with the probability set by set_specular(), specularly.
+         * Every sample deposits the absorbed fraction of its weight on each element it hits and continues with the reflected rest,
+         * see reflectionPath.
+         * The hits count the first hit of every sample, the heat flux is calculated from the absorbed weights.
+         * With an emissivity of one every sample is absorbed where it first hits the wall and both are the same.
+         *
+         * With set_quasi_random() the source points and directions are taken from a scrambled Sobol sequence instead of
+         * pseudo-random numbers, see sample(). The samples are then split among get_replicas() independently scrambled
+         * replicas, whose spread gives the error estimate.
+         *
+         * For a mesh which covers only a toroidal sector, the sources can be restricted to a toroidal window with
+         * set_toroidal_window() or set_automatic_toroidal_window(), so fewer samples miss the mesh.
+         * The absorbed weights are recorded as traced, get_absorbed_fraction() counts every sample as the inverse of the
+         * fraction of the torus covered by the window, so it stays that of sources in the whole torus.
+         *
+         * For an instanced mesh the hits onto all copies are added up on the vertices of the mesh, or kept apart with
+         * set_per_instance().
+         * All functions lock the mutex of the instance, so it can be shared by several threads.
+         * While samples are added the recorded hits can be read, they grow after each round of add_samples().
          */
         class radiationLoad : public std::vector<uint32_t> {
             public:
@@ -26,16 +57,11 @@ namespace wallLoad {
                  * This constructor initializes the class with the given mesh and radiation distribution.
                  */
                 radiationLoad(const mesh & grid, const radiationDistribution & distribution) :
-                    std::vector<uint32_t>(grid.size(), 0),
-                    m_mesh(grid), m_radiationDistribution(distribution), m_directionGenerator(),
-                    m_generator(time(0)), m_2pi_distribution(0.0, 2.0*boost::math::constants::pi<double>()) {
+                    radiationLoad(grid, distribution, readLock(grid.get_mutex()), readLock(distribution.get_mutex())) {
                 }
                 /*! \brief Copy constructor */
                 radiationLoad(const radiationLoad & rhs) :
-                    std::vector<uint32_t>(rhs),
-                    m_mesh(rhs.m_mesh), m_radiationDistribution(rhs.m_radiationDistribution),
-                    m_directionGenerator(), m_generator(time(0)), 
-                    m_2pi_distribution(0.0, 2.0*boost::math::constants::pi<double>()) {
+                    radiationLoad(rhs, readLock(rhs.m_mutex)) {
                 }
 
                 /*! \brief Destructor */
@@ -48,78 +74,455 @@ namespace wallLoad {
                  */
                 radiationLoad & operator=(const radiationLoad & rhs) {
                     if(this != &rhs) {
-                        std::vector<uint32_t>::operator=(rhs);
-                        m_mesh = rhs.m_mesh;
-                        m_radiationDistribution = rhs.m_radiationDistribution;
+                        radiationLoad copy(rhs);
+                        writeLock lock(m_mutex);
+                        std::vector<uint32_t>::operator=(copy);
+                        m_absorbed = copy.m_absorbed;
+                        m_absorbedSquared = copy.m_absorbedSquared;
+                        m_replicaAbsorbed = copy.m_replicaAbsorbed;
+                        m_replicaTotal = copy.m_replicaTotal;
+                        m_mesh = copy.m_mesh;
+                        m_radiationDistribution = copy.m_radiationDistribution;
+                        m_specular = copy.m_specular;
+                        m_quasiRandom = copy.m_quasiRandom;
+                        m_replicas = copy.m_replicas;
+                        m_phiMin = copy.m_phiMin;
+                        m_phiWidth = copy.m_phiWidth;
+                        m_emitted = copy.m_emitted;
+                        m_torusSamples = copy.m_torusSamples;
+                        m_perInstance = copy.m_perInstance;
+                        m_threads = copy.m_threads;
+                        m_seed = copy.m_seed;
+                        m_sample = copy.m_sample;
+                        ++m_generation;
                     }
                     return *this;
                 }
 
                 /*! \brief Clear the recorded hits.
                  *
-                 * This function sets the recorded hits of all mesh elements to zero.
+                 * This function sets the recorded hits and absorbed weights of all mesh elements to zero.
                  */
                 void clear() {
+                    writeLock lock(m_mutex);
                     std::fill(begin(), end(), 0);
+                    std::fill(m_absorbed.begin(), m_absorbed.end(), 0.0);
+                    std::fill(m_absorbedSquared.begin(), m_absorbedSquared.end(), 0.0);
+                    std::fill(m_replicaAbsorbed.begin(), m_replicaAbsorbed.end(), 0.0);
+                    std::fill(m_replicaTotal.begin(), m_replicaTotal.end(), 0.0);
+                    m_emitted = 0;
+                    m_torusSamples = 0.0;
+                    ++m_generation;
                 }
 
+                /*! \brief Progress of add_samples()
+                 *
+                 * The counters can be read and the cancel flag can be set by other threads while add_samples() runs.
+                 */
+                struct progress {
+                    progress() : samples(0), hits(0), cancel(false) {}
+                    std::atomic<uint64_t> samples; /*!< \brief Number of samples traced, including the ones that missed the mesh. */
+                    std::atomic<uint32_t> hits; /*!< \brief Number of hits recorded. */
+                    std::atomic<bool> cancel; /*!< \brief Set to stop add_samples() after the current round. */
+                };
+
                 /*! \brief Add samples
                  *
                  * This function calculates the hits for N random samples.
                  */
                 void add_samples(const uint32_t N) {
-                    hitResult temp;
-                    for(uint32_t i = 0; i < N; ) {
-                        temp = m_mesh.evaluateHit(m_radiationDistribution.get_random_toroidal_point(), m_directionGenerator.generate());
-                        if(temp) {
-                            ++std::vector<uint32_t>::operator[](temp.element);
-                            ++i;
+                    progress state;
+                    add_samples(N, state);
+                }
+
+                /*! \brief Add samples
+                 *
+                 * This function calculates the hits for N random samples and reports its progress in the given state.
+                 * The samples are traced in rounds of contiguous blocks of sample indices, one per thread, see samplingRounds.
+                 * Each thread records its hits in a private list, the lists are added to the recorded hits in the order
+                 * of the sample indices until N samples have hit the wall.
+                 * The result therefore only depends on the seed and the number of samples added before,
+                 * not on the number of threads.
+                 * A round is traced again if the sampling was changed meanwhile, e.g. by set_seed(), set_specular(),
+                 * set_per_instance() or set_toroidal_window(), each of which increments the generation counter.
+                 * The function returns false if it was stopped by the cancel flag of the state before N hits were recorded.
+                 */
+                bool add_samples(const uint32_t N, progress & state) {
+                    return samplingRounds::add(*this, N, s_minBlock, &state.cancel,
+                        [this, &state](const std::vector<sampleList> & lists, const uint64_t first, uint64_t & next, const uint64_t remaining) {
+                            uint32_t replicas = m_replicaTotal.size();
+                            uint32_t recorded = 0;
+                            for(auto list = lists.begin(); list != lists.end(); ++list) {
+                                for(auto hit = list->begin(); hit != list->end(); ++hit) {
+                                    if(hit->first) {
+                                        if(recorded == remaining) {
+                                            break;
+                                        }
+                                        ++std::vector<uint32_t>::operator[](hit->element);
+                                        if(++recorded == remaining) {
+                                            next = hit->sample + 1;
+                                        }
+                                    }
+                                    double weight = hit->weight;
+                                    m_absorbed[hit->element] += weight;
+                                    m_absorbedSquared[hit->element] += weight*weight;
+                                    if(replicas > 0) {
+                                        uint32_t replica = hit->sample % replicas;
+                                        m_replicaAbsorbed[replica*size() + hit->element] += weight;
+                                        m_replicaTotal[replica] += weight;
+                                    }
+                                }
+                            }
+                            m_emitted += next - first;
+                            m_torusSamples += (next - first)*2.0*boost::math::constants::pi<double>()/m_phiWidth;
+                            state.samples += next - first;
+                            state.hits += recorded;
+                            return recorded;
+                        });
+                }
+
+                /*! \brief Convergence criterion of add_samples_until()
+                 *
+                 * The criterion is met when the relative standard error of the heat flux density onto the checked
+                 * elements is at most the target.
+                 * The checked elements are the ones of the given physical groups, or all elements if no group is given,
+                 * whose heat flux density is at least peakFraction times the largest one among these elements.
+                 */
+                struct convergence {
+                    convergence() : target(0.05), peakFraction(0.5), physical(), maxHits(std::numeric_limits<uint32_t>::max()), minBatch(10000) {}
+                    double target; /*!< \brief Relative standard error to reach. */
+                    double peakFraction; /*!< \brief Elements with at least this fraction of the peak heat flux density are checked. */
+                    std::vector<int32_t> physical; /*!< \brief Physical groups of the checked elements, all elements if empty. */
+                    uint32_t maxHits; /*!< \brief Largest number of hits added before giving up. */
+                    uint32_t minBatch; /*!< \brief Smallest number of hits added between two checks of the criterion, at least one. The error estimate of a few hits is unreliable. */
+                };
+
+                /*! \brief Add samples until the heat flux density has converged
+                 *
+                 * This function adds samples in batches until the given criterion is met, then it returns true.
+                 * The size of each batch is estimated from the current error, assuming it falls with the square root
+                 * of the number of hits.
+                 * The function returns false if criterion.maxHits hits were added or it was cancelled by the state before
+                 * the criterion was met.
+                 */
+                bool add_samples_until(const convergence & criterion, progress & state) {
+                    uint32_t added = 0;
+                    while(true) {
+                        double error;
+                        uint32_t total;
+                        {
+                            readLock lock(m_mutex);
+                            error = peak_error(criterion);
+                            total = count_hits();
+                        }
+                        if(error <= criterion.target) {
+                            return true;
+                        }
+                        if(added >= criterion.maxHits || state.cancel) {
+                            return false;
+                        }
+                        double batch = criterion.minBatch;
+                        if(std::isfinite(error) && total > 0) {
+                            batch = std::max(batch, 1.1*total*(error*error/(criterion.target*criterion.target) - 1.0));
                         }
+                        uint32_t N = std::max<uint32_t>(1, std::min(batch, (double)(criterion.maxHits - added)));
+                        if(!add_samples(N, state)) {
+                            return false;
+                        }
+                        added += N;
+                    }
+                }
+
+                /*! \brief Add samples until the heat flux density has converged
+                 *
+                 * This function adds samples until the given criterion is met and returns whether it was met.
+                 */
+                bool add_samples_until(const convergence & criterion) {
+                    progress state;
+                    return add_samples_until(criterion, state);
+                }
+
+                /*! \brief Get the largest relative standard error of the elements checked by the given criterion.
+                 *
+                 * The result is infinite if none of the checked elements was hit.
+                 */
+                double get_peak_error(const convergence & criterion) const {
+                    readLock lock(m_mutex);
+                    return peak_error(criterion);
+                }
+
+                /*! \brief Set the seed
+                 *
+                 * This function sets the seed of the random number streams and restarts them at the first sample.
+                 * The recorded hits are not changed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    writeLock lock(m_mutex);
+                    m_seed = seed;
+                    m_sample = 0;
+                    ++m_generation;
+                }
+
+                /*! \brief Get the seed of the random number streams. */
+                uint64_t get_seed() const {
+                    readLock lock(m_mutex);
+                    return m_seed;
+                }
+
+                /*! \brief Get the number of samples drawn since the seed was set, including the ones that missed the mesh. */
+                uint64_t get_samples() const {
+                    readLock lock(m_mutex);
+                    return m_sample;
+                }
+
+                /*! \brief Set the number of threads used by add_samples(). */
+                void set_threads(const uint32_t threads) {
+                    writeLock lock(m_mutex);
+                    m_threads = std::max(1u, threads);
+                }
+
+                /*! \brief Get the number of threads used by add_samples(). */
+                uint32_t get_threads() const {
+                    readLock lock(m_mutex);
+                    return m_threads;
+                }
+
+                /*! \brief Set the probability that a reflection is specular instead of diffuse. */
+                void set_specular(const double specular) {
+                    if(!(specular >= 0.0 && specular <= 1.0)) {
+                        throw std::invalid_argument("the specular fraction needs to be in [0,1]");
+                    }
+                    writeLock lock(m_mutex);
+                    m_specular = specular;
+                    ++m_generation;
+                }
+
+                /*! \brief Get the probability that a reflection is specular instead of diffuse. */
+                double get_specular() const {
+                    readLock lock(m_mutex);
+                    return m_specular;
+                }
+
+                /*! \brief Switch between quasi-random and pseudo-random sampling
+                 *
+                 * This function selects whether the source points and directions are taken from a scrambled Sobol sequence.
+                 * The errors of the two modes are estimated differently, so switching clears the recorded hits
+                 * and restarts the samples at the first one.
+                 */
+                void set_quasi_random(const bool quasiRandom) {
+                    writeLock lock(m_mutex);
+                    m_quasiRandom = quasiRandom;
+                    reset_sampling();
+                }
+
+                /*! \brief Check if the source points and directions are quasi-random. */
+                bool is_quasi_random() const {
+                    readLock lock(m_mutex);
+                    return m_quasiRandom;
+                }
+
+                /*! \brief Set the number of replicas of quasi-random sampling
+                 *
+                 * The samples are distributed among the given number of independently scrambled copies of the Sobol sequence.
+                 * More replicas give a more reliable error estimate, fewer keep more of the uniformity of the sequence.
+                 * Changing the number clears the recorded hits and restarts the samples at the first one.
+                 */
+                void set_replicas(const uint32_t replicas) {
+                    if(replicas < 2) {
+                        throw std::invalid_argument("at least two replicas are needed to estimate the error");
+                    }
+                    writeLock lock(m_mutex);
+                    m_replicas = replicas;
+                    reset_sampling();
+                }
+
+                /*! \brief Get the number of replicas of quasi-random sampling. */
+                uint32_t get_replicas() const {
+                    readLock lock(m_mutex);
+                    return m_replicas;
+                }
+
+                /*! \brief Restrict the sources to a toroidal window
+                 *
+                 * The sources are only drawn at toroidal angles in \f$[\varphi_{min},\varphi_{max}[\f$, in radians.
+                 * This is only correct if no source outside of the window can reach the mesh.
+                 * A window of at least \f$2\pi\f$ is the whole torus.
+                 * The recorded hits are kept, the absorbed fraction counts the samples of every window for the whole torus.
+                 */
+                void set_toroidal_window(const double phiMin, const double phiMax) {
+                    if(!(phiMax > phiMin) || !std::isfinite(phiMin) || !std::isfinite(phiMax)) {
+                        throw std::invalid_argument("the toroidal window needs phiMin < phiMax");
+                    }
+                    writeLock lock(m_mutex);
+                    set_window(phiMin, phiMax - phiMin);
+                }
+
+                /*! \brief Restrict the sources to the toroidal window which can see the mesh
+                 *
+                 * The window is the toroidal extent of the mesh, see mesh::get_toroidal_extent(), widened on both sides by
+                 * \f$\arccos(R_{in}/R_{source}) + \arccos(R_{in}/R_{mesh})\f$, the largest toroidal angle between a source and
+                 * a mesh element whose line of sight does not come closer than \f$R_{in}\f$ to the axis.
+                 * Here \f$R_{source}\f$ and \f$R_{mesh}\f$ are the largest distances of the sources and the mesh from the axis
+                 * and \f$R_{in}\f$ is the smaller of the smallest ones, so the inner wall is taken as opaque.
+                 * If the mesh covers the whole torus or the window would, the sources are drawn in the whole torus.
+                 */
+                void set_automatic_toroidal_window() {
+                    writeLock lock(m_mutex);
+                    double phiMin, phiWidth, Rmin, Rmax;
+                    m_mesh.get_toroidal_extent(phiMin, phiWidth, Rmin, Rmax);
+                    double Rin = std::min(Rmin, m_radiationDistribution.get_Rmin());
+                    double Rsource = std::max(Rin, m_radiationDistribution.get_Rmax());
+                    if(!(Rin > 0.0)) {
+                        set_window(0.0, 2.0*boost::math::constants::pi<double>());
+                        return;
                     }
+                    double cone = acos(Rin/Rsource) + acos(Rin/std::max(Rin, Rmax));
+                    set_window(phiMin - cone, phiWidth + 2.0*cone);
+                }
+
+                /*! \brief Draw the sources in the whole torus. */
+                void clear_toroidal_window() {
+                    writeLock lock(m_mutex);
+                    set_window(0.0, 2.0*boost::math::constants::pi<double>());
+                }
+
+                /*! \brief Get the toroidal window of the sources as \f$(\varphi_{min},\varphi_{max})\f$. */
+                std::pair<double, double> get_toroidal_window() const {
+                    readLock lock(m_mutex);
+                    return std::make_pair(m_phiMin, m_phiMin + m_phiWidth);
+                }
+
+                /*! \brief Get the number of samples traced since the hits were cleared, including the ones that missed the mesh. */
+                uint64_t get_emitted_samples() const {
+                    readLock lock(m_mutex);
+                    return m_emitted;
+                }
+
+                /*! \brief Get the fraction of the radiated power absorbed by the mesh
+                 *
+                 * This is the total absorbed weight per sample. For a mesh which does not enclose the plasma, e.g. a sector,
+                 * the power onto the mesh for get_heat_flux() is this fraction of the total radiated power.
+                 * With a toroidal window every sample stands for the inverse of the fraction of the torus covered by the window.
+                 */
+                double get_absorbed_fraction() const {
+                    readLock lock(m_mutex);
+                    return m_torusSamples > 0.0 ? total_absorbed()/m_torusSamples : 0.0;
+                }
+
+                /*! \brief Keep the hits of the copies of an instanced mesh apart
+                 *
+                 * By default the hits onto all copies of an instanced mesh, see mesh::set_instances(), are added up
+                 * on the vertices of the mesh and the heat flux density is the mean over the copies.
+                 * If perInstance is set, the hits are recorded for every vertex of every copy, the kth copy following the
+                 * (k-1)th, so size() is the number of vertices times the number of copies.
+                 * Switching clears the recorded hits and restarts the samples at the first one.
+                 */
+                void set_per_instance(const bool perInstance) {
+                    writeLock lock(m_mutex);
+                    m_perInstance = perInstance;
+                    uint32_t N = m_mesh.size()*(perInstance ? m_mesh.get_instance_count() : 1);
+                    std::vector<uint32_t>::assign(N, 0);
+                    m_absorbed.assign(N, 0.0);
+                    m_absorbedSquared.assign(N, 0.0);
+                    reset_sampling();
+                }
+
+                /*! \brief Check if the hits of the copies of an instanced mesh are kept apart. */
+                bool is_per_instance() const {
+                    readLock lock(m_mutex);
+                    return m_perInstance;
                 }
 
                 /*! \brief Get number of hits for ith element. */
                 uint32_t operator[] (const uint32_t i) const {
+                    readLock lock(m_mutex);
                     return std::vector<uint32_t>::operator[](i);
                 }
 
+                /*! \brief Get the recorded hits
+                 *
+                 * This function returns a copy of the number of hits of all mesh elements, taken at a single point in time.
+                 */
+                std::vector<uint32_t> get_hits() const {
+                    readLock lock(m_mutex);
+                    return *this;
+                }
+
+                /*! \brief Get the absorbed weights
+                 *
+                 * This function returns a copy of the weight absorbed by every mesh element, in units of a sample of the whole torus.
+                 */
+                std::vector<double> get_absorbed() const {
+                    readLock lock(m_mutex);
+                    std::vector<double> absorbed(m_absorbed);
+                    if(m_torusSamples > 0.0) {
+                        double scale = m_emitted/m_torusSamples;
+                        for(auto iter = absorbed.begin(); iter != absorbed.end(); ++iter) {
+                            *iter *= scale;
+                        }
+                    }
+                    return absorbed;
+                }
+
                 /*! \brief Get total number of hits
                  *
                  * This function returns the total number of hits recorded.
                  * \f$N = \sum\limits N_i\f$
                  */
                 uint32_t get_total_hits() const {
-                    return std::accumulate(begin(), end(), 0);
+                    readLock lock(m_mutex);
+                    return count_hits();
                 }
 
                 /*! \brief Calculate the heat flux density onto mesh elements
                  *
-                 * Provided the total power, this function calculates the heat flux density onto the different mesh elements.
-                 * \f$ P_i = P_{tot} \frac{N_i}{N A_i} \f$
+                 * Provided the total power, this function calculates the heat flux density onto the different mesh elements
+                 * from the absorbed weights \f$W_i\f$.
+                 * \f$ P_i = P_{tot} \frac{W_i}{W A_i} \f$
                  */
                 std::vector<double> get_heat_flux(const double Ptot) const {
-                    uint32_t hits = get_total_hits();
-                    std::vector<double> areas = m_mesh.get_areas();
-                    std::vector<double>::const_iterator area = areas.begin();
-                    std::vector<double> output;
-                    for(auto iter = begin(); iter != end(); ++iter, ++area) {
-                        output.push_back((double)*iter/hits/(*area)*Ptot);
+                    readLock lock(m_mutex);
+                    std::vector<double> output(size());
+                    double total = total_absorbed();
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        output[i] = m_absorbed[i]/total/area(i)*Ptot;
                     }
                     return output;
                 }
 
-                /*! \brief Calculate the heat flux density onto mesh elements and return them as python list
+                /*! \brief Calculate the heat flux density onto mesh elements and its relative standard error
+                 *
+                 * This function resizes both vectors to size() and fills them from the same hits,
+                 * see get_relative_error() for the error.
+                 */
+                void get_heat_flux(const double Ptot, std::vector<double> & heatFlux, std::vector<double> & error) const {
+                    readLock lock(m_mutex);
+                    heatFlux.resize(size());
+                    error.resize(size());
+                    double total = total_absorbed();
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        heatFlux[i] = m_absorbed[i]/total/area(i)*Ptot;
+                        error[i] = relative_error(i, total);
+                    }
+                }
+
+                /*! \brief Calculate the relative standard error of the heat flux density onto mesh elements
                  *
-                 * Provided the total power, this function calculates the heat flux density onto the different mesh elements.
-                 * \f$ P_i = P_{tot} \frac{N_i}{N A_i} \f$
-                 * This function is intended as python interface.
-                 * Do not use this function from within C++.
+                 * The relative standard error of the heat flux density onto an element with the absorbed weight \f$W_i\f$ of
+                 * \f$W\f$ and the sum of the squared weights \f$S_i\f$ is estimated as \f$ \sqrt{\left(S_i/W_i - W_i/W\right)/W_i} \f$.
+                 * For unit weights, i.e. an emissivity of one, the hits are multinomially distributed among the elements and
+                 * this is the exact \f$ \sqrt{\left(1 - N_i/N\right)/N_i} \f$ for \f$N_i\f$ of \f$N\f$ hits.
+                 * It is infinite for elements without hits.
+                 * For quasi-random sampling the heat flux density is estimated separately from each of the \f$M\f$ replicas,
+                 * and the relative standard error is the standard deviation of these estimates divided by \f$\sqrt{M}\f$
+                 * and the heat flux density.
                  */
-                boost::python::list get_heat_flux_python(const double Ptot) const {
-                    boost::python::list output;
-                    std::vector<double> heatFlux = get_heat_flux(Ptot);
-                    for(auto iter = heatFlux.begin(); iter != heatFlux.end(); ++iter) {
-                        output.append(*iter);
+                std::vector<double> get_relative_error() const {
+                    readLock lock(m_mutex);
+                    std::vector<double> output(size());
+                    double total = total_absorbed();
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        output[i] = relative_error(i, total);
                     }
                     return output;
                 }
@@ -129,15 +532,238 @@ namespace wallLoad {
                  * This function returns the mesh of the first wall.
                  */
                 mesh get_mesh() const {
+                    readLock lock(m_mutex);
                     return m_mesh;
                 }
 
             protected:
+                /*! \brief Constructor
+                 *
+                 * This constructor copies the given mesh and radiation distribution while the given locks keep them unchanged.
+                 */
+                radiationLoad(const mesh & grid, const radiationDistribution & distribution, const readLock &, const readLock &) :
+                    std::vector<uint32_t>(grid.size(), 0),
+                    m_absorbed(grid.size(), 0.0), m_absorbedSquared(grid.size(), 0.0),
+                    m_replicaAbsorbed(), m_replicaTotal(),
+                    m_mesh(grid), m_radiationDistribution(distribution), m_directionGenerator(), m_diffuseScatter(),
+                    m_2pi_distribution(0.0, 2.0*boost::math::constants::pi<double>()),
+                    m_specular(0.0), m_quasiRandom(false), m_replicas(s_defaultReplicas),
+                    m_phiMin(0.0), m_phiWidth(2.0*boost::math::constants::pi<double>()), m_emitted(0), m_torusSamples(0.0), m_perInstance(false),
+                    m_threads(1), m_seed(philox::default_seed), m_sample(0), m_generation(0) {
+                }
+
+                /*! \brief Copy constructor
+                 *
+                 * This constructor copies the given instance while the given lock keeps it unchanged.
+                 */
+                radiationLoad(const radiationLoad & rhs, const readLock &) :
+                    std::vector<uint32_t>(rhs),
+                    m_absorbed(rhs.m_absorbed), m_absorbedSquared(rhs.m_absorbedSquared),
+                    m_replicaAbsorbed(rhs.m_replicaAbsorbed), m_replicaTotal(rhs.m_replicaTotal),
+                    m_mesh(rhs.m_mesh), m_radiationDistribution(rhs.m_radiationDistribution),
+                    m_directionGenerator(), m_diffuseScatter(),
+                    m_2pi_distribution(0.0, 2.0*boost::math::constants::pi<double>()),
+                    m_specular(rhs.m_specular), m_quasiRandom(rhs.m_quasiRandom), m_replicas(rhs.m_replicas),
+                    m_phiMin(rhs.m_phiMin), m_phiWidth(rhs.m_phiWidth), m_emitted(rhs.m_emitted), m_torusSamples(rhs.m_torusSamples), m_perInstance(rhs.m_perInstance),
+                    m_threads(rhs.m_threads), m_seed(rhs.m_seed), m_sample(rhs.m_sample), m_generation(rhs.m_generation) {
+                }
+
+                /*! \brief Get the total number of hits without locking the instance. */
+                uint32_t count_hits() const {
+                    return std::accumulate(begin(), end(), 0);
+                }
+
+                /*! \brief Get the total absorbed weight without locking the instance. */
+                double total_absorbed() const {
+                    return std::accumulate(m_absorbed.begin(), m_absorbed.end(), 0.0);
+                }
+
+                /*! \brief Index of the recorded hits of the given vertex of the given copy of the mesh. */
+                int32_t tally(const int32_t element, const uint32_t instance) const {
+                    return m_perInstance ? instance*m_mesh.size() + element : element;
+                }
+
+                /*! \brief Area over which the recorded hits of the ith element are spread
+                 *
+                 * This is the area of the vertex, times the number of copies of the mesh if their hits are added up,
+                 * so the heat flux density is their mean.
+                 */
+                double area(const uint32_t i) const {
+                    double area = m_mesh.get_vertex(i % m_mesh.size()).get_area();
+                    return m_perInstance ? area : area*m_mesh.get_instance_count();
+                }
+
+                /*! \brief Clear the recorded hits and restart the samples for the current sampling without locking the instance. */
+                void reset_sampling() {
+                    std::fill(begin(), end(), 0);
+                    std::fill(m_absorbed.begin(), m_absorbed.end(), 0.0);
+                    std::fill(m_absorbedSquared.begin(), m_absorbedSquared.end(), 0.0);
+                    m_replicaAbsorbed.assign(m_quasiRandom ? (size_t)m_replicas*size() : 0, 0.0);
+                    m_replicaTotal.assign(m_quasiRandom ? m_replicas : 0, 0.0);
+                    m_emitted = 0;
+                    m_torusSamples = 0.0;
+                    m_sample = 0;
+                    ++m_generation;
+                }
+
+                /*! \brief Set the toroidal window without locking the instance, a width of at least \f$2\pi\f$ is the whole torus. */
+                void set_window(const double phiMin, const double phiWidth) {
+                    ++m_generation;
+                    if(phiWidth >= 2.0*boost::math::constants::pi<double>()) {
+                        m_phiMin = 0.0;
+                        m_phiWidth = 2.0*boost::math::constants::pi<double>();
+                    }
+                    else {
+                        m_phiMin = phiMin;
+                        m_phiWidth = phiWidth;
+                    }
+                }
+
+                /*! \brief Relative standard error of the ith element for the given total absorbed weight. */
+                double relative_error(const uint32_t i, const double total) const {
+                    if(m_absorbed[i] == 0.0) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    if(!m_replicaTotal.empty()) {
+                        uint32_t M = m_replicaTotal.size();
+                        double mean = m_absorbed[i]/total;
+                        double sum = 0.0;
+                        for(uint32_t r = 0; r < M; ++r) {
+                            if(m_replicaTotal[r] == 0.0) {
+                                return std::numeric_limits<double>::infinity();
+                            }
+                            double deviation = m_replicaAbsorbed[r*size() + i]/m_replicaTotal[r] - mean;
+                            sum += deviation*deviation;
+                        }
+                        return std::sqrt(sum/(M*(M - 1.0)))/mean;
+                    }
+                    return std::sqrt(std::max(0.0, (m_absorbedSquared[i]/m_absorbed[i] - m_absorbed[i]/total)/m_absorbed[i]));
+                }
+
+                /*! \brief Get the largest relative standard error of the checked elements without locking the instance. */
+                double peak_error(const convergence & criterion) const {
+                    const std::vector<int32_t> & physical = m_mesh.get_physical();
+                    std::vector<std::pair<uint32_t, double> > elements;
+                    double peak = 0.0;
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        if(criterion.physical.empty() ||
+                            std::find(criterion.physical.begin(), criterion.physical.end(), physical[i % m_mesh.size()]) != criterion.physical.end()) {
+                            elements.push_back(std::make_pair(i, m_absorbed[i]/area(i)));
+                            peak = std::max(peak, elements.back().second);
+                        }
+                    }
+                    if(peak == 0.0) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    double total = total_absorbed();
+                    double error = 0.0;
+                    for(auto iter = elements.begin(); iter != elements.end(); ++iter) {
+                        if(iter->second >= criterion.peakFraction*peak) {
+                            error = std::max(error, relative_error(iter->first, total));
+                        }
+                    }
+                    return error;
+                }
+
+                /*! \brief Weight deposited by a sample on an element. */
+                struct sampleHit {
+                    uint64_t sample; /*!< \brief Index of the sample. */
+                    int32_t element; /*!< \brief Element that got hit. */
+                    bool first; /*!< \brief Whether this is the first hit of the sample. */
+                    double weight; /*!< \brief Absorbed weight. */
+                };
+                typedef std::vector<sampleHit> sampleList; /*!< \brief Hits of a block of samples. */
+
+                /*! \brief Trace the samples with the given indices.
+                 *
+                 * This function traces the samples first, ..., first + N - 1 and appends their hits to the given list.
+                 * The directions are generated in batches of samplingRounds::s_directionBatch samples.
+                 * For quasi-random sampling sample i is point i/M of the Sobol sequence of replica i%M of the M replicas,
+                 * scrambled with seeds drawn from the scramble stream for the seed and the replica.
+                 * Its coordinates give \f$R\f$ and \f$z\f$, the toroidal angle and the two angles of the direction,
+                 * see radiationDistribution::get_quasi_random_toroidal_point() and directionGenerator::get_direction().
+                 * The sources are drawn in the toroidal window, the weights of the hits are scaled when they are added.
+                 * The hits of a sample follow its path, see reflectionPath, reflections draw from a third random number stream
+                 * keyed with the seed and the sample index.
+                 * It is run by each thread of add_samples() and only reads the instance.
+                 */
+                void sample(const uint64_t first, const uint64_t N, sampleList & hits) const {
+                    philox sourceGenerator;
+                    philox scatterGenerator;
+                    double x[samplingRounds::s_directionBatch], y[samplingRounds::s_directionBatch], z[samplingRounds::s_directionBatch];
+                    hits.clear();
+                    const std::vector<double> & emissivity = m_mesh.get_emissivity();
+                    uint32_t replicas = m_replicaTotal.size();
+                    std::vector<uint32_t> scrambles(replicas*sobolSequence::s_dimensions);
+                    for(uint32_t r = 0; r < replicas; ++r) {
+                        philox scrambleGenerator(m_seed, scrambleStream, r);
+                        for(uint32_t d = 0; d < sobolSequence::s_dimensions; ++d) {
+                            scrambles[r*sobolSequence::s_dimensions + d] = scrambleGenerator();
+                        }
+                    }
+                    for(uint64_t i = first; i < first + N; ++i) {
+                        sourceGenerator.seed(m_seed, sourceStream, i);
+                        vektor origin;
+                        vektor direction;
+                        if(replicas > 0) {
+                            double u[sobolSequence::s_dimensions];
+                            const uint32_t * scramble = &scrambles[(i % replicas)*sobolSequence::s_dimensions];
+                            for(uint32_t d = 0; d < sobolSequence::s_dimensions; ++d) {
+                                u[d] = m_sobolSequence.get(i/replicas, d, scramble[d]);
+                            }
+                            origin = m_radiationDistribution.get_quasi_random_toroidal_point(u, sourceGenerator, m_phiMin, m_phiWidth);
+                            direction = directionGenerator::get_direction(u[3], u[4]);
+                        }
+                        else {
+                            if((i - first) % samplingRounds::s_directionBatch == 0) {
+                                m_directionGenerator.generate(m_seed, i, std::min(samplingRounds::s_directionBatch, first + N - i), x, y, z);
+                            }
+                            if(m_phiWidth < 2.0*boost::math::constants::pi<double>()) {
+                                origin = m_radiationDistribution.get_random_toroidal_point(sourceGenerator, m_phiMin, m_phiWidth);
+                            }
+                            else {
+                                origin = m_radiationDistribution.get_random_toroidal_point(sourceGenerator);
+                            }
+                            uint64_t j = (i - first) % samplingRounds::s_directionBatch;
+                            direction = vektor(x[j], y[j], z[j]);
+                        }
+                        scatterGenerator.seed(m_seed, scatterStream, i);
+                        reflectionPath::trace(m_mesh, emissivity, m_specular, m_diffuseScatter, scatterGenerator, origin, direction,
+                            [i, this, &hits](const int32_t element, const uint32_t instance, const double weight, const bool first) {
+                                sampleHit hit = {i, tally(element, instance), first, weight};
+                                hits.push_back(hit);
+                            });
+                    }
+                }
+
+                std::vector<double> m_absorbed; /*!< \brief Weight absorbed by every mesh element. */
+                std::vector<double> m_absorbedSquared; /*!< \brief Sum of the squared absorbed weights of every mesh element. */
+                std::vector<double> m_replicaAbsorbed; /*!< \brief Weight absorbed by every mesh element in every replica, empty for pseudo-random sampling. */
+                std::vector<double> m_replicaTotal; /*!< \brief Total absorbed weight of every replica, empty for pseudo-random sampling. */
                 mesh m_mesh; /*!< \brief Mesh representing the first wall. */
                 radiationDistribution m_radiationDistribution; /*!< \brief Assumed radiation distribution of the plasma. */
                 directionGenerator m_directionGenerator; /*!< \brief Generator for random direction vectors. */
-                boost::random::mt19937 m_generator; /*!< \brief Random number generator for the Monte Carlo calculation */
+                diffuseScatter m_diffuseScatter; /*!< \brief Generator for diffusely reflected direction vectors. */
+                sobolSequence m_sobolSequence; /*!< \brief Sobol sequence of quasi-random sampling. */
                 boost::random::uniform_real_distribution<double> m_2pi_distribution; /*!< \brief Uniform random distribution \f$\left[0,2\pi\right[\f$. */
+                double m_specular; /*!< \brief Probability that a reflection is specular. */
+                bool m_quasiRandom; /*!< \brief Whether the source points and directions are quasi-random. */
+                uint32_t m_replicas; /*!< \brief Number of replicas of quasi-random sampling. */
+                double m_phiMin; /*!< \brief Smallest toroidal angle of the sources. */
+                double m_phiWidth; /*!< \brief Width of the toroidal window of the sources, \f$2\pi\f$ for the whole torus. */
+                uint64_t m_emitted; /*!< \brief Number of samples traced since the hits were cleared. */
+                double m_torusSamples; /*!< \brief Number of samples of the whole torus the traced samples stand for. */
+                bool m_perInstance; /*!< \brief Whether the hits of the copies of an instanced mesh are kept apart. */
+                uint32_t m_threads; /*!< \brief Number of threads used by add_samples(). */
+                uint64_t m_seed; /*!< \brief Seed of the random number streams. */
+                uint64_t m_sample; /*!< \brief Index of the next sample. */
+                uint64_t m_generation; /*!< \brief Counter of the changes of the sampling, a round of add_samples() is only added if it did not change. */
+                mutable instanceMutex m_mutex; /*!< \brief Mutex guarding the instance. */
+
+                static const uint64_t s_minBlock = 1024; /*!< \brief Smallest number of samples traced by a thread in one round. */
+                static const uint32_t s_defaultReplicas = 8; /*!< \brief Default number of replicas of quasi-random sampling. */
+
+                friend class samplingRounds;
 
         };
     }
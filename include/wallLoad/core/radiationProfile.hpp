@@ -3,6 +3,7 @@
 
 #include <boost/python.hpp>
 #include <stdint.h>
+#include <vector>
 #include <wallLoad/core/probabilityDistribution.hpp>
 
 namespace wallLoad {
@@ -20,10 +21,10 @@ namespace wallLoad {
                  * Do not use this constructor from within C++.
                  */
                 radiationProfile(const boost::python::list & rho, const boost::python::list & powerDensity) :
-                    N(boost::python::len(rho)), m_rho(new double[N]), m_powerDensity(new double[N]) {
+                    N(boost::python::len(rho)), m_rho(N), m_powerDensity(N) {
                     for(uint32_t i = 0; i < N; ++i) {
-                        *(m_rho + i) = boost::python::extract<double>(rho[i]);
-                        *(m_powerDensity + i) = boost::python::extract<double>(powerDensity[i]);
+                        m_rho[i] = boost::python::extract<double>(rho[i]);
+                        m_powerDensity[i] = boost::python::extract<double>(powerDensity[i]);
                     }
                 }
 
@@ -32,39 +33,7 @@ namespace wallLoad {
                  * This constructor initializes the radiation profile with the given power densities and \f$\rho_{pol}\f$ values.
                  */
                 radiationProfile(const std::vector<double> & rho, const std::vector<double> & powerDensity) :
-                    N(rho.size()), m_rho(new double[N]), m_powerDensity(new double[N]) {
-                    std::copy(rho.begin(), rho.end(), m_rho);
-                    std::copy(powerDensity.begin(), powerDensity.end(), m_powerDensity);
-                }
-
-                /*! \brief Copy constructor */
-                radiationProfile(const radiationProfile & rhs) : 
-                    N(rhs.N), m_rho(new double[N]), m_powerDensity(new double[N]) {
-                    std::copy(rhs.m_rho, rhs.m_rho+N, m_rho);
-                    std::copy(rhs.m_powerDensity, rhs.m_powerDensity+N, m_powerDensity);
-                }
-
-                /*! \brief Destructor */
-                virtual ~radiationProfile() {
-                    delete [] m_rho;
-                    delete [] m_powerDensity;
-                }
-
-                /*! \brief Assignment operator
-                 * 
-                 * This operator copies the radiation profile from the given instance to the current instance.
-                 */
-                radiationProfile & operator=(const radiationProfile & rhs) {
-                    if(this != &rhs) {
-                        N = rhs.N;
-                        delete [] m_rho;
-                        delete [] m_powerDensity;
-                        m_rho = new double[N];
-                        m_powerDensity = new double[N];
-                        std::copy(rhs.m_rho, rhs.m_rho + N, m_rho);
-                        std::copy(rhs.m_powerDensity, rhs.m_powerDensity + N, m_powerDensity);
-                    }
-                    return *this;
+                    N(rho.size()), m_rho(rho), m_powerDensity(powerDensity) {
                 }
 
                 /*! \brief Get the \f$\rho_{pol}\f$ values.
@@ -72,7 +41,7 @@ namespace wallLoad {
                  * This function returns the \f$rho_{pol}\f$ values of the radiation profile.
                  */
                 std::vector<double> get_rho() const {
-                    return std::vector<double>(m_rho, m_rho + N);
+                    return m_rho;
                 }
 
                 /*! \brief Get the \f$\rho_{pol}\f$ values as python list.
@@ -83,7 +52,7 @@ namespace wallLoad {
                  */
                 boost::python::list get_rho_python() const { 
                     boost::python::list output;
-                    for(double * temp = m_rho; temp != m_rho + N; ++temp) {
+                    for(auto temp = m_rho.cbegin(); temp != m_rho.cend(); ++temp) {
                         output.append(*temp);
                     }
                     return output;
@@ -94,7 +63,7 @@ namespace wallLoad {
                  * This function returns the power densities of the radiation profile.
                  */
                 std::vector<double> get_powerDensity() const {
-                    return std::vector<double>(m_powerDensity, m_powerDensity + N);
+                    return m_powerDensity;
                 }
 
                 /*! \brief Get the power densities as python list.
@@ -105,7 +74,7 @@ namespace wallLoad {
                  */
                 boost::python::list get_powerDensity_python() const { 
                     boost::python::list output;
-                    for(double * temp = m_powerDensity; temp != m_powerDensity + N; ++temp) {
+                    for(auto temp = m_powerDensity.cbegin(); temp != m_powerDensity.cend(); ++temp) {
                         output.append(*temp);
                     }
                     return output;
@@ -119,7 +88,7 @@ namespace wallLoad {
                 probabilityDistribution get_probabilityDistribution() const {
                     double integral = 0.0;
                     for(uint32_t i = 0; i < N-1; ++i) {
-                        integral += 0.5*(*(m_powerDensity + i) + *(m_powerDensity + i + 1))*(*(m_rho + i + 1) - *(m_rho + i));
+                        integral += 0.5*(m_powerDensity[i] + m_powerDensity[i + 1])*(m_rho[i + 1] - m_rho[i]);
                     }
                     std::vector<double> rho = get_rho();
                     std::vector<double> powerDensity = get_powerDensity();
@@ -131,8 +100,8 @@ namespace wallLoad {
 
             protected:
                 uint32_t N; /*!< \brief Number of points on the radiation profile. */
-                double * m_rho; /*!< \brief \f$\rho_{pol}\f$ values of the radiation profile. */
-                double * m_powerDensity; /*!< \brief Power densities of the radiation profile. */
+                std::vector<double> m_rho; /*!< \brief \f$\rho_{pol}\f$ values of the radiation profile. */
+                std::vector<double> m_powerDensity; /*!< \brief Power densities of the radiation profile. */
         };
     }
 }
@@ -0,0 +1,94 @@
+#ifndef include_wallLoad_core_reflectionPath_hpp
+#define include_wallLoad_core_reflectionPath_hpp
+
+#include <stdint.h>
+#include <vector>
+#include <boost/random/uniform_01.hpp>
+#include <wallLoad/core/vektor.hpp>
+#include <wallLoad/core/mesh.hpp>
+#include <wallLoad/core/diffuseScatter.hpp>
+#include <wallLoad/core/philox.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Path of a sample through its reflections on the mesh.
+         *
+         * radiationLoad and responseMatrix follow their samples the same way.
+         * The emissivity of the mesh elements is the fraction of the incident power they absorb, the rest is reflected
+         * diffusely following Lambert's law about the element normal or, with the given probability, specularly.
+         * Every sample starts with the weight one, deposits the absorbed fraction of its weight on each element it hits
+         * and continues with the reflected rest.
+         * Once the weight falls below s_rouletteWeight the path is continued with this weight with the probability
+         * weight/s_rouletteWeight and ended otherwise (Russian roulette), which keeps the result unbiased and the cost bounded.
+         * Reflections leave the copy of an instanced mesh they hit in its frame, so paths can continue onto other copies.
+         */
+        class reflectionPath {
+            public:
+                /*! \brief Trace a sample and its reflections
+                 *
+                 * This function traces the ray from origin in the given direction and its reflections on the mesh.
+                 * For the first element hit it calls hit(element, instance, weight, true) with its emissivity as weight,
+                 * even if that is zero, for every later one hit(element, instance, weight, false) if it absorbs a weight.
+                 * \param grid Mesh of the first wall.
+                 * \param emissivity Emissivity of the vertices of the mesh.
+                 * \param specular Probability that a reflection is specular.
+                 * \param scatter Generator of diffusely reflected directions.
+                 * \param generator Random number generator of the reflections, seeded for the sample.
+                 * \param origin Position from where the ray originates.
+                 * \param direction The direction in which the ray travels, a unit vector.
+                 * \param hit Function called for the absorbed weights.
+                 */
+                template<typename callback>
+                static void trace(const mesh & grid, const std::vector<double> & emissivity, const double specular,
+                    const diffuseScatter & scatter, philox & generator, vektor origin, vektor direction, const callback & hit) {
+                    boost::random::uniform_01<double> uniform;
+                    double t;
+                    uint32_t instance;
+                    int32_t element = grid.evaluate_closest(origin, direction, t, instance);
+                    if(element < 0) {
+                        return;
+                    }
+                    hit(element, instance, emissivity[element], true);
+                    double weight = 1.0 - emissivity[element];
+                    if(weight <= 0.0) {
+                        return;
+                    }
+                    for(uint32_t bounce = 1; bounce < s_maxBounces; ++bounce) {
+                        if(weight < s_rouletteWeight) {
+                            if(uniform(generator)*s_rouletteWeight >= weight) {
+                                return;
+                            }
+                            weight = s_rouletteWeight;
+                        }
+                        vektor normal = grid.rotate(grid.get_vertex(element).get_normal(), instance);
+                        if(normal.get_dot_product(direction) > 0.0) {
+                            normal = -1.0*normal;
+                        }
+                        origin = origin + t*direction;
+                        if(specular > 0.0 && uniform(generator) < specular) {
+                            direction = direction - 2.0*direction.get_dot_product(normal)*normal;
+                        }
+                        else {
+                            direction = scatter.get_direction(normal, generator);
+                        }
+                        element = grid.evaluate_closest(origin, direction, t, instance);
+                        if(element < 0) {
+                            return;
+                        }
+                        if(emissivity[element] > 0.0) {
+                            hit(element, instance, weight*emissivity[element], false);
+                        }
+                        weight *= 1.0 - emissivity[element];
+                        if(weight <= 0.0) {
+                            return;
+                        }
+                    }
+                }
+
+                static constexpr double s_rouletteWeight = 0.1; /*!< \brief Weight below which Russian roulette decides if a path continues. */
+                static const uint32_t s_maxBounces = 1000; /*!< \brief Largest number of hits of a path, which ends a path in a closed loss-free cavity. */
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef include_wallLoad_core_responseMatrix_hpp
+#define include_wallLoad_core_responseMatrix_hpp
+
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <stdexcept>
+#include <wallLoad/core/mesh.hpp>
+#include <wallLoad/core/hitResult.hpp>
+#include <wallLoad/core/radiationDistribution.hpp>
+#include <wallLoad/core/radiationProfile.hpp>
+#include <wallLoad/core/directionGenerator.hpp>
+#include <wallLoad/core/diffuseScatter.hpp>
+#include <wallLoad/core/reflectionPath.hpp>
+#include <wallLoad/core/samplingRounds.hpp>
+#include <wallLoad/core/philox.hpp>
+#include <wallLoad/core/instanceMutex.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Response of the first wall to the emission on flux surfaces.
+         *
+         * This class traces the emission once, independent of the radiation profile, and tallies the hits of every
+         * mesh element against \f$\rho_{pol}\f$.
+         * The emission points are drawn uniformly in the volume given by the \f$(R,z)\f$ bounds and the boundary contour of a
+         * radiation distribution, whose radiation profile is not used.
+         * The \f$\rho_{pol}\f$ axis is resolved by Nrho nodes from 0 to rhoMax with piecewise linear hat functions,
+         * a sample at \f$\rho_{pol}\f$ adds its absorbed weight to the two neighbouring nodes with the linear interpolation weights.
+         * The samples are absorbed and reflected by the mesh elements as in radiationLoad, with the same emissivity,
+         * probability of specular reflection and Russian roulette, so every element tallies the weight it absorbs.
+         * The result is a sparse matrix \f$M_{ik}\f$ of mesh elements times nodes.
+         * The heat flux density of any radiation profile \f$\epsilon(\rho_{pol})\f$ then is the sparse matrix vector product
+         * \f$ P_i = P_{tot} \frac{\sum_k M_{ik} \epsilon(\rho_k)}{A_i \sum_{jk} M_{jk} \epsilon(\rho_k)} \f$,
+         * normalized to the power reaching the wall like radiationLoad.
+         * The hits onto all copies of an instanced mesh are added up, so \f$A_i\f$ is the area of all copies of the element.
+         * All functions lock the mutex of the instance, so it can be shared by several threads.
+         */
+        class responseMatrix {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor initializes an empty response of the given mesh to the volume of the given radiation distribution,
+                 * resolved by Nrho nodes from 0 to rhoMax.
+                 * A std::invalid_argument is thrown unless rhoMax is positive and finite.
+                 */
+                responseMatrix(const mesh & grid, const radiationDistribution & distribution, const uint32_t Nrho, const double rhoMax) :
+                    responseMatrix(grid, distribution, Nrho, rhoMax, readLock(grid.get_mutex()), readLock(distribution.get_mutex())) {
+                }
+
+                /*! \brief Copy constructor */
+                responseMatrix(const responseMatrix & rhs) :
+                    responseMatrix(rhs, readLock(rhs.m_mutex)) {
+                }
+
+                /*! \brief Assignment operator */
+                responseMatrix & operator=(const responseMatrix & rhs) {
+                    if(this != &rhs) {
+                        responseMatrix copy(rhs);
+                        writeLock lock(m_mutex);
+                        m_mesh = copy.m_mesh;
+                        m_radiationDistribution = copy.m_radiationDistribution;
+                        m_area = copy.m_area;
+                        m_rho = copy.m_rho;
+                        m_matrix = copy.m_matrix;
+                        m_specular = copy.m_specular;
+                        m_threads = copy.m_threads;
+                        m_seed = copy.m_seed;
+                        m_sample = copy.m_sample;
+                        ++m_generation;
+                    }
+                    return *this;
+                }
+
+                /*! \brief Clear the tallied hits. */
+                void clear() {
+                    writeLock lock(m_mutex);
+                    m_matrix.clear();
+                    ++m_generation;
+                }
+
+                /*! \brief Add samples
+                 *
+                 * This function traces N emission samples, including the ones outside of the contour or beyond rhoMax
+                 * which emit nothing.
+                 * Like radiationLoad::add_samples() the samples are traced in rounds of contiguous blocks, one per thread,
+                 * and the hits are added in the order of the sample indices, see samplingRounds.
+                 * The result therefore does not depend on the number of threads.
+                 * A round is traced again if clear(), set_seed() or set_specular() was called meanwhile.
+                 */
+                void add_samples(const uint64_t N) {
+                    samplingRounds::add(*this, N, 0, 0,
+                        [this](const std::vector<sampleList> & lists, const uint64_t first, uint64_t & next, const uint64_t) {
+                            for(auto list = lists.begin(); list != lists.end(); ++list) {
+                                for(auto hit = list->begin(); hit != list->end(); ++hit) {
+                                    add_hit(hit->element, hit->rho, hit->weight);
+                                }
+                            }
+                            return next - first;
+                        });
+                }
+
+                /*! \brief Set the seed
+                 *
+                 * This function sets the seed of the random number streams and restarts them at the first sample.
+                 * The tallied hits are not changed.
+                 */
+                void set_seed(const uint64_t seed) {
+                    writeLock lock(m_mutex);
+                    m_seed = seed;
+                    m_sample = 0;
+                    ++m_generation;
+                }
+
+                /*! \brief Get the seed of the random number streams. */
+                uint64_t get_seed() const {
+                    readLock lock(m_mutex);
+                    return m_seed;
+                }
+
+                /*! \brief Get the number of samples traced since the seed was set. */
+                uint64_t get_samples() const {
+                    readLock lock(m_mutex);
+                    return m_sample;
+                }
+
+                /*! \brief Set the probability that a reflection is specular instead of diffuse
+                 *
+                 * The tallied hits are not changed, so they should be cleared if they were traced with another probability.
+                 */
+                void set_specular(const double specular) {
+                    if(!(specular >= 0.0 && specular <= 1.0)) {
+                        throw std::invalid_argument("the specular fraction needs to be in [0,1]");
+                    }
+                    writeLock lock(m_mutex);
+                    m_specular = specular;
+                    ++m_generation;
+                }
+
+                /*! \brief Get the probability that a reflection is specular instead of diffuse. */
+                double get_specular() const {
+                    readLock lock(m_mutex);
+                    return m_specular;
+                }
+
+                /*! \brief Set the number of threads used by add_samples(). */
+                void set_threads(const uint32_t threads) {
+                    writeLock lock(m_mutex);
+                    m_threads = std::max(1u, threads);
+                }
+
+                /*! \brief Get the number of threads used by add_samples(). */
+                uint32_t get_threads() const {
+                    readLock lock(m_mutex);
+                    return m_threads;
+                }
+
+                /*! \brief Get the number of mesh elements. */
+                uint32_t size() const {
+                    return m_area.size();
+                }
+
+                /*! \brief Get the \f$\rho_{pol}\f$ values of the nodes. */
+                const std::vector<double> & get_rho() const {
+                    return m_rho;
+                }
+
+                /*! \brief Get the number of non-zero entries of the matrix. */
+                uint64_t get_entries() const {
+                    readLock lock(m_mutex);
+                    return m_matrix.size();
+                }
+
+                /*! \brief Get the non-zero entries of the matrix
+                 *
+                 * This function writes the mesh element, the node and the value of the get_entries() non-zero entries
+                 * to the given memory, ordered by element and node.
+                 * The values are the summed absorbed weights of the hits times their interpolation weights, they are not normalized.
+                 */
+                void get_matrix(int32_t * element, int32_t * node, double * value, const uint64_t N) const {
+                    readLock lock(m_mutex);
+                    uint64_t i = 0;
+                    for(auto iter = m_matrix.begin(); iter != m_matrix.end() && i < N; ++iter, ++i) {
+                        element[i] = iter->first/m_rho.size();
+                        node[i] = iter->first%m_rho.size();
+                        value[i] = iter->second;
+                    }
+                }
+
+                /*! \brief Calculate the heat flux density onto mesh elements for the given radiation profile
+                 *
+                 * The radiation profile is evaluated at the nodes, so its structure should not be finer than the node spacing.
+                 */
+                std::vector<double> get_heat_flux(const radiationProfile & profile, const double Ptot) const {
+                    std::vector<double> output(size());
+                    get_heat_flux(profile, Ptot, output.data());
+                    return output;
+                }
+
+                /*! \brief Calculate the heat flux density onto mesh elements for the given radiation profile
+                 *
+                 * This function writes the heat flux density onto the size() mesh elements to the given memory.
+                 */
+                void get_heat_flux(const radiationProfile & profile, const double Ptot, double * output) const {
+                    probabilityDistribution emission = profile.get_probabilityDistribution();
+                    std::vector<double> values(m_rho.size());
+                    for(uint32_t k = 0; k < m_rho.size(); ++k) {
+                        values[k] = emission.get_value(m_rho[k]);
+                    }
+                    get_heat_flux(values.data(), Ptot, output);
+                }
+
+                /*! \brief Calculate the heat flux density onto mesh elements for the given emission at the nodes
+                 *
+                 * This function writes the heat flux density onto the size() mesh elements to the given memory,
+                 * for the power density emission[k] at the kth node.
+                 * The heat flux is zero if none of the emission reaches the wall, e.g. before samples were added
+                 * or for an emission outside of the tallied nodes.
+                 */
+                void get_heat_flux(const double * emission, const double Ptot, double * output) const {
+                    readLock lock(m_mutex);
+                    std::fill(output, output + size(), 0.0);
+                    double total = 0.0;
+                    for(auto iter = m_matrix.begin(); iter != m_matrix.end(); ++iter) {
+                        double power = iter->second*emission[iter->first%m_rho.size()];
+                        output[iter->first/m_rho.size()] += power;
+                        total += power;
+                    }
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        output[i] = total > 0.0 ? output[i]*(Ptot/total/m_area[i]) : 0.0;
+                    }
+                }
+
+            protected:
+                /*! \brief Constructor
+                 *
+                 * This constructor copies the given mesh and radiation distribution while the given locks keep them unchanged.
+                 */
+                responseMatrix(const mesh & grid, const radiationDistribution & distribution, const uint32_t Nrho, const double rhoMax,
+                    const readLock &, const readLock &) :
+                    m_mesh(grid), m_radiationDistribution(distribution), m_directionGenerator(), m_diffuseScatter(),
+                    m_area(grid.size()), m_rho(std::max(2u, Nrho)), m_matrix(), m_specular(0.0),
+                    m_threads(1), m_seed(philox::default_seed), m_sample(0), m_generation(0) {
+                    if(!(rhoMax > 0.0) || !std::isfinite(rhoMax)) {
+                        throw std::invalid_argument("rhoMax needs to be positive and finite");
+                    }
+                    for(uint32_t i = 0; i < m_area.size(); ++i) {
+                        m_area[i] = m_mesh.get_vertex(i).get_area()*m_mesh.get_instance_count();
+                    }
+                    for(uint32_t k = 0; k < m_rho.size(); ++k) {
+                        m_rho[k] = rhoMax*k/(m_rho.size() - 1);
+                    }
+                }
+
+                /*! \brief Copy constructor
+                 *
+                 * This constructor copies the given instance while the given lock keeps it unchanged.
+                 */
+                responseMatrix(const responseMatrix & rhs, const readLock &) :
+                    m_mesh(rhs.m_mesh), m_radiationDistribution(rhs.m_radiationDistribution), m_directionGenerator(), m_diffuseScatter(),
+                    m_area(rhs.m_area), m_rho(rhs.m_rho), m_matrix(rhs.m_matrix), m_specular(rhs.m_specular),
+                    m_threads(rhs.m_threads), m_seed(rhs.m_seed), m_sample(rhs.m_sample), m_generation(rhs.m_generation) {
+                }
+
+                /*! \brief Hit of a single sample. */
+                struct sampleHit {
+                    int32_t element; /*!< \brief Element that got hit. */
+                    double rho; /*!< \brief \f$\rho_{pol}\f$ of the emission point. */
+                    double weight; /*!< \brief Weight absorbed by the element. */
+                };
+                typedef std::vector<sampleHit> sampleList; /*!< \brief Hits of a block of samples. */
+
+                /*! \brief Add the absorbed weight of a hit to the two nodes next to the given \f$\rho_{pol}\f$ without locking the instance. */
+                void add_hit(const int32_t element, const double rho, const double weight) {
+                    double x = rho/m_rho.back()*(m_rho.size() - 1);
+                    uint32_t k = std::min((uint32_t)x, (uint32_t)m_rho.size() - 2);
+                    double t = x - k;
+                    uint64_t key = (uint64_t)element*m_rho.size() + k;
+                    if(t < 1.0) {
+                        m_matrix[key] += (1.0 - t)*weight;
+                    }
+                    if(t > 0.0) {
+                        m_matrix[key + 1] += t*weight;
+                    }
+                }
+
+                /*! \brief Trace the samples with the given indices.
+                 *
+                 * This function traces the samples first, ..., first + N - 1 and their reflections like radiationLoad,
+                 * see reflectionPath, and replaces the given list by the hits with the absorbed weights.
+                 * It is run by each thread of add_samples() and only reads the instance.
+                 */
+                void sample(const uint64_t first, const uint64_t N, sampleList & hits) const {
+                    philox sourceGenerator;
+                    philox scatterGenerator;
+                    double x[samplingRounds::s_directionBatch], y[samplingRounds::s_directionBatch], z[samplingRounds::s_directionBatch];
+                    const std::vector<double> & emissivity = m_mesh.get_emissivity();
+                    vektor point;
+                    double rho;
+                    hits.clear();
+                    for(uint64_t i = first; i < first + N; ++i) {
+                        if((i - first) % samplingRounds::s_directionBatch == 0) {
+                            m_directionGenerator.generate(m_seed, i, std::min(samplingRounds::s_directionBatch, first + N - i), x, y, z);
+                        }
+                        sourceGenerator.seed(m_seed, sourceStream, i);
+                        if(!m_radiationDistribution.get_random_volume_point(sourceGenerator, point, rho) || rho > m_rho.back()) {
+                            continue;
+                        }
+                        uint64_t j = (i - first) % samplingRounds::s_directionBatch;
+                        scatterGenerator.seed(m_seed, scatterStream, i);
+                        reflectionPath::trace(m_mesh, emissivity, m_specular, m_diffuseScatter, scatterGenerator, point, vektor(x[j], y[j], z[j]),
+                            [rho, &hits](const int32_t element, const uint32_t, const double weight, const bool) {
+                                if(weight > 0.0) {
+                                    sampleHit hit = {element, rho, weight};
+                                    hits.push_back(hit);
+                                }
+                            });
+                    }
+                }
+
+                mesh m_mesh; /*!< \brief Mesh representing the first wall. */
+                radiationDistribution m_radiationDistribution; /*!< \brief Radiation distribution giving the emitting volume. */
+                directionGenerator m_directionGenerator; /*!< \brief Generator for random direction vectors. */
+                diffuseScatter m_diffuseScatter; /*!< \brief Generator for diffusely reflected direction vectors. */
+                std::vector<double> m_area; /*!< \brief Areas of the mesh elements. */
+                std::vector<double> m_rho; /*!< \brief \f$\rho_{pol}\f$ values of the nodes. */
+                std::map<uint64_t, double> m_matrix; /*!< \brief Non-zero entries of the matrix, keyed by element times number of nodes plus node. */
+                double m_specular; /*!< \brief Probability that a reflection is specular. */
+                uint32_t m_threads; /*!< \brief Number of threads used by add_samples(). */
+                uint64_t m_seed; /*!< \brief Seed of the random number streams. */
+                uint64_t m_sample; /*!< \brief Index of the next sample. */
+                uint64_t m_generation; /*!< \brief Counter of the changes of the sampling, a round of add_samples() is only added if it did not change. */
+                mutable instanceMutex m_mutex; /*!< \brief Mutex guarding the instance. */
+
+                friend class samplingRounds;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef include_wallLoad_core_samplingJob_hpp
+#define include_wallLoad_core_samplingJob_hpp
+
+#include <stdint.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <wallLoad/core/radiationLoad.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Background job adding samples to a radiation load.
+         *
+         * This class runs radiationLoad::add_samples() or radiationLoad::add_samples_until() on a thread of its own
+         * and returns right away.
+         * The progress of the job can be queried and the job can be cancelled while it runs.
+         * The hits recorded so far can be read from the radiation load at any time,
+         * they grow after each round of samples.
+         * The radiation load has to exist as long as the job, the destructor cancels the job and waits for it.
+         */
+        class samplingJob {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor starts adding N samples to the given radiation load.
+                 */
+                samplingJob(radiationLoad & load, const uint32_t N) :
+                    m_load(load), m_requested(N), m_progress(), m_start(clock::now()), m_end(),
+                    m_done(false), m_complete(false), m_error(), m_mutex(), m_finished(), m_thread() {
+                    m_thread = std::thread(&samplingJob::run, this,
+                        [&load, N](radiationLoad::progress & state) { return load.add_samples(N, state); });
+                }
+
+                /*! \brief Constructor
+                 *
+                 * This constructor starts adding samples to the given radiation load until the given criterion is met,
+                 * see radiationLoad::add_samples_until().
+                 * The job is complete if the criterion was met.
+                 */
+                samplingJob(radiationLoad & load, const radiationLoad::convergence & criterion) :
+                    m_load(load), m_requested(criterion.maxHits), m_progress(), m_start(clock::now()), m_end(),
+                    m_done(false), m_complete(false), m_error(), m_mutex(), m_finished(), m_thread() {
+                    m_thread = std::thread(&samplingJob::run, this,
+                        [&load, criterion](radiationLoad::progress & state) { return load.add_samples_until(criterion, state); });
+                }
+
+                /*! \brief Destructor
+                 *
+                 * The destructor cancels the job and waits until the current round of samples is finished.
+                 */
+                ~samplingJob() {
+                    cancel();
+                    m_thread.join();
+                }
+
+                /*! \brief Cancel the job
+                 *
+                 * The job stops after the current round of samples, the hits recorded until then are kept.
+                 */
+                void cancel() {
+                    m_progress.cancel = true;
+                }
+
+                /*! \brief Wait until the job is finished
+                 *
+                 * This function waits at most the given number of seconds, a negative timeout waits without limit.
+                 * It returns true if the job is finished and rethrows an exception raised by the job.
+                 */
+                bool wait(const double timeout = -1.0) const {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    if(timeout < 0.0) {
+                        m_finished.wait(lock, [this] { return m_done; });
+                    }
+                    else if(!m_finished.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return m_done; })) {
+                        return false;
+                    }
+                    if(m_error) {
+                        std::rethrow_exception(m_error);
+                    }
+                    return true;
+                }
+
+                /*! \brief Check if the job is still running. */
+                bool is_running() const {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return !m_done;
+                }
+
+                /*! \brief Check if the job recorded all requested hits or met its convergence criterion. */
+                bool is_complete() const {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_complete;
+                }
+
+                /*! \brief Check if the job was cancelled. */
+                bool is_cancelled() const {
+                    return m_progress.cancel;
+                }
+
+                /*! \brief Get the number of hits requested, or the largest number of hits of a convergence criterion. */
+                uint32_t get_requested() const {
+                    return m_requested;
+                }
+
+                /*! \brief Get the number of hits recorded by the job so far. */
+                uint32_t get_hits() const {
+                    return m_progress.hits;
+                }
+
+                /*! \brief Get the number of samples traced by the job so far, including the ones that missed the mesh. */
+                uint64_t get_samples() const {
+                    return m_progress.samples;
+                }
+
+                /*! \brief Get the time in seconds since the job was started, or its duration if it is finished. */
+                double get_elapsed() const {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return std::chrono::duration<double>((m_done ? m_end : clock::now()) - m_start).count();
+                }
+
+                /*! \brief Get the number of hits recorded per second. */
+                double get_rate() const {
+                    double elapsed = get_elapsed();
+                    return elapsed > 0.0 ? get_hits()/elapsed : 0.0;
+                }
+
+                /*! \brief Get the number of samples traced per second. */
+                double get_sample_rate() const {
+                    double elapsed = get_elapsed();
+                    return elapsed > 0.0 ? get_samples()/elapsed : 0.0;
+                }
+
+                /*! \brief Get the radiation load the samples are added to. */
+                radiationLoad & get_load() const {
+                    return m_load;
+                }
+
+            protected:
+                typedef std::chrono::steady_clock clock; /*!< \brief Clock used to measure the rates. */
+
+                samplingJob(const samplingJob &); /*!< \brief Jobs are not copyable. */
+                samplingJob & operator=(const samplingJob &); /*!< \brief Jobs are not assignable. */
+
+                /*! \brief Add the samples with the given function, run by the thread of the job. */
+                void run(const std::function<bool(radiationLoad::progress &)> & work) {
+                    bool complete = false;
+                    std::exception_ptr error;
+                    try {
+                        complete = work(m_progress);
+                    }
+                    catch(...) {
+                        error = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_end = clock::now();
+                    m_done = true;
+                    m_complete = complete;
+                    m_error = error;
+                    m_finished.notify_all();
+                }
+
+                radiationLoad & m_load; /*!< \brief Radiation load the samples are added to. */
+                const uint32_t m_requested; /*!< \brief Number of hits requested. */
+                radiationLoad::progress m_progress; /*!< \brief Progress of add_samples(). */
+                const clock::time_point m_start; /*!< \brief Start of the job. */
+                clock::time_point m_end; /*!< \brief End of the job. */
+                bool m_done; /*!< \brief Whether the job is finished. */
+                bool m_complete; /*!< \brief Whether all requested hits were recorded. */
+                std::exception_ptr m_error; /*!< \brief Exception raised by the job. */
+                mutable std::mutex m_mutex; /*!< \brief Mutex guarding the state of the job. */
+                mutable std::condition_variable m_finished; /*!< \brief Signalled when the job is finished. */
+                std::thread m_thread; /*!< \brief Thread adding the samples. */
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef include_wallLoad_core_samplingRounds_hpp
+#define include_wallLoad_core_samplingRounds_hpp
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <wallLoad/core/instanceMutex.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Rounds of samples traced by several threads.
+         *
+         * radiationLoad, responseMatrix and axisymmetricLoad add their samples the same way.
+         * Every sample is identified by a running sample index and draws its random numbers from counter based streams
+         * keyed with the seed and this index.
+         * The samples are traced in rounds, each round is split into contiguous blocks of sample indices, one per thread.
+         * A round is traced with the instance locked for reading, so the results so far can be read meanwhile,
+         * and its results are added in the order of the sample indices with the instance locked for writing.
+         * The result therefore only depends on the seed and the number of samples added before, not on the number of threads.
+         * If the sample index or the generation counter of the instance changed in between, i.e. another call added a round
+         * or a setter changed the sampling, the round is traced again.
+         *
+         * The instance declares this class a friend and has the members m_mutex, m_threads, m_sample and m_generation,
+         * a type sampleList for the results of a block and a function sample(first, N, list), which traces the samples
+         * first, ..., first + N - 1 into the list, replacing its content, and only reads the instance.
+         */
+        class samplingRounds {
+            public:
+                /*! \brief Add samples to the given instance
+                 *
+                 * This function adds rounds until they have covered the given number of samples, or hits, see merge.
+                 * \param instance Instance the samples are added to.
+                 * \param remaining Number of samples, or hits, to add.
+                 * \param minBlock Smallest number of samples traced by every thread in a round.
+                 * \param cancel Flag which stops adding rounds once it is set, or a null pointer.
+                 * \param merge Function merge(lists, first, next, remaining) called with the instance locked for writing.
+                 * It adds the lists of a round, which traced the samples first, ..., next - 1,
+                 * and returns how many of the remaining samples, or hits, the round covers.
+                 * It can lower next if the round covers more than the remaining ones, the sample index of the instance is then set to next.
+                 * \return False if the cancel flag stopped adding before the remaining samples were covered.
+                 */
+                template<typename owner, typename merger>
+                static bool add(owner & instance, uint64_t remaining, const uint64_t minBlock, const std::atomic<bool> * cancel,
+                    const merger & merge) {
+                    std::vector<typename owner::sampleList> lists;
+                    while(remaining > 0) {
+                        if(cancel && *cancel) {
+                            return false;
+                        }
+                        uint64_t first;
+                        uint64_t generation;
+                        uint64_t next;
+                        {
+                            readLock lock(instance.m_mutex);
+                            first = instance.m_sample;
+                            generation = instance.m_generation;
+                            next = trace(instance, first, std::max(remaining, minBlock*instance.m_threads), lists);
+                        }
+                        writeLock lock(instance.m_mutex);
+                        if(instance.m_sample != first || instance.m_generation != generation) {
+                            continue;
+                        }
+                        remaining -= std::min(remaining, (uint64_t)merge(lists, first, next, remaining));
+                        instance.m_sample = next;
+                    }
+                    return true;
+                }
+
+                static constexpr uint64_t s_maxBlock = 65536; /*!< \brief Largest number of samples traced by a thread in one round. */
+                static constexpr uint64_t s_directionBatch = 256; /*!< \brief Number of directions a thread generates at once. */
+
+            protected:
+                /*! \brief Trace a round
+                 *
+                 * This function splits the N samples starting at first into one contiguous block of at most s_maxBlock samples
+                 * per thread of the instance, traces them into the lists and returns the index of the sample after the last one traced.
+                 */
+                template<typename owner>
+                static uint64_t trace(const owner & instance, const uint64_t first, const uint64_t N, std::vector<typename owner::sampleList> & lists) {
+                    uint32_t threads = instance.m_threads;
+                    lists.resize(threads);
+                    uint64_t block = std::min((N + threads - 1)/threads, s_maxBlock);
+                    std::vector<std::thread> workers;
+                    uint64_t start = first;
+                    for(uint32_t i = 0; i < threads; ++i) {
+                        uint64_t count = std::min(block, first + N - start);
+                        if(i + 1 < threads) {
+                            workers.push_back(std::thread(&owner::sample, &instance, start, count, std::ref(lists[i])));
+                        }
+                        else {
+                            instance.sample(start, count, lists[i]);
+                        }
+                        start += count;
+                    }
+                    for(auto iter = workers.begin(); iter != workers.end(); ++iter) {
+                        iter->join();
+                    }
+                    return start;
+                }
+        };
+    }
+}
+
+#endif
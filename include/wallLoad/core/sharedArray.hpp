@@ -0,0 +1,89 @@
+#ifndef include_wallLoad_core_sharedArray_hpp
+#define include_wallLoad_core_sharedArray_hpp
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <stdint.h>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Read only array with shared ownership.
+         *
+         * This class gives read access to an array which is either owned by the instance (moved in from a std::vector)
+         * or lives in memory owned by another object, e.g. a mappedFile.
+         * Copies share the data, so copying is cheap and the data of a memory mapped file is never copied.
+         */
+        template<class T>
+        class sharedArray {
+            public:
+                /*! \brief Default constructor
+                 *
+                 * This constructor initializes an empty array.
+                 */
+                sharedArray() : m_owner(), m_data(0), m_size(0) {}
+
+                /*! \brief Constructor
+                 *
+                 * This constructor takes over the content of the given vector.
+                 */
+                explicit sharedArray(std::vector<T> && data) :
+                    m_owner(), m_data(0), m_size(data.size()) {
+                    std::shared_ptr<std::vector<T> > owner = std::make_shared<std::vector<T> >(std::move(data));
+                    m_data = owner->data();
+                    m_owner = owner;
+                }
+
+                /*! \brief Constructor
+                 *
+                 * This constructor refers to N elements at data, which stay valid as long as owner exists.
+                 */
+                sharedArray(const std::shared_ptr<const void> & owner, const T * data, const uint64_t N) :
+                    m_owner(owner), m_data(data), m_size(N) {}
+
+                /*! \brief Get the ith element. */
+                const T & operator[](const uint64_t i) const {
+                    return m_data[i];
+                }
+
+                /*! \brief Get the first element. */
+                const T * data() const {
+                    return m_data;
+                }
+
+                /*! \brief Get the first element. */
+                const T * begin() const {
+                    return m_data;
+                }
+
+                /*! \brief Get the position behind the last element. */
+                const T * end() const {
+                    return m_data + m_size;
+                }
+
+                /*! \brief Get the number of elements. */
+                uint64_t size() const {
+                    return m_size;
+                }
+
+                /*! \brief Check if the array is empty. */
+                bool empty() const {
+                    return m_size == 0;
+                }
+
+                /*! \brief Release the data. */
+                void clear() {
+                    m_owner.reset();
+                    m_data = 0;
+                    m_size = 0;
+                }
+
+            protected:
+                std::shared_ptr<const void> m_owner; /*!< \brief Owner of the data. */
+                const T * m_data; /*!< \brief First element. */
+                uint64_t m_size; /*!< \brief Number of elements. */
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef include_wallLoad_core_sobolSequence_hpp
+#define include_wallLoad_core_sobolSequence_hpp
+
+#include <stdint.h>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Scrambled Sobol sequence for quasi-Monte Carlo sampling.
+         *
+         * This class calculates the points of the Sobol low-discrepancy sequence in s_dimensions dimensions,
+         * using the direction numbers of Joe and Kuo, "Constructing Sobol sequences with better two-dimensional projections" (2008).
+         * Every coordinate is randomized with a nested uniform (Owen) scramble, implemented with the hash of
+         * Burley, "Practical hash-based Owen scrambling" (2020).
+         * Differently scrambled copies of the sequence are independent randomized quasi-Monte Carlo replicas,
+         * each of them an unbiased estimate which keeps the low discrepancy of the sequence.
+         * The coordinates have 32 bits, so a replica has at most \f$2^{32}\f$ distinct points.
+         */
+        class sobolSequence {
+            public:
+                static const uint32_t s_dimensions = 5; /*!< \brief Number of dimensions. */
+
+                /*! \brief Default constructor
+                 *
+                 * This constructor calculates the direction numbers.
+                 */
+                sobolSequence() {
+                    static const uint32_t degree[s_dimensions] = {0, 1, 2, 3, 3};
+                    static const uint32_t polynomial[s_dimensions] = {0, 0, 1, 1, 2};
+                    static const uint32_t initial[s_dimensions][3] = {{0, 0, 0}, {1, 0, 0}, {1, 3, 0}, {1, 3, 1}, {1, 1, 1}};
+                    for(uint32_t k = 0; k < 32; ++k) {
+                        m_direction[0][k] = 1u << (31 - k);
+                    }
+                    for(uint32_t d = 1; d < s_dimensions; ++d) {
+                        uint32_t s = degree[d];
+                        for(uint32_t k = 0; k < 32; ++k) {
+                            if(k < s) {
+                                m_direction[d][k] = initial[d][k] << (31 - k);
+                                continue;
+                            }
+                            m_direction[d][k] = m_direction[d][k - s] ^ (m_direction[d][k - s] >> s);
+                            for(uint32_t j = 1; j < s; ++j) {
+                                if((polynomial[d] >> (s - 1 - j)) & 1) {
+                                    m_direction[d][k] ^= m_direction[d][k - j];
+                                }
+                            }
+                        }
+                    }
+                }
+
+                /*! \brief Get a coordinate of a point
+                 *
+                 * This function returns the coordinate in the given dimension of the point with the given index,
+                 * scrambled with the given seed. The result is in \f$]0,1[\f$, at the center of its 32 bit interval.
+                 */
+                double get(const uint64_t index, const uint32_t dimension, const uint32_t scramble) const {
+                    uint32_t x = 0;
+                    uint32_t i = (uint32_t)index;
+                    for(uint32_t k = 0; i != 0; ++k, i >>= 1) {
+                        if(i & 1) {
+                            x ^= m_direction[dimension][k];
+                        }
+                    }
+                    return ((double)owen_scramble(x, scramble) + 0.5)*s_2powm32;
+                }
+
+            protected:
+                /*! \brief Nested uniform scramble of the bits of x with the given seed
+                 *
+                 * Every bit is flipped depending on the bits above it, by hashing the reversed bits with a function
+                 * in which every bit only depends on the bits below it.
+                 */
+                static uint32_t owen_scramble(uint32_t x, const uint32_t seed) {
+                    x = reverse_bits(x);
+                    x ^= x*0x3d20adeau;
+                    x += seed;
+                    x *= (seed >> 16) | 1u;
+                    x ^= x*0x05526c56u;
+                    x ^= x*0x53a22864u;
+                    return reverse_bits(x);
+                }
+
+                /*! \brief Reverse the order of the bits of x. */
+                static uint32_t reverse_bits(uint32_t x) {
+                    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+                    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+                    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+                    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+                    return (x >> 16) | (x << 16);
+                }
+
+                static constexpr double s_2powm32 = 1.0/4294967296.0; /*!< \brief \f$2^{-32}\f$ */
+
+                uint32_t m_direction[s_dimensions][32]; /*!< \brief Direction numbers of every dimension. */
+        };
+    }
+}
+
+#endif
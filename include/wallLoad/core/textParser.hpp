@@ -0,0 +1,183 @@
+#ifndef include_wallLoad_core_textParser_hpp
+#define include_wallLoad_core_textParser_hpp
+
+#include <string>
+#include <stdexcept>
+#include <charconv>
+#include <stdint.h>
+#include <string.h>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Parser for numbers in text files.
+         *
+         * This class reads numbers from a range of characters, e.g. a mappedFile, with std::from_chars.
+         * Numbers may be separated by white space or follow each other directly as in the fixed width Fortran formats,
+         * e.g. "1.000000000E+00-2.500000000E+00". Fortran double precision exponents ("1.0D+00") are accepted.
+         * The current line is counted, so that errors can point to the position in the file.
+         * All errors are reported as std::runtime_error.
+         */
+        class textParser {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor initializes the parser for the characters [begin, end).
+                 * The name is used in error messages.
+                 */
+                textParser(const char * begin, const char * end, const std::string & name) :
+                    m_position(begin), m_end(end), m_name(name), m_line(1) {
+                }
+
+                /*! \brief Skip white space and count the lines. */
+                void skip_whitespace() {
+                    while(m_position != m_end && (*m_position == ' ' || *m_position == '\t' || *m_position == '\n' || *m_position == '\r')) {
+                        if(*m_position == '\n') {
+                            ++m_line;
+                        }
+                        ++m_position;
+                    }
+                }
+
+                /*! \brief Check if only white space is left. */
+                bool at_end() {
+                    skip_whitespace();
+                    return m_position == m_end;
+                }
+
+                /*! \brief Read a floating point number
+                 *
+                 * This function reads the next floating point number. The description is used in the error message.
+                 */
+                double read_double(const char * description) {
+                    skip_whitespace();
+                    const char * first = m_position;
+                    if(first != m_end && *first == '+') {
+                        ++first;
+                    }
+                    double value;
+                    std::from_chars_result result = std::from_chars(first, m_end, value);
+                    if(result.ec != std::errc()) {
+                        fail(std::string("expected a number for ") + description);
+                    }
+                    m_position = result.ptr;
+                    if(m_position != m_end && (*m_position == 'D' || *m_position == 'd')) {
+                        int32_t exponent;
+                        const char * start = m_position + 1;
+                        if(start != m_end && *start == '+') {
+                            ++start;
+                        }
+                        result = std::from_chars(start, m_end, exponent);
+                        if(result.ec != std::errc()) {
+                            fail(std::string("invalid exponent in ") + description);
+                        }
+                        std::string buffer(first, m_position);
+                        buffer += 'E' + std::to_string(exponent);
+                        std::from_chars(buffer.data(), buffer.data() + buffer.size(), value);
+                        m_position = result.ptr;
+                    }
+                    return value;
+                }
+
+                /*! \brief Read N floating point numbers into output. */
+                void read_doubles(double * output, const uint64_t N, const char * description) {
+                    for(uint64_t i = 0; i < N; ++i) {
+                        output[i] = read_double(description);
+                    }
+                }
+
+                /*! \brief Read an integer
+                 *
+                 * This function reads the next integer. The description is used in the error message.
+                 */
+                int64_t read_integer(const char * description) {
+                    skip_whitespace();
+                    const char * first = m_position;
+                    if(first != m_end && *first == '+') {
+                        ++first;
+                    }
+                    int64_t value;
+                    std::from_chars_result result = std::from_chars(first, m_end, value);
+                    if(result.ec != std::errc()) {
+                        fail(std::string("expected an integer for ") + description);
+                    }
+                    m_position = result.ptr;
+                    return value;
+                }
+
+                /*! \brief Read the rest of the current line
+                 *
+                 * This function returns the characters up to the next line break and moves behind it.
+                 * A carriage return before the line break is removed.
+                 */
+                std::string read_line() {
+                    const char * first = m_position;
+                    while(m_position != m_end && *m_position != '\n') {
+                        ++m_position;
+                    }
+                    const char * last = m_position;
+                    if(m_position != m_end) {
+                        ++m_position;
+                        ++m_line;
+                    }
+                    if(last != first && *(last - 1) == '\r') {
+                        --last;
+                    }
+                    return std::string(first, last);
+                }
+
+                /*! \brief Move behind the next line break without copying the rest of the line. */
+                void skip_line() {
+                    const char * next = static_cast<const char *>(memchr(m_position, '\n', m_end - m_position));
+                    if(next) {
+                        m_position = next + 1;
+                        ++m_line;
+                    }
+                    else {
+                        m_position = m_end;
+                    }
+                }
+
+                /*! \brief Get the current position. */
+                const char * get_position() const {
+                    return m_position;
+                }
+
+                /*! \brief Get the end of the characters. */
+                const char * get_end() const {
+                    return m_end;
+                }
+
+                /*! \brief Set the current position
+                 *
+                 * The position must lie in the range of the parser and the given line number must belong to it.
+                 */
+                void set_position(const char * position, const uint64_t line) {
+                    m_position = position;
+                    m_line = line;
+                }
+
+                /*! \brief Get the name of the input. */
+                std::string get_name() const {
+                    return m_name;
+                }
+
+                /*! \brief Get the current line number, starting at 1. */
+                uint64_t get_line() const {
+                    return m_line;
+                }
+
+                /*! \brief Throw a std::runtime_error with the name and the current line. */
+                void fail(const std::string & message) const {
+                    throw std::runtime_error(m_name + ":" + std::to_string(m_line) + ": " + message);
+                }
+
+            protected:
+                const char * m_position; /*!< \brief Next character to read. */
+                const char * m_end; /*!< \brief End of the characters. */
+                std::string m_name; /*!< \brief Name of the input used in error messages. */
+                uint64_t m_line; /*!< \brief Current line number. */
+        };
+    }
+}
+
+#endif
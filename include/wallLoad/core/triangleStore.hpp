@@ -0,0 +1,367 @@
+#ifndef include_wallLoad_core_triangleStore_hpp
+#define include_wallLoad_core_triangleStore_hpp
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <wallLoad/core/vektor.hpp>
+#include <wallLoad/core/vertex.hpp>
+#include <wallLoad/core/sharedArray.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(WALLLOAD_NO_SIMD)
+#define WALLLOAD_SIMD
+#include <immintrin.h>
+#endif
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Structure of arrays storage of the vertices of a mesh for the intersection tests.
+         *
+         * This class stores the first point and the two edges \f$\mathbf{e}_1 = \mathbf{p}_2 - \mathbf{p}_1\f$,
+         * \f$\mathbf{e}_2 = \mathbf{p}_3 - \mathbf{p}_1\f$ of each vertex in separate contiguous arrays.
+         * A range of vertices is tested with the Moeller-Trumbore algorithm several vertices at a time.
+         * The instruction set (AVX-512, AVX2 or scalar) is chosen at runtime from what the processor supports.
+         * All instruction sets give the same result as vertex::intersect_before().
+         */
+        class triangleStore {
+            public:
+                /*! \brief Signature of the intersection kernels. */
+                typedef void (*kernel)(const triangleStore & store, const uint32_t first, const uint32_t last,
+                    const vektor & origin, const vektor & direction, double & tClosest, int32_t & closest);
+
+                /*! \brief Default constructor
+                 *
+                 * This constructor initializes an empty store and selects the intersection kernel.
+                 */
+                triangleStore() :
+                    m_p1x(), m_p1y(), m_p1z(), m_e1x(), m_e1y(), m_e1z(), m_e2x(), m_e2y(), m_e2z(),
+                    m_element(), m_kernel(&intersect_scalar), m_instructionSet("scalar") {
+                    select_kernel();
+                }
+
+                /*! \brief Store vertices
+                 *
+                 * This function stores the given triangles, which are three indices per triangle into the node coordinates
+                 * (three per node), in the given order. The ith entry of the store is the triangle order[i].
+                 * The arrays are padded with degenerate vertices so that the kernels can always load full registers.
+                 */
+                void build(const std::vector<double> & nodes, const std::vector<uint32_t> & triangles, const sharedArray<uint32_t> & order) {
+                    uint32_t N = order.size();
+                    std::vector<double> coordinates[9];
+                    for(uint32_t k = 0; k < 9; ++k) {
+                        coordinates[k].resize(N + s_padding, 0.0);
+                    }
+                    std::vector<int32_t> element(N);
+                    for(uint32_t i = 0; i < N; ++i) {
+                        const double * p1 = &nodes[3*triangles[3*order[i]]];
+                        const double * p2 = &nodes[3*triangles[3*order[i] + 1]];
+                        const double * p3 = &nodes[3*triangles[3*order[i] + 2]];
+                        for(uint32_t k = 0; k < 3; ++k) {
+                            coordinates[k][i] = p1[k];
+                            coordinates[3 + k][i] = p2[k] - p1[k];
+                            coordinates[6 + k][i] = p3[k] - p1[k];
+                        }
+                        element[i] = order[i];
+                    }
+                    sharedArray<double> arrays[9];
+                    for(uint32_t k = 0; k < 9; ++k) {
+                        arrays[k] = sharedArray<double>(std::move(coordinates[k]));
+                    }
+                    assign(arrays, sharedArray<int32_t>(std::move(element)));
+                }
+
+                /*! \brief Use existing arrays
+                 *
+                 * This function uses the given arrays, e.g. from a mesh cache, without copying them.
+                 * The coordinates are in the order of get_coordinates() and need s_padding entries more than element.
+                 */
+                void assign(const sharedArray<double> * coordinates, const sharedArray<int32_t> & element) {
+                    m_p1x = coordinates[0];
+                    m_p1y = coordinates[1];
+                    m_p1z = coordinates[2];
+                    m_e1x = coordinates[3];
+                    m_e1y = coordinates[4];
+                    m_e1z = coordinates[5];
+                    m_e2x = coordinates[6];
+                    m_e2y = coordinates[7];
+                    m_e2z = coordinates[8];
+                    m_element = element;
+                }
+
+                /*! \brief Get the kth coordinate array
+                 *
+                 * The arrays are in the order \f$p_{1,x}, p_{1,y}, p_{1,z}, e_{1,x}, \ldots, e_{2,z}\f$ and include the padding.
+                 */
+                const sharedArray<double> & get_coordinates(const uint32_t k) const {
+                    const sharedArray<double> * arrays[9] = {&m_p1x, &m_p1y, &m_p1z, &m_e1x, &m_e1y, &m_e1z, &m_e2x, &m_e2y, &m_e2z};
+                    return *arrays[k];
+                }
+
+                /*! \brief Get the element index of each entry. */
+                const sharedArray<int32_t> & get_elements() const {
+                    return m_element;
+                }
+
+                /*! \brief Get the number of degenerate vertices appended to the arrays. */
+                static uint32_t get_padding() {
+                    return s_padding;
+                }
+
+                /*! \brief Remove all vertices from the store. */
+                void clear() {
+                    m_p1x.clear();
+                    m_p1y.clear();
+                    m_p1z.clear();
+                    m_e1x.clear();
+                    m_e1y.clear();
+                    m_e1z.clear();
+                    m_e2x.clear();
+                    m_e2y.clear();
+                    m_e2z.clear();
+                    m_element.clear();
+                }
+
+                /*! \brief Number of vertices in the store. */
+                uint32_t size() const {
+                    return m_element.size();
+                }
+
+                /*! \brief Check if the store is empty. */
+                bool empty() const {
+                    return m_element.empty();
+                }
+
+                /*! \brief Get the instruction set used for the intersection tests. */
+                std::string get_instruction_set() const {
+                    return m_instructionSet;
+                }
+
+                /*! \brief Intersect a ray with a range of the store
+                 *
+                 * This function tests the entries [first, last[ of the store for an intersection with the ray,
+                 * which is not further away than tClosest.
+                 * If a vertex is hit closer than tClosest, or at tClosest with an element index lower than closest,
+                 * tClosest and closest are updated.
+                 * \param first First entry to test.
+                 * \param last Entry after the last entry to test.
+                 * \param origin Position from where the ray originates.
+                 * \param direction The direction in which the ray travels.
+                 * \param tClosest Ray parameter of the closest hit found so far.
+                 * \param closest Element index of the closest hit found so far, -1 if nothing was hit.
+                 */
+                inline void intersect(const uint32_t first, const uint32_t last, const vektor & origin, const vektor & direction,
+                    double & tClosest, int32_t & closest) const {
+                    m_kernel(*this, first, last, origin, direction, tClosest, closest);
+                }
+
+            protected:
+                /*! \brief Accept a hit
+                 *
+                 * This function updates the closest hit if the given hit is closer,
+                 * or as close and with a lower element index.
+                 */
+                static inline void accept(const double t, const int32_t element, double & tClosest, int32_t & closest) {
+                    if(t < tClosest || (t == tClosest && element < closest)) {
+                        tClosest = t;
+                        closest = element;
+                    }
+                }
+
+                /*! \brief Scalar intersection kernel
+                 *
+                 * This kernel tests one vertex at a time.
+                 * The operations are done in the same order as in vertex::intersect_before().
+                 */
+                static void intersect_scalar(const triangleStore & store, const uint32_t first, const uint32_t last,
+                    const vektor & origin, const vektor & direction, double & tClosest, int32_t & closest) {
+                    for(uint32_t i = first; i < last; ++i) {
+                        double Px = direction.y*store.m_e2z[i] - direction.z*store.m_e2y[i];
+                        double Py = direction.z*store.m_e2x[i] - direction.x*store.m_e2z[i];
+                        double Pz = direction.x*store.m_e2y[i] - direction.y*store.m_e2x[i];
+                        double det = store.m_e1x[i]*Px + store.m_e1y[i]*Py + store.m_e1z[i]*Pz;
+                        if( det > -EPSILON && det < EPSILON) {
+                            continue;
+                        }
+                        double inv_det = 1.0/det;
+                        double Tx = origin.x - store.m_p1x[i];
+                        double Ty = origin.y - store.m_p1y[i];
+                        double Tz = origin.z - store.m_p1z[i];
+                        double u = (Tx*Px + Ty*Py + Tz*Pz) * inv_det;
+                        if(u < 0.0 || u > 1.0) {
+                            continue;
+                        }
+                        double Qx = Ty*store.m_e1z[i] - Tz*store.m_e1y[i];
+                        double Qy = Tz*store.m_e1x[i] - Tx*store.m_e1z[i];
+                        double Qz = Tx*store.m_e1y[i] - Ty*store.m_e1x[i];
+                        double t = (store.m_e2x[i]*Qx + store.m_e2y[i]*Qy + store.m_e2z[i]*Qz) * inv_det;
+                        if(t <= EPSILON || t > tClosest) {
+                            continue;
+                        }
+                        double v = (direction.x*Qx + direction.y*Qy + direction.z*Qz)*inv_det;
+                        if(v < 0.0 || u + v  > 1.0) {
+                            continue;
+                        }
+                        accept(t, store.m_element[i], tClosest, closest);
+                    }
+                }
+
+#ifdef WALLLOAD_SIMD
+                /*! \brief AVX2 intersection kernel
+                 *
+                 * This kernel tests four vertices at a time.
+                 * Fused multiply-add is not used, so the results are identical to the scalar kernel.
+                 */
+                __attribute__((target("avx2"), optimize("fp-contract=off")))
+                static void intersect_avx2(const triangleStore & store, const uint32_t first, const uint32_t last,
+                    const vektor & origin, const vektor & direction, double & tClosest, int32_t & closest) {
+                    const __m256d dx = _mm256_set1_pd(direction.x);
+                    const __m256d dy = _mm256_set1_pd(direction.y);
+                    const __m256d dz = _mm256_set1_pd(direction.z);
+                    const __m256d ox = _mm256_set1_pd(origin.x);
+                    const __m256d oy = _mm256_set1_pd(origin.y);
+                    const __m256d oz = _mm256_set1_pd(origin.z);
+                    const __m256d epsilon = _mm256_set1_pd(EPSILON);
+                    const __m256d minusEpsilon = _mm256_set1_pd(-EPSILON);
+                    const __m256d zero = _mm256_setzero_pd();
+                    const __m256d one = _mm256_set1_pd(1.0);
+                    double t[4];
+                    for(uint32_t i = first; i < last; i += 4) {
+                        __m256d e1x = _mm256_loadu_pd(&store.m_e1x[i]);
+                        __m256d e1y = _mm256_loadu_pd(&store.m_e1y[i]);
+                        __m256d e1z = _mm256_loadu_pd(&store.m_e1z[i]);
+                        __m256d e2x = _mm256_loadu_pd(&store.m_e2x[i]);
+                        __m256d e2y = _mm256_loadu_pd(&store.m_e2y[i]);
+                        __m256d e2z = _mm256_loadu_pd(&store.m_e2z[i]);
+                        __m256d Px = _mm256_sub_pd(_mm256_mul_pd(dy, e2z), _mm256_mul_pd(dz, e2y));
+                        __m256d Py = _mm256_sub_pd(_mm256_mul_pd(dz, e2x), _mm256_mul_pd(dx, e2z));
+                        __m256d Pz = _mm256_sub_pd(_mm256_mul_pd(dx, e2y), _mm256_mul_pd(dy, e2x));
+                        __m256d det = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(e1x, Px), _mm256_mul_pd(e1y, Py)), _mm256_mul_pd(e1z, Pz));
+                        __m256d reject = _mm256_and_pd(_mm256_cmp_pd(det, minusEpsilon, _CMP_GT_OQ), _mm256_cmp_pd(det, epsilon, _CMP_LT_OQ));
+                        __m256d inv_det = _mm256_div_pd(one, det);
+                        __m256d Tx = _mm256_sub_pd(ox, _mm256_loadu_pd(&store.m_p1x[i]));
+                        __m256d Ty = _mm256_sub_pd(oy, _mm256_loadu_pd(&store.m_p1y[i]));
+                        __m256d Tz = _mm256_sub_pd(oz, _mm256_loadu_pd(&store.m_p1z[i]));
+                        __m256d u = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(Tx, Px), _mm256_mul_pd(Ty, Py)), _mm256_mul_pd(Tz, Pz)), inv_det);
+                        reject = _mm256_or_pd(reject, _mm256_or_pd(_mm256_cmp_pd(u, zero, _CMP_LT_OQ), _mm256_cmp_pd(u, one, _CMP_GT_OQ)));
+                        __m256d Qx = _mm256_sub_pd(_mm256_mul_pd(Ty, e1z), _mm256_mul_pd(Tz, e1y));
+                        __m256d Qy = _mm256_sub_pd(_mm256_mul_pd(Tz, e1x), _mm256_mul_pd(Tx, e1z));
+                        __m256d Qz = _mm256_sub_pd(_mm256_mul_pd(Tx, e1y), _mm256_mul_pd(Ty, e1x));
+                        __m256d tHit = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(e2x, Qx), _mm256_mul_pd(e2y, Qy)), _mm256_mul_pd(e2z, Qz)), inv_det);
+                        reject = _mm256_or_pd(reject, _mm256_or_pd(_mm256_cmp_pd(tHit, epsilon, _CMP_LE_OQ), _mm256_cmp_pd(tHit, _mm256_set1_pd(tClosest), _CMP_GT_OQ)));
+                        __m256d v = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, Qx), _mm256_mul_pd(dy, Qy)), _mm256_mul_pd(dz, Qz)), inv_det);
+                        reject = _mm256_or_pd(reject, _mm256_or_pd(_mm256_cmp_pd(v, zero, _CMP_LT_OQ), _mm256_cmp_pd(_mm256_add_pd(u, v), one, _CMP_GT_OQ)));
+                        uint32_t hits = ~_mm256_movemask_pd(reject) & 0xF;
+                        if(last - i < 4) {
+                            hits &= (1u << (last - i)) - 1;
+                        }
+                        if(hits) {
+                            _mm256_storeu_pd(t, tHit);
+                            for(uint32_t k = 0; k < 4; ++k) {
+                                if(hits & (1u << k)) {
+                                    accept(t[k], store.m_element[i + k], tClosest, closest);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                /*! \brief AVX-512 intersection kernel
+                 *
+                 * This kernel tests eight vertices at a time.
+                 * Fused multiply-add is not used, so the results are identical to the scalar kernel.
+                 */
+                __attribute__((target("avx512f"), optimize("fp-contract=off")))
+                static void intersect_avx512(const triangleStore & store, const uint32_t first, const uint32_t last,
+                    const vektor & origin, const vektor & direction, double & tClosest, int32_t & closest) {
+                    const __m512d dx = _mm512_set1_pd(direction.x);
+                    const __m512d dy = _mm512_set1_pd(direction.y);
+                    const __m512d dz = _mm512_set1_pd(direction.z);
+                    const __m512d ox = _mm512_set1_pd(origin.x);
+                    const __m512d oy = _mm512_set1_pd(origin.y);
+                    const __m512d oz = _mm512_set1_pd(origin.z);
+                    const __m512d epsilon = _mm512_set1_pd(EPSILON);
+                    const __m512d minusEpsilon = _mm512_set1_pd(-EPSILON);
+                    const __m512d zero = _mm512_setzero_pd();
+                    const __m512d one = _mm512_set1_pd(1.0);
+                    double t[8];
+                    for(uint32_t i = first; i < last; i += 8) {
+                        __m512d e1x = _mm512_loadu_pd(&store.m_e1x[i]);
+                        __m512d e1y = _mm512_loadu_pd(&store.m_e1y[i]);
+                        __m512d e1z = _mm512_loadu_pd(&store.m_e1z[i]);
+                        __m512d e2x = _mm512_loadu_pd(&store.m_e2x[i]);
+                        __m512d e2y = _mm512_loadu_pd(&store.m_e2y[i]);
+                        __m512d e2z = _mm512_loadu_pd(&store.m_e2z[i]);
+                        __m512d Px = _mm512_sub_pd(_mm512_mul_pd(dy, e2z), _mm512_mul_pd(dz, e2y));
+                        __m512d Py = _mm512_sub_pd(_mm512_mul_pd(dz, e2x), _mm512_mul_pd(dx, e2z));
+                        __m512d Pz = _mm512_sub_pd(_mm512_mul_pd(dx, e2y), _mm512_mul_pd(dy, e2x));
+                        __m512d det = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(e1x, Px), _mm512_mul_pd(e1y, Py)), _mm512_mul_pd(e1z, Pz));
+                        __mmask8 reject = _mm512_cmp_pd_mask(det, minusEpsilon, _CMP_GT_OQ) & _mm512_cmp_pd_mask(det, epsilon, _CMP_LT_OQ);
+                        __m512d inv_det = _mm512_div_pd(one, det);
+                        __m512d Tx = _mm512_sub_pd(ox, _mm512_loadu_pd(&store.m_p1x[i]));
+                        __m512d Ty = _mm512_sub_pd(oy, _mm512_loadu_pd(&store.m_p1y[i]));
+                        __m512d Tz = _mm512_sub_pd(oz, _mm512_loadu_pd(&store.m_p1z[i]));
+                        __m512d u = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(Tx, Px), _mm512_mul_pd(Ty, Py)), _mm512_mul_pd(Tz, Pz)), inv_det);
+                        reject |= _mm512_cmp_pd_mask(u, zero, _CMP_LT_OQ) | _mm512_cmp_pd_mask(u, one, _CMP_GT_OQ);
+                        __m512d Qx = _mm512_sub_pd(_mm512_mul_pd(Ty, e1z), _mm512_mul_pd(Tz, e1y));
+                        __m512d Qy = _mm512_sub_pd(_mm512_mul_pd(Tz, e1x), _mm512_mul_pd(Tx, e1z));
+                        __m512d Qz = _mm512_sub_pd(_mm512_mul_pd(Tx, e1y), _mm512_mul_pd(Ty, e1x));
+                        __m512d tHit = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(e2x, Qx), _mm512_mul_pd(e2y, Qy)), _mm512_mul_pd(e2z, Qz)), inv_det);
+                        reject |= _mm512_cmp_pd_mask(tHit, epsilon, _CMP_LE_OQ) | _mm512_cmp_pd_mask(tHit, _mm512_set1_pd(tClosest), _CMP_GT_OQ);
+                        __m512d v = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, Qx), _mm512_mul_pd(dy, Qy)), _mm512_mul_pd(dz, Qz)), inv_det);
+                        reject |= _mm512_cmp_pd_mask(v, zero, _CMP_LT_OQ) | _mm512_cmp_pd_mask(_mm512_add_pd(u, v), one, _CMP_GT_OQ);
+                        uint32_t hits = ~(uint32_t)reject & 0xFF;
+                        if(last - i < 8) {
+                            hits &= (1u << (last - i)) - 1;
+                        }
+                        if(hits) {
+                            _mm512_storeu_pd(t, tHit);
+                            for(uint32_t k = 0; k < 8; ++k) {
+                                if(hits & (1u << k)) {
+                                    accept(t[k], store.m_element[i + k], tClosest, closest);
+                                }
+                            }
+                        }
+                    }
+                }
+#endif
+
+                /*! \brief Select the intersection kernel
+                 *
+                 * This function selects the widest instruction set supported by the processor.
+                 */
+                void select_kernel() {
+#ifdef WALLLOAD_SIMD
+                    if(__builtin_cpu_supports("avx512f")) {
+                        m_kernel = &intersect_avx512;
+                        m_instructionSet = "avx512";
+                        return;
+                    }
+                    if(__builtin_cpu_supports("avx2")) {
+                        m_kernel = &intersect_avx2;
+                        m_instructionSet = "avx2";
+                        return;
+                    }
+#endif
+                    m_kernel = &intersect_scalar;
+                    m_instructionSet = "scalar";
+                }
+
+                static const uint32_t s_padding = 8; /*!< \brief Number of degenerate vertices appended to the arrays. */
+
+                sharedArray<double> m_p1x; /*!< \brief x component of the first points. */
+                sharedArray<double> m_p1y; /*!< \brief y component of the first points. */
+                sharedArray<double> m_p1z; /*!< \brief z component of the first points. */
+                sharedArray<double> m_e1x; /*!< \brief x component of the first edges. */
+                sharedArray<double> m_e1y; /*!< \brief y component of the first edges. */
+                sharedArray<double> m_e1z; /*!< \brief z component of the first edges. */
+                sharedArray<double> m_e2x; /*!< \brief x component of the second edges. */
+                sharedArray<double> m_e2y; /*!< \brief y component of the second edges. */
+                sharedArray<double> m_e2z; /*!< \brief z component of the second edges. */
+                sharedArray<int32_t> m_element; /*!< \brief Element index of each entry in the mesh. */
+                kernel m_kernel; /*!< \brief Selected intersection kernel. */
+                std::string m_instructionSet; /*!< \brief Name of the selected instruction set. */
+        };
+    }
+}
+
+#endif
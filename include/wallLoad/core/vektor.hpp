@@ -1,10 +1,10 @@
 #ifndef include_wallLoad_core_vektor_hpp
 #define include_wallLoad_core_vektor_hpp
 
-#include <boost/python.hpp>
 #include <math.h>
 #include <iostream>
 #include <vector>
+#include <type_traits>
 
 namespace wallLoad {
     namespace core {
@@ -12,6 +12,9 @@ namespace wallLoad {
          *
          * This class represents a vector \f$(x,y,z)\f$.
          * The basic functions for vector calculus are implemented.
+         * The class is a trivially copyable standard layout type of three doubles without virtual functions,
+         * so arrays of it can be copied with memcpy and the arithmetic can be evaluated at compile time.
+         * The conversion from and to python objects is found in wallLoad/python.hpp.
          */
         class vektor
         {
@@ -20,36 +23,12 @@ namespace wallLoad {
                  *
                  * This constructor initializes the vector with zero.
                  */
-                vektor() : x(0.0), y(0.0), z(0.0) {}
+                constexpr vektor() : x(0.0), y(0.0), z(0.0) {}
                 /*! \brief Constructor
                  *
                  * This constructor initialized the vector with \f$(x,y,z)\f$.
                  */
-                vektor(const double yIn, const double xIn, const double zIn) : x(xIn), y(yIn), z(zIn) {}
-                /*! \brief Copy constructor */
-                vektor(const vektor & rhs) : x(rhs.x), y(rhs.y), z(rhs.z) {}
-                /*! \brief Python constructor from list
-                 *
-                 * This constructor initializes the vector from a python list.
-                 * This constructor is only intended to interface with python.
-                 * Do not use this constructor from within C++.
-                 */
-                vektor(const boost::python::list & list) {
-                    x = boost::python::extract<double>(list[0]);
-                    y = boost::python::extract<double>(list[1]);
-                    z = boost::python::extract<double>(list[2]);
-                }
-                /*! \brief Python constructor from dictionary
-                 *
-                 * This constructor initializes the vector from a python dictionary.
-                 * This constructor is only intended to interface with python.
-                 * Do not use this constructor from within C++.
-                 */
-                vektor(const boost::python::dict & dict) {
-                    x = boost::python::extract<double>(dict.get("x"));
-                    y = boost::python::extract<double>(dict.get("y"));
-                    z = boost::python::extract<double>(dict.get("z"));
-                }
+                constexpr vektor(const double xIn, const double yIn, const double zIn) : x(xIn), y(yIn), z(zIn) {}
                 /*! \brief Constructor
                  *
                  * This constructor initializes the vector from a std::vector instance.
@@ -61,27 +40,11 @@ namespace wallLoad {
                  * This constructor initializes the vector as the difference of the given vectors.
                  * \f$\mathbf{v_0} - \mathbf{v_1}\f$.
                  */
-                vektor(const vektor & left, const vektor & right) :
+                constexpr vektor(const vektor & left, const vektor & right) :
                     x(left.x - right.x), 
                     y(left.y - right.y),
                     z(left.z - right.z) {
                 }
-                /*! \brief Destructor */
-                virtual ~vektor() {}
-
-                /*! \brief Assignment operator
-                 *
-                 * This operator copies the given vector to the current instance.
-                 */
-                vektor & operator= (const vektor & rhs) {
-                    if(this != &rhs) {
-                        x = rhs.x;
-                        y = rhs.y;
-                        z = rhs.z;
-                    }
-                    return *this;
-                }
-
                 /*! \brief Calculate the length of the vector.
                  *
                  * This function returns the length of the vektor.
@@ -96,7 +59,7 @@ namespace wallLoad {
                  * This function calculates the dot product of the current vector with the given vector.
                  * \f$ \mathbf{v}_0 \cdot \mathbf{v}_1 = x_0 x_1 + y_0 y_1 + z_0 z_1\f$
                  */
-                inline double get_dot_product(const vektor & rhs) const {
+                constexpr double get_dot_product(const vektor & rhs) const {
                     return x*rhs.x + y*rhs.y + z*rhs.z;
                 }
 
@@ -105,7 +68,7 @@ namespace wallLoad {
                  * This function calculates the dot product of the current vector with the given vector.
                  * \f$ \mathbf{v}_0 \times \mathbf{v}_1 = (y_0 z_1 - z_0 y_1, z_0 x_1 - x_0 z_1, x_0 y_1 - x_1 y_0)\f$
                  */
-                inline vektor get_cross_product(const vektor & rhs) const {
+                constexpr vektor get_cross_product(const vektor & rhs) const {
                     return vektor(y*rhs.z-z*rhs.y, z*rhs.x-x*rhs.z, x*rhs.y-y*rhs.x);
                 }
 
@@ -113,7 +76,7 @@ namespace wallLoad {
                  *
                  * This operator adds the given vector to the given instance.
                  */
-                inline vektor & operator+=(const vektor & rhs) {
+                constexpr vektor & operator+=(const vektor & rhs) {
                     x += rhs.x;
                     y += rhs.y;
                     z += rhs.z;
@@ -124,7 +87,7 @@ namespace wallLoad {
                  *
                  * This operator subtracts the given vector from the given instance.
                  */
-                inline vektor & operator-=(const vektor & rhs) {
+                constexpr vektor & operator-=(const vektor & rhs) {
                     x -= rhs.x;
                     y -= rhs.y;
                     z -= rhs.z;
@@ -135,7 +98,7 @@ namespace wallLoad {
                  *
                  * This operator multiplies the current vector with the given scalar.
                  */
-                inline vektor & operator*= (const double rhs) {
+                constexpr vektor & operator*= (const double rhs) {
                     x *= rhs;
                     y *= rhs;
                     z *= rhs;
@@ -146,7 +109,7 @@ namespace wallLoad {
                  *
                  * This operator divides the current vector by the given scalar.
                  */
-                inline vektor & operator/= (const double rhs) {
+                constexpr vektor & operator/= (const double rhs) {
                     x /= rhs;
                     y /= rhs;
                     z /= rhs;
@@ -188,7 +151,7 @@ namespace wallLoad {
                  * This function returns the negation of the current vector
                  * \f$(-x,-y,-z)\f$
                  */
-                inline vektor operator -() const {
+                constexpr vektor operator -() const {
                     return vektor(-x, -y, -z);
                 }
 
@@ -201,34 +164,6 @@ namespace wallLoad {
                     return acos(get_dot_product(rhs)/get_length()/rhs.get_length());
                 }
 
-                /*! \brief Return vector as python list.
-                 *
-                 * This function returns the current vector as a python list.
-                 * This function is intended as a python interface.
-                 * Do not use this function from within C++.
-                 */
-                boost::python::list to_list() const {
-                    boost::python::list output;
-                    output.append(x);
-                    output.append(y);
-                    output.append(z);
-                    return output;
-                }
-
-                /*! \brief Return vector as python dictionary.
-                 *
-                 * This function returns the current vector as a python dictionary.
-                 * This function is intended as a python interface.
-                 * Do not use this function from within C++.
-                 */
-                boost::python::dict to_dict() const {
-                    boost::python::dict dict;
-                    dict.setdefault("x", x);
-                    dict.setdefault("y", y);
-                    dict.setdefault("z", z);
-                    return dict;
-                }
-
                 /*! \brief Get vector rotated around the \f$x\f$-axis by the angle \f$\alpha\f$.
                  *
                  * This function returns the vector rotated around the \f$x\f$-axis by the angle \f$\alpha\f$.
@@ -277,39 +212,42 @@ namespace wallLoad {
                 double z; /*!< \brief z component of the vector */
         };
 
-        std::ostream & operator<< (std::ostream & ostr, const vektor & vek) {
+        inline std::ostream & operator<< (std::ostream & ostr, const vektor & vek) {
             ostr << vek.x << '\t' << vek.y << '\t' << vek.z;
             return ostr;
         }
 
-        inline vektor operator+ (const vektor & lhs, const vektor & rhs) {
+        constexpr vektor operator+ (const vektor & lhs, const vektor & rhs) {
             return vektor(lhs.x+rhs.x, lhs.y+rhs.y, lhs.z+rhs.z);
         }
 
-        inline vektor operator- (const vektor & lhs, const vektor & rhs) {
+        constexpr vektor operator- (const vektor & lhs, const vektor & rhs) {
             return vektor(lhs.x-rhs.x, lhs.y-rhs.y, lhs.z-rhs.z);
         }
 
-        inline vektor operator* (const vektor & lhs, const double value) {
+        constexpr vektor operator* (const vektor & lhs, const double value) {
             return vektor(lhs.x*value, lhs.y*value, lhs.z*value);
         }
 
-        inline vektor operator* (const double value, const vektor & rhs) {
+        constexpr vektor operator* (const double value, const vektor & rhs) {
             return vektor(rhs.x*value, rhs.y*value, rhs.z*value);
         }
 
-        inline vektor operator/ (const vektor & lhs, const double value) {
+        constexpr vektor operator/ (const vektor & lhs, const double value) {
             return vektor(lhs.x/value, lhs.y/value, lhs.z/value);
         }
 
-        inline bool operator== (const vektor & lhs, const vektor & rhs) {
+        constexpr bool operator== (const vektor & lhs, const vektor & rhs) {
             return lhs.x==rhs.x && lhs.y==rhs.y && lhs.z==rhs.z;
         }
 
-        inline bool operator!= (const vektor & lhs, const vektor & rhs) {
+        constexpr bool operator!= (const vektor & lhs, const vektor & rhs) {
             return !(lhs == rhs);
         }
 
+        static_assert(std::is_trivially_copyable<vektor>::value && std::is_standard_layout<vektor>::value && sizeof(vektor) == 3*sizeof(double),
+                "vektor needs to be a plain array of three doubles");
+
     }
 }
 
@@ -3,17 +3,18 @@
 
 #define EPSILON 0.000001
 
-#include <boost/python.hpp>
 #include <iostream>
 #include <wallLoad/core/vektor.hpp>
 #include "hitResult.hpp"
 #include <cmath>
+#include <type_traits>
 namespace wallLoad {
     namespace core {
         /*! \brief Class representing a vertex with three points
          *
          * This class represents a vertex with three points in 3D.
          * The vertex can be checked for the intersection of a vector origination from a arbitrary point in space.
+         * Like vektor it is a trivially copyable standard layout type, so arrays of vertices can be copied with memcpy.
          */
         class vertex
         {
@@ -22,54 +23,15 @@ namespace wallLoad {
              *
              * This constructor initializes the vertex with the given points.
              */
-            vertex(const vektor & P1, const vektor & P2, const vektor & P3) :
+            constexpr vertex(const vektor & P1, const vektor & P2, const vektor & P3) :
                 p1(P1), p2(P2), p3(P3) {
             }
-            /*! \brief Copy constructor*/
-            vertex(const vertex & vert) : p1(vert.p1), p2(vert.p2), p3(vert.p3) {
-            }
             /*! \brief Constructor
              *
              * This constructor initializes the vertex with the first three points in the given vector.
              */
             vertex(const std::vector<vektor> & rhs) : p1(rhs[0]), p2(rhs[1]), p3(rhs[2]) {
             }
-            /*! \brief Python constructor
-             *
-             * This constructor initializes the vertex with the points given as three lists.
-             * This constructor is intended as interface to python.
-             * Do not use this constructor from within C++.
-             */
-            vertex(const boost::python::list & P1, const boost::python::list & P2, const boost::python::list & P3) :
-                p1(P1), p2(P2), p3(P3) {
-            }
-            /*! \brief Python constructor
-             *
-             * This constructor initializes the vertex with the points given as a list of lists.
-             * This constructor is intended as interface to python.
-             * Do not use this constructor from within C++.
-             */
-            vertex(const boost::python::list & list) :
-                p1(boost::python::extract<boost::python::list>(list[0])),
-                p2(boost::python::extract<boost::python::list>(list[1])),
-                p3(boost::python::extract<boost::python::list>(list[2])) {
-            }
-            /*! \brief Destructor. */
-            virtual ~vertex() {
-            }
-
-            /*! \brief Assignment operator.
-             *
-             * This operator copies the points from the given vertex to the current instance.
-             */
-            vertex & operator= (const vertex & rhs) {
-                if(this != &rhs) {
-                    p1 = rhs.p1;
-                    p2 = rhs.p2;
-                    p3 = rhs.p3;
-                }
-                return *this;
-            }
 
             /*! \brief Get intersection
              *
@@ -79,34 +41,68 @@ namespace wallLoad {
              * \param origin Position from where the ray originates.
              * \param direction The direction in which the ray travels.
              */
+            __attribute__((always_inline))
             hitResult intersect(const vektor & origin, const vektor & direction) const {
-                vektor e1, e2;
-                vektor P, Q, T;
-                double det, inv_det, u, v;
-                double t;
-                e1 = p2 - p1;
-                e2 = p3 - p1;
-                P = direction.get_cross_product(e2);
-                det = e1.get_dot_product(P);
+                vektor e1 = p2 - p1;
+                vektor e2 = p3 - p1;
+                vektor P = direction.get_cross_product(e2);
+                double det = e1.get_dot_product(P);
                 if( det > -EPSILON && det < EPSILON) {
-                    return hitResult(false, vektor());
+                    return hitResult();
                 }
-                inv_det = 1.0/det;
-                T = origin - p1;
-                u = T.get_dot_product(P) * inv_det;
+                double inv_det = 1.0/det;
+                vektor T = origin - p1;
+                double u = T.get_dot_product(P) * inv_det;
                 if(u < 0.0 || u > 1.0) {
-                    return hitResult(false, vektor());
+                    return hitResult();
                 }
-                Q = T.get_cross_product(e1);
-                v = direction.get_dot_product(Q)*inv_det;
+                vektor Q = T.get_cross_product(e1);
+                double v = direction.get_dot_product(Q)*inv_det;
                 if(v < 0.0 || u + v  > 1.0) {
-                    return hitResult(false, vektor());
+                    return hitResult();
                 }
-                t = e2.get_dot_product(Q) * inv_det;
-                if(t > EPSILON) {
-                    return hitResult(true, origin + t*direction);
+                double t = e2.get_dot_product(Q) * inv_det;
+                return hitResult(t > EPSILON, origin + t*direction);
+            }
+
+            /*! \brief Get the distance to the intersection
+             *
+             * This function calculates if the ray origination from the given position intersects the vertex
+             * not further away than the given limit.
+             * It uses the same Mller-Trumbore algorithm as intersect(), but rejects the vertex as soon as the
+             * intersection is known to lie beyond the limit and does not calculate the hit point.
+             * \param origin Position from where the ray originates.
+             * \param direction The direction in which the ray travels.
+             * \param tMax Largest accepted ray parameter.
+             * \param t Ray parameter of the intersection, the hit point is origin + t*direction.
+             * \return True if the vertex is hit with \f$\epsilon < t \leq t_{max}\f$.
+             */
+            __attribute__((always_inline))
+            bool intersect_before(const vektor & origin, const vektor & direction, const double tMax, double & t) const {
+                vektor e1 = p2 - p1;
+                vektor e2 = p3 - p1;
+                vektor P = direction.get_cross_product(e2);
+                double det = e1.get_dot_product(P);
+                if( det > -EPSILON && det < EPSILON) {
+                    return false;
                 }
-                return hitResult(false, origin + t*direction);
+                double inv_det = 1.0/det;
+                vektor T = origin - p1;
+                double u = T.get_dot_product(P) * inv_det;
+                if(u < 0.0 || u > 1.0) {
+                    return false;
+                }
+                vektor Q = T.get_cross_product(e1);
+                double tHit = e2.get_dot_product(Q) * inv_det;
+                if(tHit <= EPSILON || tHit > tMax) {
+                    return false;
+                }
+                double v = direction.get_dot_product(Q)*inv_det;
+                if(v < 0.0 || u + v  > 1.0) {
+                    return false;
+                }
+                t = tHit;
+                return true;
             }
 
             /*! \brief Calculate the area of the vertex
@@ -125,7 +121,7 @@ namespace wallLoad {
              *
              * This function returns the normal vector on the vertex.
              */
-            vektor get_normal() {
+            vektor get_normal() const {
                 return ((p2 - p1).get_cross_product(p3 - p1)).get_normalized();
             }
 
@@ -134,7 +130,7 @@ namespace wallLoad {
              * This function returns the center of the vertex
              * \f$ \mathrm{c} \ \frac{\mathbf{p}_1 + \mathbf{p}_2 + \mathbf{p}_3}{3}\f$
              */
-            vektor get_center() const {
+            constexpr vektor get_center() const {
                 return (p1 + p2 + p3)/3.0;
             }
 
@@ -143,6 +139,9 @@ namespace wallLoad {
             vektor p2; /*!< \brief Second point of vertex */
             vektor p3; /*!< \brief Thrid point of vertex */
         };
+
+        static_assert(std::is_trivially_copyable<vertex>::value && std::is_standard_layout<vertex>::value && sizeof(vertex) == 3*sizeof(vektor),
+                "vertex needs to be a plain array of three points");
     }
 }
 
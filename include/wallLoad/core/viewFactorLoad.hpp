@@ -0,0 +1,456 @@
+#ifndef include_wallLoad_core_viewFactorLoad_hpp
+#define include_wallLoad_core_viewFactorLoad_hpp
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <boost/math/constants/constants.hpp>
+#include <wallLoad/core/mesh.hpp>
+#include <wallLoad/core/radiationDistribution.hpp>
+#include <wallLoad/core/instanceMutex.hpp>
+
+namespace wallLoad {
+    namespace core {
+        /*! \brief Deterministic radiation load onto the mesh elements.
+         *
+         * This class calculates the same heat flux density as radiationLoad without random numbers,
+         * by integrating the emission seen from every mesh element.
+         * The power density arriving at the centre \f$\mathbf{y}\f$ of an element is
+         * \f$ F = \frac{1}{4\pi} \int |\cos\theta| \int_0^{L(\omega)} \epsilon(\mathbf{y} + s\omega) \,\mathrm{d}s \,\mathrm{d}\omega \f$,
+         * the emission along every direction \f$\omega\f$ up to the distance \f$L(\omega)\f$ at which the ray hits the wall.
+         * This is the integral over the emitting volume written in spherical coordinates around the element,
+         * so a single ray through the bounding volume hierarchy gives the visibility of all emission along one direction.
+         * Both sides of the element are integrated over a midpoint rule of \f$N_\theta \times 2 N_\theta\f$ cosine weighted
+         * directions each, and the emission along every ray by the midpoint rule with a step of at most h.
+         * The emission density of the radiation distribution is tabulated on s_tableSize x s_tableSize nodes covering its
+         * \f$(R,z)\f$ bounds and interpolated bilinearly.
+         *
+         * The error is controlled by refinement: level \f$l\f$ uses \f$N_\theta = 2^{l+3}\f$ and \f$h = h_0 2^{-l}\f$,
+         * with \f$h_0\f$ a sixteenth of the larger side of the \f$(R,z)\f$ bounds.
+         * Every element is refined until two successive levels differ by less than the tolerance times its heat flux density,
+         * or times s_floorFraction of the peak heat flux density for elements below it, or the maximum level is reached.
+         * This difference is the error estimate returned by get_relative_error().
+         *
+         * Like radiationLoad::get_heat_flux() the heat flux density is normalized to the power reaching the wall.
+         * The wall absorbs the fraction given by the emissivity of every element on the first hit, reflections are not followed.
+         * The result is the heat flux density at the centre of an element, which radiationLoad averages over the element.
+         * For an instanced mesh the elements of its first copy are integrated, which for copies evenly spaced by
+         * mesh::set_toroidal_instances() equals the mean over the copies radiationLoad records.
+         * The absorbed power counts every copy.
+         * The elements are calculated independently by several threads, so the result does not depend on their number.
+         * All functions lock the mutex of the instance, so it can be shared by several threads.
+         */
+        class viewFactorLoad {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor copies the given mesh and tabulates the emission of the given radiation distribution.
+                 * Nothing is calculated before calculate() is called.
+                 */
+                viewFactorLoad(const mesh & grid, const radiationDistribution & distribution) :
+                    viewFactorLoad(grid, distribution, readLock(grid.get_mutex()), readLock(distribution.get_mutex())) {
+                }
+
+                /*! \brief Copy constructor */
+                viewFactorLoad(const viewFactorLoad & rhs) :
+                    viewFactorLoad(rhs, readLock(rhs.m_mutex)) {
+                }
+
+                /*! \brief Assignment operator */
+                viewFactorLoad & operator=(const viewFactorLoad & rhs) {
+                    if(this != &rhs) {
+                        viewFactorLoad copy(rhs);
+                        writeLock lock(m_mutex);
+                        m_mesh = copy.m_mesh;
+                        m_table = copy.m_table;
+                        m_Rmin = copy.m_Rmin;
+                        m_Rmax = copy.m_Rmax;
+                        m_zmin = copy.m_zmin;
+                        m_zmax = copy.m_zmax;
+                        m_emitted = copy.m_emitted;
+                        m_flux = copy.m_flux;
+                        m_error = copy.m_error;
+                        m_levels = copy.m_levels;
+                        m_tolerance = copy.m_tolerance;
+                        m_maxLevel = copy.m_maxLevel;
+                        m_threads = copy.m_threads;
+                    }
+                    return *this;
+                }
+
+                /*! \brief Calculate the heat flux density onto all mesh elements
+                 *
+                 * All elements are first calculated at level 0 to find the peak heat flux density, then refined one by one.
+                 * The threads take blocks of s_block elements at a time.
+                 */
+                void calculate() {
+                    std::vector<double> flux(size(), 0.0);
+                    std::vector<double> error(size(), 0.0);
+                    std::vector<uint32_t> levels(size(), 0);
+                    {
+                        readLock lock(m_mutex);
+                        run_blocks([&](const uint32_t i) {
+                            flux[i] = element_flux(i, 0);
+                        });
+                        double peak = 0.0;
+                        for(uint32_t i = 0; i < size(); ++i) {
+                            peak = std::max(peak, flux[i]);
+                        }
+                        run_blocks([&](const uint32_t i) {
+                            refine(i, s_floorFraction*peak, flux[i], error[i], levels[i]);
+                        });
+                    }
+                    writeLock lock(m_mutex);
+                    m_flux = flux;
+                    m_error = error;
+                    m_levels = levels;
+                }
+
+                /*! \brief Check if the heat flux density has been calculated. */
+                bool is_calculated() const {
+                    readLock lock(m_mutex);
+                    return !m_flux.empty();
+                }
+
+                /*! \brief Set the tolerance of the relative difference between two levels, see the class description. */
+                void set_tolerance(const double tolerance) {
+                    if(!(tolerance > 0.0)) {
+                        throw std::invalid_argument("the tolerance needs to be positive");
+                    }
+                    writeLock lock(m_mutex);
+                    m_tolerance = tolerance;
+                }
+
+                /*! \brief Get the tolerance of the relative difference between two levels. */
+                double get_tolerance() const {
+                    readLock lock(m_mutex);
+                    return m_tolerance;
+                }
+
+                /*! \brief Set the highest level of refinement
+                 *
+                 * Every level takes about eight times as long as the one before.
+                 */
+                void set_max_level(const uint32_t level) {
+                    writeLock lock(m_mutex);
+                    m_maxLevel = std::min(level, s_maxLevel);
+                }
+
+                /*! \brief Get the highest level of refinement. */
+                uint32_t get_max_level() const {
+                    readLock lock(m_mutex);
+                    return m_maxLevel;
+                }
+
+                /*! \brief Set the number of threads used by calculate(). */
+                void set_threads(const uint32_t threads) {
+                    writeLock lock(m_mutex);
+                    m_threads = std::max(1u, threads);
+                }
+
+                /*! \brief Get the number of threads used by calculate(). */
+                uint32_t get_threads() const {
+                    readLock lock(m_mutex);
+                    return m_threads;
+                }
+
+                /*! \brief Get the number of mesh elements. */
+                uint32_t size() const {
+                    return m_mesh.size();
+                }
+
+                /*! \brief Calculate the heat flux density onto mesh elements
+                 *
+                 * Provided the total power, this function scales the power densities \f$F_i\f$ of the elements
+                 * to the power reaching the wall, \f$ P_i = P_{tot} \frac{F_i}{\sum_j F_j A_j} \f$.
+                 * It returns zeros before calculate() is called.
+                 */
+                std::vector<double> get_heat_flux(const double Ptot) const {
+                    std::vector<double> output(size());
+                    get_heat_flux(Ptot, output.data());
+                    return output;
+                }
+
+                /*! \brief Calculate the heat flux density onto mesh elements
+                 *
+                 * This function writes the heat flux density onto the size() mesh elements to the given memory.
+                 */
+                void get_heat_flux(const double Ptot, double * output) const {
+                    readLock lock(m_mutex);
+                    double total = absorbed();
+                    for(uint32_t i = 0; i < size(); ++i) {
+                        output[i] = total > 0.0 ? m_flux[i]/total*Ptot : 0.0;
+                    }
+                }
+
+                /*! \brief Get the estimated relative error of the heat flux density onto mesh elements
+                 *
+                 * This is the relative difference to the level before the last one, see the class description.
+                 */
+                std::vector<double> get_relative_error() const {
+                    readLock lock(m_mutex);
+                    return m_error;
+                }
+
+                /*! \brief Get the level of refinement every mesh element was calculated with. */
+                std::vector<uint32_t> get_levels() const {
+                    readLock lock(m_mutex);
+                    return m_levels;
+                }
+
+                /*! \brief Get the fraction of the emitted power absorbed by the mesh. */
+                double get_absorbed_fraction() const {
+                    readLock lock(m_mutex);
+                    return m_emitted > 0.0 ? absorbed()/m_emitted : 0.0;
+                }
+
+                /*! \brief Get the emission density of the radiation distribution interpolated from the table. */
+                double get_emission(const double R, const double z) const {
+                    double x = (R - m_Rmin)/(m_Rmax - m_Rmin)*(s_tableSize - 1);
+                    double y = (z - m_zmin)/(m_zmax - m_zmin)*(s_tableSize - 1);
+                    if(!(x >= 0.0 && y >= 0.0 && x <= s_tableSize - 1 && y <= s_tableSize - 1)) {
+                        return 0.0;
+                    }
+                    uint32_t i = std::min((uint32_t)x, s_tableSize - 2);
+                    uint32_t j = std::min((uint32_t)y, s_tableSize - 2);
+                    x -= i;
+                    y -= j;
+                    const double * node = &m_table[i*s_tableSize + j];
+                    return (1.0 - x)*((1.0 - y)*node[0] + y*node[1]) + x*((1.0 - y)*node[s_tableSize] + y*node[s_tableSize + 1]);
+                }
+
+            protected:
+                /*! \brief Constructor
+                 *
+                 * This constructor copies the given mesh and tabulates the emission of the given radiation distribution
+                 * while the given locks keep them unchanged.
+                 */
+                viewFactorLoad(const mesh & grid, const radiationDistribution & distribution, const readLock &, const readLock &) :
+                    m_mesh(grid), m_table(s_tableSize*s_tableSize),
+                    m_Rmin(distribution.get_Rmin()), m_Rmax(distribution.get_Rmax()),
+                    m_zmin(distribution.get_zmin()), m_zmax(distribution.get_zmax()), m_emitted(0.0),
+                    m_flux(), m_error(), m_levels(),
+                    m_tolerance(s_defaultTolerance), m_maxLevel(s_defaultMaxLevel), m_threads(1) {
+                    if(!(m_Rmax > m_Rmin && m_zmax > m_zmin)) {
+                        throw std::invalid_argument("the (R,z) bounds of the radiation distribution are empty");
+                    }
+                    if(!m_mesh.has_hierarchy()) {
+                        m_mesh.build_hierarchy();
+                    }
+                    double dR = (m_Rmax - m_Rmin)/(s_tableSize - 1);
+                    double dz = (m_zmax - m_zmin)/(s_tableSize - 1);
+                    for(uint32_t i = 0; i < s_tableSize; ++i) {
+                        for(uint32_t j = 0; j < s_tableSize; ++j) {
+                            m_table[i*s_tableSize + j] = distribution.get_emission(std::min(m_Rmin + i*dR, m_Rmax), std::min(m_zmin + j*dz, m_zmax));
+                        }
+                    }
+                    // the emitted power with the same interpolation, as integral over the cells of the table
+                    for(uint32_t i = 0; i + 1 < s_tableSize; ++i) {
+                        double R = m_Rmin + (i + 0.5)*dR;
+                        for(uint32_t j = 0; j + 1 < s_tableSize; ++j) {
+                            m_emitted += get_emission(R, m_zmin + (j + 0.5)*dz)*2.0*boost::math::constants::pi<double>()*R*dR*dz;
+                        }
+                    }
+                }
+
+                /*! \brief Copy constructor
+                 *
+                 * This constructor copies the given instance while the given lock keeps it unchanged.
+                 */
+                viewFactorLoad(const viewFactorLoad & rhs, const readLock &) :
+                    m_mesh(rhs.m_mesh), m_table(rhs.m_table), m_Rmin(rhs.m_Rmin), m_Rmax(rhs.m_Rmax),
+                    m_zmin(rhs.m_zmin), m_zmax(rhs.m_zmax), m_emitted(rhs.m_emitted),
+                    m_flux(rhs.m_flux), m_error(rhs.m_error), m_levels(rhs.m_levels),
+                    m_tolerance(rhs.m_tolerance), m_maxLevel(rhs.m_maxLevel), m_threads(rhs.m_threads) {
+                }
+
+                /*! \brief Call function for every element, with the elements split into blocks taken by m_threads threads. */
+                template<class Function>
+                void run_blocks(Function function) const {
+                    std::atomic<uint32_t> next(0);
+                    auto worker = [&]() {
+                        while(true) {
+                            uint32_t first = next.fetch_add(s_block);
+                            if(first >= size()) {
+                                return;
+                            }
+                            for(uint32_t i = first; i < std::min(first + s_block, size()); ++i) {
+                                function(i);
+                            }
+                        }
+                    };
+                    std::vector<std::thread> workers;
+                    for(uint32_t i = 1; i < m_threads; ++i) {
+                        workers.push_back(std::thread(worker));
+                    }
+                    worker();
+                    for(auto iter = workers.begin(); iter != workers.end(); ++iter) {
+                        iter->join();
+                    }
+                }
+
+                /*! \brief Refine the power density flux of the ith element, calculated at level 0, until it converges. */
+                void refine(const uint32_t i, const double floor, double & flux, double & error, uint32_t & level) const {
+                    error = std::numeric_limits<double>::infinity();
+                    for(level = 1; level <= m_maxLevel; ++level) {
+                        double refined = element_flux(i, level);
+                        double difference = fabs(refined - flux);
+                        flux = refined;
+                        error = flux > 0.0 ? difference/flux : (difference > 0.0 ? std::numeric_limits<double>::infinity() : 0.0);
+                        if(difference <= m_tolerance*std::max(flux, floor)) {
+                            return;
+                        }
+                    }
+                    level = m_maxLevel;
+                }
+
+                /*! \brief Power density absorbed at the centre of the ith element at the given level of refinement. */
+                double element_flux(const uint32_t i, const uint32_t level) const {
+                    const double pi = boost::math::constants::pi<double>();
+                    vertex element = m_mesh.get_vertex(i);
+                    vektor centre = m_mesh.rotate(element.get_center(), 0);
+                    vektor normal = m_mesh.rotate(element.get_normal(), 0);
+                    // orthonormal frame around the normal
+                    vektor helper = fabs(normal.x) < 0.5 ? vektor(1.0, 0.0, 0.0) : vektor(0.0, 1.0, 0.0);
+                    vektor tangent = normal.get_cross_product(helper).get_normalized();
+                    vektor bitangent = normal.get_cross_product(tangent);
+                    uint32_t Ntheta = s_baseDirections << level;
+                    uint32_t Npsi = 2*Ntheta;
+                    double step = std::max(m_Rmax - m_Rmin, m_zmax - m_zmin)/s_baseSteps/(1 << level);
+                    double offset = s_offset*std::max(m_Rmax - m_Rmin, m_zmax - m_zmin);
+                    double sum = 0.0;
+                    for(int32_t side = -1; side <= 1; side += 2) {
+                        vektor up = normal*side;
+                        vektor origin = centre + up*offset;
+                        for(uint32_t k = 0; k < Ntheta; ++k) {
+                            double u = (k + 0.5)/Ntheta;
+                            double sinTheta = sqrt(u);
+                            double cosTheta = sqrt(1.0 - u);
+                            for(uint32_t l = 0; l < Npsi; ++l) {
+                                double psi = 2.0*pi*(l + 0.5)/Npsi;
+                                vektor direction = tangent*(sinTheta*cos(psi)) + bitangent*(sinTheta*sin(psi)) + up*cosTheta;
+                                double t;
+                                m_mesh.evaluate_closest(origin, direction, t);
+                                sum += line_integral(origin, direction, t, step);
+                            }
+                        }
+                    }
+                    // the cosine weighted directions stand for pi steradian each side
+                    return m_mesh.get_emissivity()[i]*sum*pi/(Ntheta*Npsi)/(4.0*pi);
+                }
+
+                /*! \brief Integral of the emission along the ray from 0 to tMax by the midpoint rule with steps of at most step. */
+                double line_integral(const vektor & origin, const vektor & direction, const double tMax, const double step) const {
+                    // the ray is within the z bounds on one interval and within the R bounds on at most two
+                    double tNear = 0.0, tFar = tMax;
+                    if(direction.z != 0.0) {
+                        double t0 = (m_zmin - origin.z)/direction.z;
+                        double t1 = (m_zmax - origin.z)/direction.z;
+                        tNear = std::max(tNear, std::min(t0, t1));
+                        tFar = std::min(tFar, std::max(t0, t1));
+                    }
+                    else if(origin.z < m_zmin || origin.z > m_zmax) {
+                        return 0.0;
+                    }
+                    double a = direction.x*direction.x + direction.y*direction.y;
+                    double b = origin.x*direction.x + origin.y*direction.y;
+                    double c = origin.x*origin.x + origin.y*origin.y;
+                    double enter, leave;
+                    if(!quadratic_interval(a, b, c - m_Rmax*m_Rmax, enter, leave)) {
+                        return 0.0;
+                    }
+                    tNear = std::max(tNear, enter);
+                    tFar = std::min(tFar, leave);
+                    if(!(tNear < tFar)) {
+                        return 0.0;
+                    }
+                    double sum = 0.0;
+                    if(m_Rmin > 0.0 && quadratic_interval(a, b, c - m_Rmin*m_Rmin, enter, leave)) {
+                        sum += segment_integral(origin, direction, tNear, std::min(tFar, enter), step);
+                        sum += segment_integral(origin, direction, std::max(tNear, leave), tFar, step);
+                    }
+                    else {
+                        sum += segment_integral(origin, direction, tNear, tFar, step);
+                    }
+                    return sum;
+                }
+
+                /*! \brief Interval of t where \f$a t^2 + 2 b t + c < 0\f$, false if it is empty. */
+                static bool quadratic_interval(const double a, const double b, const double c, double & enter, double & leave) {
+                    if(a <= 0.0) {
+                        enter = -std::numeric_limits<double>::infinity();
+                        leave = std::numeric_limits<double>::infinity();
+                        return c < 0.0;
+                    }
+                    double discriminant = b*b - a*c;
+                    if(discriminant <= 0.0) {
+                        return false;
+                    }
+                    double q = -(b + std::copysign(sqrt(discriminant), b));
+                    enter = q/a;
+                    leave = c/q;
+                    if(enter > leave) {
+                        std::swap(enter, leave);
+                    }
+                    return true;
+                }
+
+                /*! \brief Integral of the emission along the ray from t0 to t1 by the midpoint rule with steps of at most step. */
+                double segment_integral(const vektor & origin, const vektor & direction, const double t0, const double t1,
+                    const double step) const {
+                    if(!(t1 > t0)) {
+                        return 0.0;
+                    }
+                    uint32_t N = (uint32_t)ceil((t1 - t0)/step);
+                    double h = (t1 - t0)/N;
+                    double sum = 0.0;
+                    for(uint32_t k = 0; k < N; ++k) {
+                        double t = t0 + (k + 0.5)*h;
+                        sum += get_emission(hypot(origin.x + t*direction.x, origin.y + t*direction.y), origin.z + t*direction.z);
+                    }
+                    return sum*h;
+                }
+
+                /*! \brief Total power density times area of all elements of all copies without locking the instance. */
+                double absorbed() const {
+                    double total = 0.0;
+                    for(uint32_t i = 0; i < m_flux.size(); ++i) {
+                        total += m_flux[i]*m_mesh.get_vertex(i).get_area();
+                    }
+                    return total*m_mesh.get_instance_count();
+                }
+
+                mesh m_mesh; /*!< \brief Mesh representing the first wall. */
+                std::vector<double> m_table; /*!< \brief Emission density at the nodes of the table, z running fastest. */
+                double m_Rmin; /*!< \brief Lowest \f$R\f$ of the table. */
+                double m_Rmax; /*!< \brief Highest \f$R\f$ of the table. */
+                double m_zmin; /*!< \brief Lowest \f$z\f$ of the table. */
+                double m_zmax; /*!< \brief Highest \f$z\f$ of the table. */
+                double m_emitted; /*!< \brief Total emitted power of the table. */
+                std::vector<double> m_flux; /*!< \brief Absorbed power density of every element, empty before calculate(). */
+                std::vector<double> m_error; /*!< \brief Estimated relative error of every element. */
+                std::vector<uint32_t> m_levels; /*!< \brief Level of refinement of every element. */
+                double m_tolerance; /*!< \brief Tolerance of the relative difference between two levels. */
+                uint32_t m_maxLevel; /*!< \brief Highest level of refinement. */
+                uint32_t m_threads; /*!< \brief Number of threads used by calculate(). */
+                mutable instanceMutex m_mutex; /*!< \brief Mutex guarding the instance. */
+
+                static constexpr uint32_t s_tableSize = 512; /*!< \brief Number of nodes of the emission table in R and z. */
+                static constexpr uint32_t s_baseDirections = 8; /*!< \brief Number of polar directions per side at level 0. */
+                static constexpr uint32_t s_baseSteps = 16; /*!< \brief Number of steps across the larger side of the bounds at level 0. */
+                static constexpr uint32_t s_maxLevel = 8; /*!< \brief Highest level of refinement that can be set. */
+                static constexpr uint32_t s_defaultMaxLevel = 4; /*!< \brief Default highest level of refinement. */
+                static constexpr double s_defaultTolerance = 0.01; /*!< \brief Default tolerance. */
+                static constexpr double s_floorFraction = 0.01; /*!< \brief Fraction of the peak below which the tolerance is absolute. */
+                static constexpr double s_offset = 1e-9; /*!< \brief Distance of the ray origins from the element, relative to the bounds. */
+                static constexpr uint32_t s_block = 16; /*!< \brief Number of elements a thread takes at a time. */
+        };
+    }
+}
+
+#endif
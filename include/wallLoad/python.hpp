@@ -0,0 +1,822 @@
+#ifndef include_wallLoad_python_hpp
+#define include_wallLoad_python_hpp
+
+#include <boost/python.hpp>
+#include <stdexcept>
+#include <limits>
+#include <string>
+#include <string.h>
+#include <stdint.h>
+#include <wallLoad/core/vektor.hpp>
+#include <wallLoad/core/vertex.hpp>
+#include <wallLoad/core/polygon.hpp>
+#include <wallLoad/core/mesh.hpp>
+#include <wallLoad/core/radiationDistribution.hpp>
+#include <wallLoad/core/radiationLoad.hpp>
+#include <wallLoad/core/samplingJob.hpp>
+#include <wallLoad/core/responseMatrix.hpp>
+#include <wallLoad/core/axisymmetricLoad.hpp>
+#include <wallLoad/core/viewFactorLoad.hpp>
+
+namespace wallLoad {
+    /*! \brief Conversion of the geometric value types and arrays from and to python objects.
+     *
+     * The classes vektor, vertex and hitResult are plain value types without any knowledge of python.
+     * The constructors from python lists and dictionaries and the conversion to python objects live here,
+     * as well as the entry points which exchange whole arrays with NumPy through the python buffer protocol.
+     * They are only intended to interface with python.
+     * Do not use these functions from within C++.
+     */
+    namespace python {
+        /*! \brief Create a vector from a python list \f$[x,y,z]\f$. */
+        inline core::vektor * make_vektor_from_list(const boost::python::list & list) {
+            return new core::vektor(boost::python::extract<double>(list[0]),
+                                    boost::python::extract<double>(list[1]),
+                                    boost::python::extract<double>(list[2]));
+        }
+
+        /*! \brief Create a vector from a python dictionary with the keys x, y and z. */
+        inline core::vektor * make_vektor_from_dict(const boost::python::dict & dict) {
+            return new core::vektor(boost::python::extract<double>(dict.get("x")),
+                                    boost::python::extract<double>(dict.get("y")),
+                                    boost::python::extract<double>(dict.get("z")));
+        }
+
+        /*! \brief Return the vector as python list \f$[x,y,z]\f$. */
+        inline boost::python::list vektor_to_list(const core::vektor & vek) {
+            boost::python::list output;
+            output.append(vek.x);
+            output.append(vek.y);
+            output.append(vek.z);
+            return output;
+        }
+
+        /*! \brief Return the vector as python dictionary with the keys x, y and z. */
+        inline boost::python::dict vektor_to_dict(const core::vektor & vek) {
+            boost::python::dict dict;
+            dict.setdefault("x", vek.x);
+            dict.setdefault("y", vek.y);
+            dict.setdefault("z", vek.z);
+            return dict;
+        }
+
+        /*! \brief Convert a python list \f$[x,y,z]\f$ to a vector. */
+        inline core::vektor to_vektor(const boost::python::object & list) {
+            return core::vektor(boost::python::extract<double>(list[0]),
+                                boost::python::extract<double>(list[1]),
+                                boost::python::extract<double>(list[2]));
+        }
+
+        /*! \brief Create a vertex from three python lists \f$[x,y,z]\f$. */
+        inline core::vertex * make_vertex_from_lists(const boost::python::list & P1, const boost::python::list & P2, const boost::python::list & P3) {
+            return new core::vertex(to_vektor(P1), to_vektor(P2), to_vektor(P3));
+        }
+
+        /*! \brief Create a vertex from a python list of three lists \f$[x,y,z]\f$. */
+        inline core::vertex * make_vertex_from_list(const boost::python::list & list) {
+            return new core::vertex(to_vektor(list[0]), to_vektor(list[1]), to_vektor(list[2]));
+        }
+
+        /*! \brief Access to the memory of a python object supporting the buffer protocol.
+         *
+         * This class gives access to the memory of e.g. a NumPy array without copying it.
+         * Only arrays of doubles are accepted, the strides of the array are respected.
+         */
+        class buffer {
+            public:
+                /*! \brief Constructor
+                 *
+                 * This constructor requests the buffer of the given object.
+                 * \param object Python object, e.g. a NumPy array.
+                 * \param name Name of the argument used in error messages.
+                 */
+                buffer(const boost::python::object & object, const std::string & name) : m_name(name) {
+                    if(PyObject_GetBuffer(object.ptr(), &m_view, PyBUF_RECORDS_RO) != 0) {
+                        boost::python::throw_error_already_set();
+                    }
+                    if(!is_double(m_view.format) || m_view.itemsize != sizeof(double)) {
+                        PyBuffer_Release(&m_view);
+                        throw std::invalid_argument(name + " needs to be an array of float64");
+                    }
+                }
+
+                /*! \brief Destructor */
+                ~buffer() {
+                    PyBuffer_Release(&m_view);
+                }
+
+                /*! \brief Get the number of dimensions. */
+                int get_dimensions() const {
+                    return m_view.ndim;
+                }
+
+                /*! \brief Get the number of elements in dimension i. */
+                uint64_t get_shape(const int i) const {
+                    return m_view.shape[i];
+                }
+
+                /*! \brief Check that the array has the shape N x columns. */
+                void check_shape(const uint64_t columns) const {
+                    if(m_view.ndim != 2 || (uint64_t)m_view.shape[1] != columns) {
+                        throw std::invalid_argument(m_name + " needs to be an array of shape (N," + std::to_string(columns) + ")");
+                    }
+                }
+
+                /*! \brief Get the element (i,j) of a two dimensional array. */
+                double operator()(const uint64_t i, const uint64_t j) const {
+                    return *reinterpret_cast<const double*>(static_cast<const char*>(m_view.buf) + i*m_view.strides[0] + j*m_view.strides[1]);
+                }
+
+                /*! \brief Get the element i of a one dimensional array. */
+                double operator()(const uint64_t i) const {
+                    return *reinterpret_cast<const double*>(static_cast<const char*>(m_view.buf) + i*m_view.strides[0]);
+                }
+
+                /*! \brief Get the row i of an array of shape N x 3 as vector. */
+                core::vektor get_vektor(const uint64_t i) const {
+                    return core::vektor((*this)(i, 0), (*this)(i, 1), (*this)(i, 2));
+                }
+
+            protected:
+                /*! \brief Check if the format string of the buffer describes a native double. */
+                static bool is_double(const char * format) {
+                    if(format == 0) {
+                        return false;
+                    }
+                    if(*format == '@' || *format == '=' || (*format == '<' && s_littleEndian)) {
+                        ++format;
+                    }
+                    return strcmp(format, "d") == 0;
+                }
+
+                buffer(const buffer &); /*!< \brief Buffers are not copyable. */
+                buffer & operator=(const buffer &); /*!< \brief Buffers are not assignable. */
+
+                static constexpr bool s_littleEndian = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__; /*!< \brief Byte order of the host. */
+
+                Py_buffer m_view; /*!< \brief View of the memory. */
+                std::string m_name; /*!< \brief Name of the argument used in error messages. */
+        };
+
+        /*! \brief Release the global interpreter lock as long as the instance exists.
+         *
+         * No python object may be touched while the lock is released.
+         */
+        class allowThreads {
+            public:
+                /*! \brief Constructor, releases the lock. */
+                allowThreads() : m_state(PyEval_SaveThread()) {}
+                /*! \brief Destructor, takes the lock again. */
+                ~allowThreads() {
+                    PyEval_RestoreThread(m_state);
+                }
+            protected:
+                allowThreads(const allowThreads &); /*!< \brief Not copyable. */
+                allowThreads & operator=(const allowThreads &); /*!< \brief Not assignable. */
+
+                PyThreadState * m_state; /*!< \brief Thread state saved while the lock is released. */
+        };
+
+        /*! \brief Call a member function without holding the global interpreter lock.
+         *
+         * withoutGil<&C::f>::call has the signature of C::f with the instance as first argument
+         * and can be bound to python instead of C::f.
+         * It is used for functions which run long or may wait for the mutex of the instance.
+         * The arguments and the result must not be python objects.
+         */
+        template<auto F>
+        struct withoutGil;
+
+        /*! \brief Call a non-const member function without holding the global interpreter lock. */
+        template<class C, class R, class... A, R (C::*F)(A...)>
+        struct withoutGil<F> {
+            /*! \brief Call the member function of the given instance. */
+            static R call(C & object, A... args) {
+                allowThreads unlocked;
+                return (object.*F)(args...);
+            }
+        };
+
+        /*! \brief Call a const member function without holding the global interpreter lock. */
+        template<class C, class R, class... A, R (C::*F)(A...) const>
+        struct withoutGil<F> {
+            /*! \brief Call the member function of the given instance. */
+            static R call(const C & object, A... args) {
+                allowThreads unlocked;
+                return (object.*F)(args...);
+            }
+        };
+
+        /*! \brief Convert the given values to a python list. */
+        template<class T>
+        boost::python::list to_list(const std::vector<T> & values) {
+            boost::python::list output;
+            for(auto iter = values.begin(); iter != values.end(); ++iter) {
+                output.append(*iter);
+            }
+            return output;
+        }
+
+        /*! \brief Create an uninitialized C contiguous NumPy array.
+         *
+         * \param shape Shape of the array.
+         * \param dtype NumPy type of the elements, e.g. float64.
+         * \param data Set to the start of the memory of the array.
+         */
+        template<class T>
+        boost::python::object make_array(const boost::python::tuple & shape, const char * dtype, T * & data) {
+            boost::python::object array = boost::python::import("numpy").attr("empty")(shape, dtype);
+            Py_buffer view;
+            if(PyObject_GetBuffer(array.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE) != 0) {
+                boost::python::throw_error_already_set();
+            }
+            data = static_cast<T*>(view.buf);
+            PyBuffer_Release(&view);
+            return array;
+        }
+
+        /*! \brief Calculate the hit points of rays given as NumPy arrays.
+         *
+         * This function calculates the closest intersection of each ray with the mesh.
+         * The rays are given as arrays of shape (N,3) of float64, which are read in place.
+         * It returns a tuple of three NumPy arrays:
+         * the index of the element that got hit (int32, -1 for a miss),
+         * the ray parameter t (float64, infinity for a miss) and
+         * the hit point origin + t*direction (float64 of shape (N,3), NaN for a miss).
+         * The global interpreter lock is released while the rays are traced, the mesh is locked for reading meanwhile.
+         */
+        inline boost::python::tuple evaluate_hits_array(const core::mesh & grid, const boost::python::object & origins,
+            const boost::python::object & directions) {
+            buffer origin(origins, "origins");
+            buffer direction(directions, "directions");
+            origin.check_shape(3);
+            direction.check_shape(3);
+            const uint64_t N = origin.get_shape(0);
+            if(direction.get_shape(0) != N) {
+                throw std::invalid_argument("origins and directions need to have the same length");
+            }
+            int32_t * element;
+            double * t;
+            double * point;
+            boost::python::object elementArray = make_array(boost::python::make_tuple(N), "int32", element);
+            boost::python::object tArray = make_array(boost::python::make_tuple(N), "float64", t);
+            boost::python::object pointArray = make_array(boost::python::make_tuple(N, 3), "float64", point);
+            {
+                allowThreads unlocked;
+                core::readLock lock(grid.get_mutex());
+                for(uint64_t i = 0; i < N; ++i) {
+                    core::vektor o = origin.get_vektor(i);
+                    core::vektor d = direction.get_vektor(i);
+                    element[i] = grid.evaluate_closest(o, d, t[i]);
+                    core::vektor hit = element[i] < 0 ? core::vektor(std::numeric_limits<double>::quiet_NaN(),
+                        std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()) : o + t[i]*d;
+                    point[3*i] = hit.x;
+                    point[3*i + 1] = hit.y;
+                    point[3*i + 2] = hit.z;
+                }
+            }
+            return boost::python::make_tuple(elementArray, tArray, pointArray);
+        }
+
+        /*! \brief Calculate the hit points of the rays and return them as python list.
+         *
+         * This function calculates the closest intersection of each ray with the mesh.
+         * Only the rays which hit the mesh are returned.
+         * The global interpreter lock is released while the rays are traced.
+         */
+        inline boost::python::list evaluate_hits_list(const core::mesh & grid, const boost::python::list & origins,
+            const boost::python::list & directions) {
+            std::vector<core::vektor> tempOrigins;
+            std::vector<core::vektor> tempDirections;
+            uint32_t N = boost::python::len(origins);
+            for(uint32_t i = 0; i < N; ++i) {
+                tempOrigins.push_back(boost::python::extract<core::vektor>(origins[i]));
+                tempDirections.push_back(boost::python::extract<core::vektor>(directions[i]));
+            }
+            std::vector<core::hitResult> hits;
+            {
+                allowThreads unlocked;
+                hits = grid.evaluateHits(tempOrigins, tempDirections);
+            }
+            boost::python::list output;
+            for(auto iter = hits.begin(); iter != hits.end(); ++iter) {
+                if(iter->hasHit) {
+                    output.append(*iter);
+                }
+            }
+            return output;
+        }
+
+        /*! \brief Get random poloidal points as python list. */
+        inline boost::python::list random_points_list(core::radiationDistribution & distribution, const uint32_t N) {
+            std::vector<core::vektor> values;
+            {
+                allowThreads unlocked;
+                values = distribution.get_random_points(N);
+            }
+            return to_list(values);
+        }
+
+        /*! \brief Get random points in the torus as python list. */
+        inline boost::python::list random_toroidal_points_list(core::radiationDistribution & distribution, const uint32_t N) {
+            std::vector<core::vektor> values;
+            {
+                allowThreads unlocked;
+                values = distribution.get_random_toroidal_points(N);
+            }
+            return to_list(values);
+        }
+
+        /*! \brief Calculate the heat flux density onto the mesh elements as python list. */
+        inline boost::python::list heat_flux_list(const core::radiationLoad & load, const double Ptot) {
+            std::vector<double> values;
+            {
+                allowThreads unlocked;
+                values = load.get_heat_flux(Ptot);
+            }
+            return to_list(values);
+        }
+
+        /*! \brief Create a radiation load for the given mesh and radiation distribution.
+         *
+         * The global interpreter lock is released while the mesh and the distribution are copied,
+         * since they may be in use by another thread.
+         */
+        inline core::radiationLoad * make_radiation_load(const core::mesh & grid, const core::radiationDistribution & distribution) {
+            allowThreads unlocked;
+            return new core::radiationLoad(grid, distribution);
+        }
+
+        /*! \brief Copy the given radiation load, the global interpreter lock is released meanwhile. */
+        inline core::radiationLoad * copy_radiation_load(const core::radiationLoad & rhs) {
+            allowThreads unlocked;
+            return new core::radiationLoad(rhs);
+        }
+
+        /*! \brief Add N samples to the radiation load, the global interpreter lock is released meanwhile. */
+        inline void add_samples(core::radiationLoad & load, const uint32_t N) {
+            allowThreads unlocked;
+            load.add_samples(N);
+        }
+
+        /*! \brief Start adding N samples to the radiation load in the background.
+         *
+         * The returned job keeps the radiation load alive.
+         */
+        inline core::samplingJob * start_samples(core::radiationLoad & load, const uint32_t N) {
+            return new core::samplingJob(load, N);
+        }
+
+        /*! \brief Copy the given values into a new NumPy array. */
+        inline boost::python::object to_array(const std::vector<double> & values) {
+            double * data;
+            boost::python::object array = make_array(boost::python::make_tuple(values.size()), "float64", data);
+            std::copy(values.begin(), values.end(), data);
+            return array;
+        }
+
+        /*! \brief Get the emissivity of every vertex of the mesh as NumPy array. */
+        inline boost::python::object emissivity_array(const core::mesh & grid) {
+            return to_array(grid.get_emissivity());
+        }
+
+        /*! \brief Set the emissivity of every vertex of the mesh from a NumPy array or any other python sequence. */
+        inline void set_emissivity(core::mesh & grid, const boost::python::object & emissivity) {
+            std::vector<double> values(boost::python::len(emissivity));
+            if(PyObject_CheckBuffer(emissivity.ptr())) {
+                buffer emissivityBuffer(emissivity, "emissivity");
+                if(emissivityBuffer.get_dimensions() != 1) {
+                    throw std::invalid_argument("emissivity needs to be a one dimensional array");
+                }
+                for(uint64_t i = 0; i < values.size(); ++i) {
+                    values[i] = emissivityBuffer(i);
+                }
+            }
+            else {
+                for(uint64_t i = 0; i < values.size(); ++i) {
+                    values[i] = boost::python::extract<double>(emissivity[i]);
+                }
+            }
+            allowThreads unlocked;
+            grid.set_emissivity(values);
+        }
+
+        /*! \brief Set the copies of the mesh from a python sequence of toroidal angles in radians. */
+        inline void set_instances(core::mesh & grid, const boost::python::object & angles) {
+            std::vector<double> values(boost::python::len(angles));
+            for(uint64_t i = 0; i < values.size(); ++i) {
+                values[i] = boost::python::extract<double>(angles[i]);
+            }
+            allowThreads unlocked;
+            grid.set_instances(values);
+        }
+
+        /*! \brief Get the toroidal angles of the copies of the mesh as NumPy array. */
+        inline boost::python::object instances_array(const core::mesh & grid) {
+            return to_array(grid.get_instances());
+        }
+
+        /*! \brief Set the emissivity of all vertices of the given physical group of the mesh. */
+        inline void set_group_emissivity(core::mesh & grid, const int32_t physical, const double emissivity) {
+            allowThreads unlocked;
+            grid.set_emissivity(physical, emissivity);
+        }
+
+        /*! \brief Get the weight absorbed by every mesh element of the radiation load as NumPy array. */
+        inline boost::python::object absorbed_array(const core::radiationLoad & load) {
+            std::vector<double> values;
+            {
+                allowThreads unlocked;
+                values = load.get_absorbed();
+            }
+            return to_array(values);
+        }
+
+        /*! \brief Get the toroidal window of the sources of the radiation load as tuple (phiMin, phiMax). */
+        inline boost::python::tuple toroidal_window(const core::radiationLoad & load) {
+            std::pair<double, double> window;
+            {
+                allowThreads unlocked;
+                window = load.get_toroidal_window();
+            }
+            return boost::python::make_tuple(window.first, window.second);
+        }
+
+        /*! \brief Create a convergence criterion, the physical groups are given as python sequence of integers. */
+        inline core::radiationLoad::convergence make_convergence(const double target, const double peakFraction,
+            const boost::python::object & physical, const uint32_t maxHits, const uint32_t minBatch) {
+            core::radiationLoad::convergence criterion;
+            criterion.target = target;
+            criterion.peakFraction = peakFraction;
+            for(uint32_t i = 0; i < boost::python::len(physical); ++i) {
+                criterion.physical.push_back(boost::python::extract<int32_t>(physical[i]));
+            }
+            criterion.maxHits = maxHits;
+            criterion.minBatch = minBatch;
+            return criterion;
+        }
+
+        /*! \brief Add samples to the radiation load until the given criterion is met, see make_convergence().
+         *
+         * The global interpreter lock is released meanwhile.
+         */
+        inline bool add_samples_until(core::radiationLoad & load, const double target, const double peakFraction,
+            const boost::python::object & physical, const uint32_t maxHits, const uint32_t minBatch) {
+            core::radiationLoad::convergence criterion = make_convergence(target, peakFraction, physical, maxHits, minBatch);
+            allowThreads unlocked;
+            return load.add_samples_until(criterion);
+        }
+
+        /*! \brief Start adding samples to the radiation load in the background until the given criterion is met.
+         *
+         * The returned job keeps the radiation load alive.
+         */
+        inline core::samplingJob * start_samples_until(core::radiationLoad & load, const double target, const double peakFraction,
+            const boost::python::object & physical, const uint32_t maxHits, const uint32_t minBatch) {
+            return new core::samplingJob(load, make_convergence(target, peakFraction, physical, maxHits, minBatch));
+        }
+
+        /*! \brief Get the largest relative standard error of the elements checked by a convergence criterion. */
+        inline double peak_error(const core::radiationLoad & load, const double peakFraction, const boost::python::object & physical) {
+            core::radiationLoad::convergence criterion = make_convergence(0.0, peakFraction, physical, 0, 0);
+            allowThreads unlocked;
+            return load.get_peak_error(criterion);
+        }
+
+        /*! \brief Calculate the relative standard error of the heat flux density as python list. */
+        inline boost::python::list relative_error_list(const core::radiationLoad & load) {
+            std::vector<double> values;
+            {
+                allowThreads unlocked;
+                values = load.get_relative_error();
+            }
+            return to_list(values);
+        }
+
+        /*! \brief Calculate the relative standard error of the heat flux density as NumPy array.
+         *
+         * The values are taken under the lock of the load, which may change its size, and then copied into the array.
+         */
+        inline boost::python::object relative_error_array(const core::radiationLoad & load) {
+            std::vector<double> values;
+            {
+                allowThreads unlocked;
+                values = load.get_relative_error();
+            }
+            return to_array(values);
+        }
+
+        /*! \brief Get the recorded hits of the radiation load as python list. */
+        inline boost::python::list hits_list(const core::radiationLoad & load) {
+            std::vector<uint32_t> values;
+            {
+                allowThreads unlocked;
+                values = load.get_hits();
+            }
+            return to_list(values);
+        }
+
+        /*! \brief Get the recorded hits of the radiation load as NumPy array of uint32. */
+        inline boost::python::object hits_array(const core::radiationLoad & load) {
+            std::vector<uint32_t> values;
+            {
+                allowThreads unlocked;
+                values = load.get_hits();
+            }
+            uint32_t * data;
+            boost::python::object array = make_array(boost::python::make_tuple(values.size()), "uint32", data);
+            std::copy(values.begin(), values.end(), data);
+            return array;
+        }
+
+        /*! \brief Get random poloidal points as NumPy array of shape (N,3). */
+        inline boost::python::object random_points_array(core::radiationDistribution & distribution, const uint32_t N) {
+            core::vektor * points;
+            boost::python::object array = make_array(boost::python::make_tuple(N, 3), "float64", points);
+            {
+                allowThreads unlocked;
+                distribution.get_random_points(points, N);
+            }
+            return array;
+        }
+
+        /*! \brief Generate the directions of the samples first, ..., first + N - 1 as NumPy array of shape (N,3).
+         *
+         * These are the directions the samples with these indices of a radiation load with the same seed start in.
+         */
+        inline boost::python::object directions_array(const core::directionGenerator & generator, const uint64_t first, const uint64_t N) {
+            core::vektor * directions;
+            boost::python::object array = make_array(boost::python::make_tuple(N, 3), "float64", directions);
+            {
+                allowThreads unlocked;
+                std::vector<double> x(N), y(N), z(N);
+                generator.generate(generator.get_seed(), first, N, x.data(), y.data(), z.data());
+                for(uint64_t i = 0; i < N; ++i) {
+                    directions[i] = core::vektor(x[i], y[i], z[i]);
+                }
+            }
+            return array;
+        }
+
+        /*! \brief Get random points in the torus as NumPy array of shape (N,3). */
+        inline boost::python::object random_toroidal_points_array(core::radiationDistribution & distribution, const uint32_t N) {
+            core::vektor * points;
+            boost::python::object array = make_array(boost::python::make_tuple(N, 3), "float64", points);
+            {
+                allowThreads unlocked;
+                distribution.get_random_toroidal_points(points, N);
+            }
+            return array;
+        }
+
+        /*! \brief Calculate the heat flux density onto the mesh elements as NumPy array.
+         *
+         * The heat flux is calculated under the lock of the load, which may change its size, and then copied into the array.
+         */
+        inline boost::python::object heat_flux_array(const core::radiationLoad & load, const double Ptot) {
+            std::vector<double> values;
+            {
+                allowThreads unlocked;
+                values = load.get_heat_flux(Ptot);
+            }
+            return to_array(values);
+        }
+
+        /*! \brief Calculate the heat flux density and its relative standard error as tuple of NumPy arrays.
+         *
+         * Both arrays are calculated from the same hits, even if samples are added meanwhile.
+         */
+        inline boost::python::tuple heat_flux_error_array(const core::radiationLoad & load, const double Ptot) {
+            std::vector<double> heatFlux;
+            std::vector<double> error;
+            {
+                allowThreads unlocked;
+                load.get_heat_flux(Ptot, heatFlux, error);
+            }
+            return boost::python::make_tuple(to_array(heatFlux), to_array(error));
+        }
+
+        /*! \brief Create a response matrix, the global interpreter lock is released while the mesh and the distribution are copied. */
+        inline core::responseMatrix * make_response_matrix(const core::mesh & grid, const core::radiationDistribution & distribution,
+            const uint32_t Nrho, const double rhoMax) {
+            allowThreads unlocked;
+            return new core::responseMatrix(grid, distribution, Nrho, rhoMax);
+        }
+
+        /*! \brief Get the non-zero entries of the response matrix as tuple of NumPy arrays (element, node, value).
+         *
+         * The arrays can be passed to scipy.sparse.coo_matrix.
+         */
+        inline boost::python::tuple response_matrix_entries(const core::responseMatrix & matrix) {
+            uint64_t N = matrix.get_entries();
+            int32_t * element;
+            int32_t * node;
+            double * value;
+            boost::python::object elementArray = make_array(boost::python::make_tuple(N), "int32", element);
+            boost::python::object nodeArray = make_array(boost::python::make_tuple(N), "int32", node);
+            boost::python::object valueArray = make_array(boost::python::make_tuple(N), "float64", value);
+            {
+                allowThreads unlocked;
+                matrix.get_matrix(element, node, value, N);
+            }
+            return boost::python::make_tuple(elementArray, nodeArray, valueArray);
+        }
+
+        /*! \brief Calculate the heat flux density of the given radiation profile from the response matrix as python list. */
+        inline boost::python::list response_heat_flux_list(const core::responseMatrix & matrix, const core::radiationProfile & profile,
+            const double Ptot) {
+            std::vector<double> values;
+            {
+                allowThreads unlocked;
+                values = matrix.get_heat_flux(profile, Ptot);
+            }
+            return to_list(values);
+        }
+
+        /*! \brief Calculate the heat flux density of the given radiation profile from the response matrix as NumPy array. */
+        inline boost::python::object response_heat_flux_array(const core::responseMatrix & matrix, const core::radiationProfile & profile,
+            const double Ptot) {
+            double * heatFlux;
+            boost::python::object array = make_array(boost::python::make_tuple(matrix.size()), "float64", heatFlux);
+            {
+                allowThreads unlocked;
+                matrix.get_heat_flux(profile, Ptot, heatFlux);
+            }
+            return array;
+        }
+
+        /*! \brief Calculate the heat flux density from the response matrix as NumPy array
+         *
+         * The emission is given as one dimensional array with the power density at every node of the matrix.
+         */
+        inline boost::python::object response_heat_flux_emission_array(const core::responseMatrix & matrix, const boost::python::object & emission,
+            const double Ptot) {
+            buffer emissionBuffer(emission, "emission");
+            if(emissionBuffer.get_dimensions() != 1 || emissionBuffer.get_shape(0) != matrix.get_rho().size()) {
+                throw std::invalid_argument("emission needs one value for every node of the response matrix");
+            }
+            std::vector<double> values(matrix.get_rho().size());
+            for(uint32_t k = 0; k < values.size(); ++k) {
+                values[k] = emissionBuffer(k);
+            }
+            double * heatFlux;
+            boost::python::object array = make_array(boost::python::make_tuple(matrix.size()), "float64", heatFlux);
+            {
+                allowThreads unlocked;
+                matrix.get_heat_flux(values.data(), Ptot, heatFlux);
+            }
+            return array;
+        }
+
+        /*! \brief Create an axisymmetric load, the global interpreter lock is released while the distribution is copied. */
+        inline core::axisymmetricLoad * make_axisymmetric_load(const core::polygon & contour, const core::radiationDistribution & distribution) {
+            allowThreads unlocked;
+            return new core::axisymmetricLoad(contour, distribution);
+        }
+
+        /*! \brief Calculate the closest hit of the ray with the axisymmetric wall as tuple (segment, t)
+         *
+         * The direction is normalized, so t is the distance to the hit. The segment is -1 and t infinite for a miss.
+         */
+        inline boost::python::tuple axisymmetric_closest(const core::axisymmetricLoad & load, const core::vektor & origin,
+            const core::vektor & direction) {
+            double t;
+            int32_t segment = load.evaluate_closest(origin, direction.get_normalized(), t);
+            return boost::python::make_tuple(segment, t);
+        }
+
+        /*! \brief Get the recorded hits of every segment of the axisymmetric load as NumPy array of uint64. */
+        inline boost::python::object axisymmetric_hits_array(const core::axisymmetricLoad & load) {
+            std::vector<uint64_t> values;
+            {
+                allowThreads unlocked;
+                values = load.get_hits();
+            }
+            uint64_t * data;
+            boost::python::object array = make_array(boost::python::make_tuple(values.size()), "uint64", data);
+            std::copy(values.begin(), values.end(), data);
+            return array;
+        }
+
+        /*! \brief Get the areas of the surfaces swept by the segments of the axisymmetric load as NumPy array. */
+        inline boost::python::object axisymmetric_area_array(const core::axisymmetricLoad & load) {
+            return to_array(load.get_area());
+        }
+
+        /*! \brief Calculate the heat flux density onto the segments of the axisymmetric load as NumPy array. */
+        inline boost::python::object axisymmetric_heat_flux_array(const core::axisymmetricLoad & load, const double Ptot) {
+            double * heatFlux;
+            boost::python::object array = make_array(boost::python::make_tuple(load.size()), "float64", heatFlux);
+            {
+                allowThreads unlocked;
+                load.get_heat_flux(Ptot, heatFlux);
+            }
+            return array;
+        }
+
+        /*! \brief Calculate the heat flux density onto the segments of the axisymmetric load and its relative standard error
+         * as tuple of NumPy arrays.
+         */
+        inline boost::python::tuple axisymmetric_heat_flux_error_array(const core::axisymmetricLoad & load, const double Ptot) {
+            double * heatFlux;
+            double * error;
+            boost::python::object heatFluxArray = make_array(boost::python::make_tuple(load.size()), "float64", heatFlux);
+            boost::python::object errorArray = make_array(boost::python::make_tuple(load.size()), "float64", error);
+            {
+                allowThreads unlocked;
+                load.get_heat_flux(Ptot, heatFlux, error);
+            }
+            return boost::python::make_tuple(heatFluxArray, errorArray);
+        }
+
+        /*! \brief Calculate the relative standard error of the heat flux density onto the segments as NumPy array. */
+        inline boost::python::object axisymmetric_relative_error_array(const core::axisymmetricLoad & load) {
+            double * error;
+            boost::python::object array = make_array(boost::python::make_tuple(load.size()), "float64", error);
+            {
+                allowThreads unlocked;
+                load.get_relative_error(error);
+            }
+            return array;
+        }
+
+        /*! \brief Create a view factor load, the global interpreter lock is released while the emission is tabulated. */
+        inline core::viewFactorLoad * make_view_factor_load(const core::mesh & grid, const core::radiationDistribution & distribution) {
+            allowThreads unlocked;
+            return new core::viewFactorLoad(grid, distribution);
+        }
+
+        /*! \brief Get the heat flux density onto the mesh elements of the view factor load as NumPy array. */
+        inline boost::python::object view_factor_heat_flux_array(const core::viewFactorLoad & load, const double Ptot) {
+            double * heatFlux;
+            boost::python::object array = make_array(boost::python::make_tuple(load.size()), "float64", heatFlux);
+            {
+                allowThreads unlocked;
+                load.get_heat_flux(Ptot, heatFlux);
+            }
+            return array;
+        }
+
+        /*! \brief Get the estimated relative error of the view factor load as NumPy array. */
+        inline boost::python::object view_factor_relative_error_array(const core::viewFactorLoad & load) {
+            std::vector<double> values;
+            {
+                allowThreads unlocked;
+                values = load.get_relative_error();
+            }
+            return to_array(values);
+        }
+
+        /*! \brief Get the level of refinement of every mesh element of the view factor load as NumPy array of uint32. */
+        inline boost::python::object view_factor_levels_array(const core::viewFactorLoad & load) {
+            std::vector<uint32_t> values;
+            {
+                allowThreads unlocked;
+                values = load.get_levels();
+            }
+            uint32_t * data;
+            boost::python::object array = make_array(boost::python::make_tuple(values.size()), "uint32", data);
+            std::copy(values.begin(), values.end(), data);
+            return array;
+        }
+
+        /*! \brief Get the \f$R\f$ coordinates of the polygon as NumPy array. */
+        inline boost::python::object polygon_R_array(const core::polygon & contour) {
+            return to_array(contour.get_R());
+        }
+
+        /*! \brief Get the \f$z\f$ coordinates of the polygon as NumPy array. */
+        inline boost::python::object polygon_z_array(const core::polygon & contour) {
+            return to_array(contour.get_z());
+        }
+
+        /*! \brief Get the \f$\rho_{pol}\f$ values of the nodes of the response matrix as NumPy array. */
+        inline boost::python::object response_rho_array(const core::responseMatrix & matrix) {
+            return to_array(matrix.get_rho());
+        }
+
+        /*! \brief Create a polygon from its \f$(R,z)\f$ points
+         *
+         * The coordinates are given as one dimensional NumPy arrays of float64 or any other python sequences.
+         */
+        inline core::polygon * make_polygon(const boost::python::object & R, const boost::python::object & z) {
+            if(!PyObject_CheckBuffer(R.ptr()) || !PyObject_CheckBuffer(z.ptr())) {
+                return new core::polygon(boost::python::list(R), boost::python::list(z));
+            }
+            buffer RBuffer(R, "R");
+            buffer zBuffer(z, "z");
+            if(RBuffer.get_dimensions() != 1 || zBuffer.get_dimensions() != 1 || RBuffer.get_shape(0) != zBuffer.get_shape(0)) {
+                throw std::invalid_argument("R and z need to be one dimensional arrays of the same length");
+            }
+            std::vector<double> RValues(RBuffer.get_shape(0));
+            std::vector<double> zValues(RValues.size());
+            for(uint64_t i = 0; i < RValues.size(); ++i) {
+                RValues[i] = RBuffer(i);
+                zValues[i] = zBuffer(i);
+            }
+            return new core::polygon(RValues, zValues);
+        }
+    }
+}
+
+#endif
@@ -11,7 +11,8 @@ setup(name="wallLoad",
         Extension("wallLoad", ["source/wallLoad.cpp"], 
             include_dirs=['./include'],
             libraries = ["boost_python"],
-            extra_compile_args = ["-std=c++11","-w"]
+            extra_compile_args = ["-std=c++17","-w","-pthread"],
+            extra_link_args = ["-pthread"]
             )
                     ]
     )
@@ -12,7 +12,8 @@ setup(name="wallLoad",
             include_dirs=["%s/local/include" % environ['HOME'], './include'],
             library_dirs= ["%s/local/lib" % environ['HOME']], 
             libraries = ["boost_python"],
-            extra_compile_args = ["-std=c++11","-w"]
+            extra_compile_args = ["-std=c++17","-w","-pthread"],
+            extra_link_args = ["-pthread"]
             )
                     ]
     )
@@ -15,8 +15,8 @@ BOOST_PYTHON_MODULE(wallLoad) {
     class_<wallLoad::core::vektor>("vektor")
         .def(init<double, double, double>())
         .def(init<wallLoad::core::vektor>())
-        .def(init<list>())
-        .def(init<dict>())
+        .def("__init__", make_constructor(&wallLoad::python::make_vektor_from_list))
+        .def("__init__", make_constructor(&wallLoad::python::make_vektor_from_dict))
         .def(init<wallLoad::core::vektor, wallLoad::core::vektor>())
         .add_property("x", &wallLoad::core::vektor::x, &wallLoad::core::vektor::x)
         .add_property("y", &wallLoad::core::vektor::y, &wallLoad::core::vektor::y)
@@ -27,8 +27,8 @@ BOOST_PYTHON_MODULE(wallLoad) {
         .def("dot", &wallLoad::core::vektor::get_dot_product)
         .def("cross", &wallLoad::core::vektor::get_cross_product)
         .def("normalize", &wallLoad::core::vektor::normalize)
-        .def("to_list", &wallLoad::core::vektor::to_list)
-        .def("to_dict", &wallLoad::core::vektor::to_dict)
+        .def("to_list", &wallLoad::python::vektor_to_list)
+        .def("to_dict", &wallLoad::python::vektor_to_dict)
         .def(self_ns::str(self))
         .def(self += self)
         .def(self + self)
@@ -51,9 +51,12 @@ BOOST_PYTHON_MODULE(wallLoad) {
 
     class_<wallLoad::core::polygon>("polygon", init<boost::python::list, boost::python::list>())
         .def(init<wallLoad::core::polygon>())
+        .def("__init__", make_constructor(&wallLoad::python::make_polygon))
         .def("inside", &wallLoad::core::polygon::inside)
         .add_property("R", &wallLoad::core::polygon::get_R_python)
         .add_property("z", &wallLoad::core::polygon::get_z_python)
+        .add_property("RArray", &wallLoad::python::polygon_R_array)
+        .add_property("zArray", &wallLoad::python::polygon_z_array)
         .add_property("size", &wallLoad::core::polygon::size)
         .def("__len__", &wallLoad::core::polygon::size)
         ;
@@ -70,8 +73,8 @@ BOOST_PYTHON_MODULE(wallLoad) {
 
     class_<wallLoad::core::vertex>("vertex", init<wallLoad::core::vektor, wallLoad::core::vektor, wallLoad::core::vektor>())
         .def(init<wallLoad::core::vertex>())
-        .def(init<boost::python::list>())
-        .def(init<boost::python::list, boost::python::list, boost::python::list>())
+        .def("__init__", make_constructor(&wallLoad::python::make_vertex_from_list))
+        .def("__init__", make_constructor(&wallLoad::python::make_vertex_from_lists))
         .add_property("p1", &wallLoad::core::vertex::p1, &wallLoad::core::vertex::p1)
         .add_property("p2", &wallLoad::core::vertex::p2, &wallLoad::core::vertex::p2)
         .add_property("p3", &wallLoad::core::vertex::p3, &wallLoad::core::vertex::p3)
@@ -88,6 +91,7 @@ BOOST_PYTHON_MODULE(wallLoad) {
         .add_property("accumulated", &wallLoad::core::probabilityDistribution::get_accumulated_python)
         .add_property("max", &wallLoad::core::probabilityDistribution::get_max)
         .def("random", &wallLoad::core::probabilityDistribution::get_random_number)
+        .add_property("seed", &wallLoad::core::probabilityDistribution::get_seed, &wallLoad::core::probabilityDistribution::set_seed)
         .def("__call__", &wallLoad::core::probabilityDistribution::get_value)
         ;
 
@@ -102,6 +106,11 @@ BOOST_PYTHON_MODULE(wallLoad) {
         .def(init<wallLoad::core::equilibrium>())
         .def("psi", &wallLoad::core::equilibrium::get_psi)
         .def("rho", &wallLoad::core::equilibrium::get_rho)
+        .def("psi", &wallLoad::core::equilibrium::get_psi_python)
+        .def("rho", &wallLoad::core::equilibrium::get_rho_python)
+        .def("psiGradient", &wallLoad::core::equilibrium::get_psi_gradient_python)
+        .def("psiGradient", &wallLoad::core::equilibrium::get_psi_gradient_list_python)
+        .add_property("spline", &wallLoad::core::equilibrium::get_spline, &wallLoad::core::equilibrium::set_spline)
         .add_property("R", &wallLoad::core::equilibrium::get_R_python)
         .add_property("z", &wallLoad::core::equilibrium::get_z_python)
         .add_property("R0", &wallLoad::core::equilibrium::get_R0)
@@ -114,6 +123,16 @@ BOOST_PYTHON_MODULE(wallLoad) {
         .add_property("Rmax", &wallLoad::core::equilibrium::get_Rmax)
         .add_property("zmin", &wallLoad::core::equilibrium::get_zmin)
         .add_property("zmax", &wallLoad::core::equilibrium::get_zmax)
+        .add_property("comment", &wallLoad::core::equilibrium::get_comment)
+        .add_property("fpol", &wallLoad::core::equilibrium::get_fpol_python)
+        .add_property("pres", &wallLoad::core::equilibrium::get_pres_python)
+        .add_property("ffprim", &wallLoad::core::equilibrium::get_ffprim_python)
+        .add_property("pprime", &wallLoad::core::equilibrium::get_pprime_python)
+        .add_property("q", &wallLoad::core::equilibrium::get_q_python)
+        .add_property("boundaryR", &wallLoad::core::equilibrium::get_boundaryR_python)
+        .add_property("boundaryz", &wallLoad::core::equilibrium::get_boundaryz_python)
+        .add_property("limiterR", &wallLoad::core::equilibrium::get_limiterR_python)
+        .add_property("limiterz", &wallLoad::core::equilibrium::get_limiterz_python)
         ;
 
     class_<wallLoad::core::radiationDistribution>("radiationDistribution", init<wallLoad::core::equilibrium, wallLoad::core::radiationProfile>())
@@ -122,36 +141,179 @@ BOOST_PYTHON_MODULE(wallLoad) {
         .add_property("Rmax", &wallLoad::core::radiationDistribution::get_Rmax, &wallLoad::core::radiationDistribution::set_Rmax)
         .add_property("zmin", &wallLoad::core::radiationDistribution::get_zmin, &wallLoad::core::radiationDistribution::set_zmin)
         .add_property("zmax", &wallLoad::core::radiationDistribution::get_zmax, &wallLoad::core::radiationDistribution::set_zmax)
-        .def("random", &wallLoad::core::radiationDistribution::get_random_points_python)
-        .def("randomToroidal", &wallLoad::core::radiationDistribution::get_random_toroidal_points_python)
+        .def("random", &wallLoad::python::random_points_list)
+        .add_property("seed", &wallLoad::core::radiationDistribution::get_seed, &wallLoad::core::radiationDistribution::set_seed)
+        .def("randomToroidal", &wallLoad::python::random_toroidal_points_list)
+        .def("randomArray", &wallLoad::python::random_points_array)
+        .def("randomToroidalArray", &wallLoad::python::random_toroidal_points_array)
+        .def("setGrid", &wallLoad::core::radiationDistribution::set_grid)
+        .def("clearGrid", &wallLoad::core::radiationDistribution::clear_grid)
+        .add_property("hasGrid", &wallLoad::core::radiationDistribution::has_grid)
+        .add_property("gridNR", &wallLoad::core::radiationDistribution::get_grid_NR)
+        .add_property("gridNz", &wallLoad::core::radiationDistribution::get_grid_Nz)
         ;
 
     class_<wallLoad::core::mesh>("mesh", init<boost::python::list>())
         .def(init<wallLoad::core::mesh>())
         .def(init<std::string>())
+        .def(init<std::string, uint32_t>())
+        .def(init<std::string, std::string>())
+        .def(init<std::string, std::string, uint32_t>())
+        .def("save", &wallLoad::python::withoutGil<&wallLoad::core::mesh::save>::call)
+        .add_property("fromCache", &wallLoad::core::mesh::get_from_cache)
         .def("append", &wallLoad::core::mesh::append)
+        .add_property("seed", &wallLoad::core::mesh::get_seed, &wallLoad::core::mesh::set_seed)
+        .def("buildHierarchy", &wallLoad::core::mesh::build_hierarchy)
+        .add_property("hasHierarchy", &wallLoad::core::mesh::has_hierarchy)
+        .add_property("instructionSet", &wallLoad::core::mesh::get_instruction_set)
         .def("evaluateHit", &wallLoad::core::mesh::evaluateHit)
-        .def("evaluateHits", &wallLoad::core::mesh::evaluateHits_python)
+        .def("evaluateHits", &wallLoad::python::evaluate_hits_list)
+        .def("evaluateHitsArray", &wallLoad::python::evaluate_hits_array)
+        .add_property("physical", &wallLoad::core::mesh::get_physical_python)
+        .add_property("emissivity", &wallLoad::python::emissivity_array, &wallLoad::python::set_emissivity)
+        .def("setEmissivity", &wallLoad::python::set_emissivity)
+        .def("setEmissivity", &wallLoad::python::set_group_emissivity)
+        .add_property("physicalNames", &wallLoad::core::mesh::get_physical_names_python)
+        .def("setInstances", &wallLoad::python::set_instances)
+        .def("setToroidalInstances", &wallLoad::core::mesh::set_toroidal_instances)
+        .add_property("instances", &wallLoad::python::instances_array)
+        .add_property("instanceCount", &wallLoad::core::mesh::get_instance_count)
         .def("__len__", &wallLoad::core::mesh::size)
-        .def("__getitem__", &wallLoad::core::mesh::operator[],
-            boost::python::return_internal_reference<>())
+        .def("__getitem__", &wallLoad::core::mesh::operator[])
         ;
 
-    class_<wallLoad::core::radiationLoad>("radiationLoad", init<wallLoad::core::mesh, wallLoad::core::radiationDistribution>())
-        .def(init<wallLoad::core::radiationLoad>())
-        .def("clear", &wallLoad::core::radiationLoad::clear)
-        .def("addSamples", &wallLoad::core::radiationLoad::add_samples)
-        .def("__getitem__", &wallLoad::core::radiationLoad::operator[])
+    class_<wallLoad::core::radiationLoad>("radiationLoad", no_init)
+        .def("__init__", make_constructor(&wallLoad::python::make_radiation_load))
+        .def("__init__", make_constructor(&wallLoad::python::copy_radiation_load))
+        .def("clear", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::clear>::call)
+        .def("addSamples", &wallLoad::python::add_samples)
+        .def("startSamples", &wallLoad::python::start_samples,
+            return_value_policy<manage_new_object, with_custodian_and_ward_postcall<0, 1> >())
+        .add_property("threads", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_threads>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_threads>::call)
+        .add_property("seed", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_seed>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_seed>::call)
+        .add_property("samples", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_samples>::call)
+        .def("__getitem__", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::operator[]>::call)
         .def("__len__", &wallLoad::core::radiationLoad::size)
         .add_property("size", &wallLoad::core::radiationLoad::size)
-        .def("clear", &wallLoad::core::radiationLoad::clear)
-        .add_property("totalHits", &wallLoad::core::radiationLoad::get_total_hits)
-        .def("getHeatFlux", &wallLoad::core::radiationLoad::get_heat_flux_python)
-        .add_property("mesh", &wallLoad::core::radiationLoad::get_mesh)
+        .add_property("totalHits", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_total_hits>::call)
+        .def("addSamplesUntil", &wallLoad::python::add_samples_until,
+            (arg("target"), arg("peakFraction") = 0.5, arg("physical") = list(), arg("maxHits") = 0xffffffffu, arg("minBatch") = 10000u))
+        .def("startSamplesUntil", &wallLoad::python::start_samples_until,
+            (arg("target"), arg("peakFraction") = 0.5, arg("physical") = list(), arg("maxHits") = 0xffffffffu, arg("minBatch") = 10000u),
+            return_value_policy<manage_new_object, with_custodian_and_ward_postcall<0, 1> >())
+        .def("getPeakError", &wallLoad::python::peak_error, (arg("peakFraction") = 0.5, arg("physical") = list()))
+        .add_property("specular", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_specular>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_specular>::call)
+        .add_property("quasiRandom", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::is_quasi_random>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_quasi_random>::call)
+        .add_property("replicas", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_replicas>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_replicas>::call)
+        .def("setToroidalWindow", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_toroidal_window>::call)
+        .def("setAutomaticToroidalWindow", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_automatic_toroidal_window>::call)
+        .def("clearToroidalWindow", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::clear_toroidal_window>::call)
+        .add_property("toroidalWindow", &wallLoad::python::toroidal_window)
+        .add_property("emittedSamples", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_emitted_samples>::call)
+        .add_property("absorbedFraction", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_absorbed_fraction>::call)
+        .add_property("perInstance", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::is_per_instance>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::set_per_instance>::call)
+        .def("getHits", &wallLoad::python::hits_list)
+        .def("getAbsorbedArray", &wallLoad::python::absorbed_array)
+        .def("getHitsArray", &wallLoad::python::hits_array)
+        .def("getHeatFlux", &wallLoad::python::heat_flux_list)
+        .def("getHeatFluxArray", &wallLoad::python::heat_flux_array)
+        .def("getHeatFluxErrorArray", &wallLoad::python::heat_flux_error_array)
+        .def("getRelativeError", &wallLoad::python::relative_error_list)
+        .def("getRelativeErrorArray", &wallLoad::python::relative_error_array)
+        .add_property("mesh", &wallLoad::python::withoutGil<&wallLoad::core::radiationLoad::get_mesh>::call)
+        ;
+
+    class_<wallLoad::core::samplingJob, boost::noncopyable>("samplingJob", no_init)
+        .def("cancel", &wallLoad::core::samplingJob::cancel)
+        .def("wait", &wallLoad::python::withoutGil<&wallLoad::core::samplingJob::wait>::call, (arg("timeout") = -1.0))
+        .add_property("running", &wallLoad::core::samplingJob::is_running)
+        .add_property("complete", &wallLoad::core::samplingJob::is_complete)
+        .add_property("cancelled", &wallLoad::core::samplingJob::is_cancelled)
+        .add_property("requested", &wallLoad::core::samplingJob::get_requested)
+        .add_property("hits", &wallLoad::core::samplingJob::get_hits)
+        .add_property("samples", &wallLoad::core::samplingJob::get_samples)
+        .add_property("elapsed", &wallLoad::core::samplingJob::get_elapsed)
+        .add_property("rate", &wallLoad::core::samplingJob::get_rate)
+        .add_property("sampleRate", &wallLoad::core::samplingJob::get_sample_rate)
+        .add_property("load", make_function(&wallLoad::core::samplingJob::get_load, return_internal_reference<>()))
+        ;
+
+    class_<wallLoad::core::responseMatrix>("responseMatrix", no_init)
+        .def("__init__", make_constructor(&wallLoad::python::make_response_matrix))
+        .def("clear", &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::clear>::call)
+        .def("addSamples", &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::add_samples>::call)
+        .add_property("threads", &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::get_threads>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::set_threads>::call)
+        .add_property("seed", &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::get_seed>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::set_seed>::call)
+        .add_property("samples", &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::get_samples>::call)
+        .add_property("specular", &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::get_specular>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::set_specular>::call)
+        .add_property("entries", &wallLoad::python::withoutGil<&wallLoad::core::responseMatrix::get_entries>::call)
+        .def("__len__", &wallLoad::core::responseMatrix::size)
+        .add_property("size", &wallLoad::core::responseMatrix::size)
+        .add_property("rho", &wallLoad::python::response_rho_array)
+        .def("getMatrix", &wallLoad::python::response_matrix_entries)
+        .def("getHeatFlux", &wallLoad::python::response_heat_flux_list)
+        .def("getHeatFluxArray", &wallLoad::python::response_heat_flux_emission_array)
+        .def("getHeatFluxArray", &wallLoad::python::response_heat_flux_array)
+        ;
+
+    class_<wallLoad::core::axisymmetricLoad>("axisymmetricLoad", no_init)
+        .def("__init__", make_constructor(&wallLoad::python::make_axisymmetric_load))
+        .def("clear", &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::clear>::call)
+        .def("addSamples", &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::add_samples>::call)
+        .add_property("threads", &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::get_threads>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::set_threads>::call)
+        .add_property("seed", &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::get_seed>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::set_seed>::call)
+        .add_property("samples", &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::get_samples>::call)
+        .add_property("totalHits", &wallLoad::python::withoutGil<&wallLoad::core::axisymmetricLoad::get_total_hits>::call)
+        .def("__len__", &wallLoad::core::axisymmetricLoad::size)
+        .add_property("size", &wallLoad::core::axisymmetricLoad::size)
+        .add_property("area", &wallLoad::python::axisymmetric_area_array)
+        .def("evaluateClosest", &wallLoad::python::axisymmetric_closest)
+        .def("getHitsArray", &wallLoad::python::axisymmetric_hits_array)
+        .def("getHeatFluxArray", &wallLoad::python::axisymmetric_heat_flux_array)
+        .def("getHeatFluxErrorArray", &wallLoad::python::axisymmetric_heat_flux_error_array)
+        .def("getRelativeErrorArray", &wallLoad::python::axisymmetric_relative_error_array)
+        ;
+
+    class_<wallLoad::core::viewFactorLoad>("viewFactorLoad", no_init)
+        .def("__init__", make_constructor(&wallLoad::python::make_view_factor_load))
+        .def("calculate", &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::calculate>::call)
+        .add_property("calculated", &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::is_calculated>::call)
+        .add_property("tolerance", &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::get_tolerance>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::set_tolerance>::call)
+        .add_property("maxLevel", &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::get_max_level>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::set_max_level>::call)
+        .add_property("threads", &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::get_threads>::call,
+            &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::set_threads>::call)
+        .def("__len__", &wallLoad::core::viewFactorLoad::size)
+        .add_property("size", &wallLoad::core::viewFactorLoad::size)
+        .add_property("absorbedFraction", &wallLoad::python::withoutGil<&wallLoad::core::viewFactorLoad::get_absorbed_fraction>::call)
+        .def("getEmission", &wallLoad::core::viewFactorLoad::get_emission)
+        .def("getHeatFluxArray", &wallLoad::python::view_factor_heat_flux_array)
+        .def("getRelativeErrorArray", &wallLoad::python::view_factor_relative_error_array)
+        .def("getLevelsArray", &wallLoad::python::view_factor_levels_array)
+        ;
+
+    class_<wallLoad::core::directionGenerator>("directionGenerator")
+        .def("generate", &wallLoad::core::directionGenerator::generate_python)
+        .def("generateArray", &wallLoad::python::directions_array)
+        .add_property("seed", &wallLoad::core::directionGenerator::get_seed, &wallLoad::core::directionGenerator::set_seed)
+        .add_property("instructionSet", &wallLoad::core::directionGenerator::get_instruction_set)
         ;
 
     class_<wallLoad::core::diffuseScatter>("diffuseScatter")
-        .def("getDirection", &wallLoad::core::diffuseScatter::get_direction)
+        .def("getDirection", static_cast<wallLoad::core::vektor (wallLoad::core::diffuseScatter::*)(const wallLoad::core::vektor &)>(&wallLoad::core::diffuseScatter::get_direction))
+        .add_property("seed", &wallLoad::core::diffuseScatter::get_seed, &wallLoad::core::diffuseScatter::set_seed)
         ;
 
 